@@ -0,0 +1,143 @@
+/*
+ * File:   FORMAT.c
+ * Comments: Divide-free number formatting, see FORMAT.h. Included by main.c
+ *           ahead of the modules that use it; compiles on its own too.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "FORMAT.h"
+
+/* q = v * 0.8 by shifts and adds (0.11001100... binary), then / 8; the estimate
+   is at most one low, fixed from the remainder. Exact for every 32-bit v. */
+uint32_t FMT_Div10(uint32_t v, uint32_t* rem)
+{
+    uint32_t    q, r;
+
+    q = (v >> 1) + (v >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+    r = v - ((q << 3) + (q << 1));
+    if (r > 9U) {
+        q++;
+        r -= 10U;
+    }
+    *rem = r;
+    return q;
+}
+
+/* Digits of v, least significant first; returns the count */
+static size_t FMT_Digits(char* tmp, uint32_t v)
+{
+    size_t      n = 0;
+    uint32_t    r;
+
+    do {
+        v = FMT_Div10(v, &r);
+        tmp[n++] = (char)('0' + r);
+    } while (v != 0U);
+    return n;
+}
+
+/* sign, zeros to make up digits, then the digits in tmp reversed */
+static size_t FMT_Emit(char* buf, bool neg, const char* tmp, size_t n, size_t digits)
+{
+    size_t  len = 0;
+
+    if (neg)
+        buf[len++] = '-';
+    while (digits-- > n)
+        buf[len++] = '0';
+    while (n > 0U)
+        buf[len++] = tmp[--n];
+    buf[len] = '\0';
+    return len;
+}
+
+static uint32_t FMT_Abs(int32_t v)
+{
+    return (v < 0) ? (uint32_t)0 - (uint32_t)v : (uint32_t)v;
+}
+
+size_t FMT_UInt(char* buf, uint32_t v)
+{
+    char    tmp[10];
+
+    return FMT_Emit(buf, false, tmp, FMT_Digits(tmp, v), 0);
+}
+
+size_t FMT_Int(char* buf, int32_t v)
+{
+    char    tmp[10];
+
+    return FMT_Emit(buf, v < 0, tmp, FMT_Digits(tmp, FMT_Abs(v)), 0);
+}
+
+size_t FMT_IntW(char* buf, int32_t v, uint8_t width)
+{
+    char    tmp[10];
+    size_t  n = FMT_Digits(tmp, FMT_Abs(v));
+    size_t  len = n + ((v < 0) ? 1U : 0U), pad = 0;
+
+    if (width > (FMT_BUFFER_SIZE - 1U))
+        width = FMT_BUFFER_SIZE - 1U;
+    while ((len + pad) < width)
+        buf[pad++] = ' ';
+    return pad + FMT_Emit(&buf[pad], v < 0, tmp, n, 0);
+}
+
+size_t FMT_UIntZ(char* buf, uint32_t v, uint8_t digits)
+{
+    char    tmp[10];
+
+    if (digits > (FMT_BUFFER_SIZE - 1U))
+        digits = FMT_BUFFER_SIZE - 1U;
+    return FMT_Emit(buf, false, tmp, FMT_Digits(tmp, v), digits);
+}
+
+size_t FMT_Fixed(char* buf, int32_t v, uint8_t decimals)
+{
+    char    tmp[10];
+    size_t  n, len, i;
+
+    if (decimals > 9U)
+        decimals = 9U;
+    n = FMT_Digits(tmp, FMT_Abs(v));
+    /* At least one digit before the point: pad the integer part with zeros */
+    len = FMT_Emit(buf, v < 0, tmp, n, (size_t)decimals + 1U);
+    if (decimals == 0U)
+        return len;
+    for (i = len; i > (len - decimals); i--)
+        buf[i] = buf[i - 1U];
+    buf[len - decimals] = '.';
+    buf[len + 1U] = '\0';
+    return len + 1U;
+}
+
+size_t FMT_Hex(char* buf, uint32_t v, uint8_t digits)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    size_t  i;
+
+    if (digits > 8U)
+        digits = 8U;
+    for (i = 0; i < digits; i++)
+        buf[i] = hex[(v >> ((digits - 1U - i) * 4U)) & 0xFU];
+    buf[digits] = '\0';
+    return digits;
+}
+
+size_t FMT_Str(char* buf, const char* s)
+{
+    size_t  len = 0;
+
+    while (s[len] != '\0') {
+        buf[len] = s[len];
+        len++;
+    }
+    buf[len] = '\0';
+    return len;
+}
@@ -0,0 +1,311 @@
+/*
+ * File:   I2C_DEVICE.c
+ * Comments: Register access layer for SERCOM2 I2C slaves, see I2C_DEVICE.h.
+ *           Included by main.c like the OLED driver; compiles on its own too.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "I2C_DEVICE.h"
+
+/* Longest wait for a queue slot, and for the transfer once queued: it may sit behind
+   a few OLED page writes of about 12 ms each at 100 kHz */
+#define I2C_DEV_SUBMIT_TIMEOUT_US   50000U
+#define I2C_DEV_XFER_TIMEOUT_US     100000U
+
+/* Completion of the one transfer in flight: the calls below block, so they never
+   overlap. The register address and the segment list live here rather than on the
+   caller's stack, the queue uses them until the callback. */
+static volatile bool                I2C_DevDone;
+static volatile SERCOM_I2C_ERROR    I2C_DevError;
+static uint8_t                      I2C_DevRegBuf[2];
+static SERCOM_I2C_SEGMENT           I2C_DevSegs[2];
+
+/* Bus scan: presence bitmap of all 128 addresses, one probe on the bus at a time */
+static volatile uint32_t            I2C_Present[4];
+static I2C_PRESENCE_CALLBACK        I2C_ScanCallback;
+static volatile bool                I2C_ScanOn;
+static volatile bool                I2C_ScanBusy;
+static volatile uint8_t             I2C_ScanBudget;
+static uint8_t                      I2C_ScanAddr = I2C_SCAN_FIRST;
+static volatile uint32_t            I2C_ScanSweepCount;
+
+/* Record a probe result; true if the presence of the address changed */
+static bool I2C_PresenceSet(uint8_t address, bool present)
+{
+    uint32_t    bit = 1UL << (address & 31U);
+    bool        was = (I2C_Present[address >> 5] & bit) != 0U;
+
+    if (present)
+        I2C_Present[address >> 5] |= bit;
+    else
+        I2C_Present[address >> 5] &= ~bit;
+    return was != present;
+}
+
+static void I2C_DevEventHandler(uintptr_t context)
+{
+    I2C_DevError = SERCOM2_I2C_ErrorGet();
+    I2C_DevDone = true;
+}
+
+/* Queue one transaction (register address, optional write payload, optional read)
+   and wait for its callback. Polling SERCOM2_I2C_Tasks() starts a transfer parked
+   behind a busy bus and lets the plib's watchdog end a hung one. The caller's
+   buffers are on the queue until then, so this never returns while it is queued. */
+static bool I2C_DevTransfer(I2C_DEVICE* dev, uint16_t reg, const uint8_t wr[], uint16_t wrCount,
+                            uint8_t rd[], uint16_t rdCount, bool sendReg)
+{
+    SERCOM_I2C_TRANSACTION  xfer;
+    SERCOM_I2C_SEGMENT*     segs = I2C_DevSegs;
+    SERCOM2_I2C_DEADLINE    deadline;
+    uint8_t                 n = 0;
+
+    if (sendReg)
+    {
+        if (dev->regWidth == I2C_DEV_REG16)
+            I2C_DevRegBuf[n++] = (uint8_t)(reg >> 8);
+        I2C_DevRegBuf[n++] = (uint8_t)reg;
+        segs[0].data = I2C_DevRegBuf;
+        segs[0].size = n;
+        n = 1;
+    }
+    if (wrCount != 0U)
+    {
+        segs[n].data = (uint8_t*)wr;
+        segs[n].size = wrCount;
+        n++;
+    }
+
+    xfer.address = dev->address;
+    xfer.writeBuffer = NULL;
+    xfer.writeSize = 0;
+    xfer.writeSegments = (n != 0U) ? segs : NULL;
+    xfer.writeSegmentCount = n;
+    xfer.readBuffer = rd;
+    xfer.readSize = rdCount;
+    xfer.callback = I2C_DevEventHandler;
+    xfer.context = 0;
+
+    dev->transfers++;
+    I2C_DevDone = false;
+    SERCOM2_I2C_DeadlineStart(&deadline, I2C_DEV_SUBMIT_TIMEOUT_US);
+    while (!SERCOM2_I2C_TransferSubmit(&xfer))
+    {
+        if (SERCOM2_I2C_DeadlineReached(&deadline)) // queue stayed full, nothing queued
+        {
+            dev->errors++;
+            return false;
+        }
+        SERCOM2_I2C_Tasks();
+    }
+    SERCOM2_I2C_DeadlineStart(&deadline, I2C_DEV_XFER_TIMEOUT_US);
+    while (!I2C_DevDone)
+    {
+        if (SERCOM2_I2C_DeadlineReached(&deadline))
+        {
+            /* The watchdog should have ended it long ago: take only this transfer off
+               the queue, its callback reports a bus error and the others stay queued */
+            (void)SERCOM2_I2C_TransferCancel(I2C_DevEventHandler, 0);
+            break;
+        }
+        SERCOM2_I2C_Tasks();
+    }
+    if (!I2C_DevDone || (I2C_DevError != SERCOM_I2C_ERROR_NONE))
+    {
+        dev->errors++;
+        return false;
+    }
+    return true;
+}
+
+/* Shadow slot of a register, -1 if it is not cached */
+static int16_t I2C_DevSlot(const I2C_DEVICE* dev, uint16_t reg)
+{
+    if ((reg < dev->cacheFirst) || (reg - dev->cacheFirst >= dev->cacheCount) ||
+        (reg - dev->cacheFirst >= I2C_DEV_CACHE_MAX))
+        return -1;
+    return (int16_t)(reg - dev->cacheFirst);
+}
+
+/* Copy what a burst transferred into the shadow registers it covers */
+static void I2C_DevCacheFill(I2C_DEVICE* dev, uint16_t reg, const uint8_t data[], uint16_t count)
+{
+    int16_t     slot;
+    uint16_t    i;
+
+    for (i = 0; i < count; i++)
+    {
+        slot = I2C_DevSlot(dev, (uint16_t)(reg + i));
+        if (slot >= 0)
+        {
+            dev->cache[slot] = data[i];
+            dev->cacheValid |= (1UL << slot);
+        }
+    }
+}
+
+bool I2C_DevReadReg(I2C_DEVICE* dev, uint16_t reg, uint8_t* value)
+{
+    int16_t slot = I2C_DevSlot(dev, reg);
+
+    if ((slot >= 0) && (dev->cacheValid & (1UL << slot)))
+    {
+        dev->cacheHits++;
+        *value = dev->cache[slot];
+        return true;
+    }
+    return I2C_DevReadBurst(dev, reg, value, 1);
+}
+
+bool I2C_DevWriteReg(I2C_DEVICE* dev, uint16_t reg, uint8_t value)
+{
+    int16_t slot = I2C_DevSlot(dev, reg);
+
+    if ((slot >= 0) && (dev->cacheValid & (1UL << slot)) && (dev->cache[slot] == value))
+    {
+        dev->cacheHits++;                           // device already holds it
+        return true;
+    }
+    return I2C_DevWriteBurst(dev, reg, &value, 1);
+}
+
+bool I2C_DevUpdateReg(I2C_DEVICE* dev, uint16_t reg, uint8_t mask, uint8_t value)
+{
+    uint8_t old;
+
+    if (!I2C_DevReadReg(dev, reg, &old))
+        return false;
+    return I2C_DevWriteReg(dev, reg, (uint8_t)((old & ~mask) | (value & mask)));
+}
+
+bool I2C_DevReadBurst(I2C_DEVICE* dev, uint16_t reg, uint8_t data[], uint16_t count)
+{
+    if (count == 0U)
+        return true;
+    if (!I2C_DevTransfer(dev, reg, NULL, 0, data, count, true))
+        return false;
+    I2C_DevCacheFill(dev, reg, data, count);
+    return true;
+}
+
+bool I2C_DevWriteBurst(I2C_DEVICE* dev, uint16_t reg, const uint8_t data[], uint16_t count)
+{
+    int16_t     slot;
+    uint16_t    i;
+
+    if (count == 0U)
+        return true;
+    if (!I2C_DevTransfer(dev, reg, data, count, NULL, 0, true))
+    {
+        /* Unknown how far the write got: the covered shadow registers are stale */
+        for (i = 0; i < count; i++)
+        {
+            slot = I2C_DevSlot(dev, (uint16_t)(reg + i));
+            if (slot >= 0)
+                dev->cacheValid &= ~(1UL << slot);
+        }
+        return false;
+    }
+    I2C_DevCacheFill(dev, reg, data, count);
+    return true;
+}
+
+void I2C_DevInvalidate(I2C_DEVICE* dev)
+{
+    dev->cacheValid = 0;
+}
+
+bool I2C_DevProbe(I2C_DEVICE* dev)
+{
+    bool    ok;
+
+    /* Zero-length write: no byte is read from or written to the device */
+    ok = I2C_DevTransfer(dev, 0, NULL, 0, NULL, 0, false);
+    if (ok || (I2C_DevDone && (I2C_DevError == SERCOM_I2C_ERROR_NAK)))
+        (void)I2C_PresenceSet(dev->address, ok);
+    return ok;
+}
+
+static void I2C_ScanEventHandler(uintptr_t context);
+
+/* Queue the probe of I2C_ScanAddr. Thread context with no probe in flight, or the
+   SERCOM2 interrupt from the completion of the previous probe. */
+static void I2C_ScanSubmit(void)
+{
+    SERCOM_I2C_TRANSACTION  xfer;
+
+    xfer.address = I2C_ScanAddr;
+    xfer.writeBuffer = NULL;
+    xfer.writeSize = 0;
+    xfer.writeSegments = NULL;
+    xfer.writeSegmentCount = 0;
+    xfer.readBuffer = NULL;
+    xfer.readSize = 0;
+    xfer.callback = I2C_ScanEventHandler;
+    xfer.context = 0;
+    if (!SERCOM2_I2C_TransferSubmit(&xfer))
+        I2C_ScanBusy = false;                       // queue full: next tick
+}
+
+static void I2C_ScanEventHandler(uintptr_t context)
+{
+    SERCOM_I2C_ERROR    error = SERCOM2_I2C_ErrorGet();
+    uint8_t             address = I2C_ScanAddr;
+
+    if ((error != SERCOM_I2C_ERROR_BUS) && I2C_PresenceSet(address, error == SERCOM_I2C_ERROR_NONE) &&
+        (I2C_ScanCallback != NULL))
+    {
+        I2C_ScanCallback(address, error == SERCOM_I2C_ERROR_NONE);
+    }
+
+    if (++I2C_ScanAddr > I2C_SCAN_LAST)
+    {
+        I2C_ScanAddr = I2C_SCAN_FIRST;
+        I2C_ScanSweepCount++;
+    }
+    if (I2C_ScanOn && (I2C_ScanBudget != 0U))
+    {
+        I2C_ScanBudget--;
+        I2C_ScanSubmit();
+    }
+    else
+    {
+        I2C_ScanBusy = false;
+    }
+}
+
+void I2C_ScanStart(I2C_PRESENCE_CALLBACK callback)
+{
+    I2C_ScanCallback = callback;
+    I2C_ScanSweepCount = 0;
+    I2C_ScanOn = true;
+}
+
+void I2C_ScanStop(void)
+{
+    I2C_ScanOn = false;                             // a probe in flight still completes
+}
+
+void I2C_ScanTask(void)
+{
+    if (!I2C_ScanOn)
+        return;
+    I2C_ScanBudget = I2C_SCAN_PROBES_PER_TICK - 1U;
+    if (!I2C_ScanBusy)
+    {
+        I2C_ScanBusy = true;
+        I2C_ScanSubmit();
+    }
+}
+
+bool I2C_IsPresent(uint8_t address)
+{
+    return (I2C_Present[(address >> 5) & 3U] & (1UL << (address & 31U))) != 0U;
+}
+
+uint32_t I2C_ScanSweeps(void)
+{
+    return I2C_ScanSweepCount;
+}
@@ -0,0 +1,77 @@
+/*
+ * File:   I2C_DEVICE.h
+ * Comments: Register access for I2C slaves on SERCOM2 (sensors, IO expanders,
+ *           EEPROMs). Transfers go through the SERCOM2 transaction queue, so they
+ *           wait behind the OLED background refresh instead of failing, and each
+ *           call blocks until its own transfer has completed (or, should it never
+ *           complete, until SERCOM2_I2C_TransferCancel() has taken just that transfer
+ *           off the queue; the OLED refresh and a running scan keep theirs).
+ *
+ *           Every device can keep a shadow of a range of its registers (up to 32,
+ *           in a buffer the caller provides). Cached registers are read from the
+ *           bus once; later reads and read-modify-writes are served from the
+ *           shadow, and writes that would not change a cached value are skipped.
+ *           Only cache configuration registers: status and data registers that
+ *           the device changes by itself must stay outside the cached range.
+ */
+
+#ifndef I2C_DEVICE_H
+#define I2C_DEVICE_H
+
+#include "definitions.h"
+
+// Register address width on the bus
+#define I2C_DEV_REG8              1     // sensors, IO expanders
+#define I2C_DEV_REG16             2     // EEPROMs above 2 kbit: high byte first
+
+#define I2C_DEV_CACHE_MAX         32    // registers per shadow, one valid bit each
+
+typedef struct
+{
+    uint8_t     address;        // 7-bit slave address
+    uint8_t     regWidth;       // I2C_DEV_REG8 or I2C_DEV_REG16
+    uint16_t    cacheFirst;     // first shadowed register
+    uint8_t     cacheCount;     // shadowed registers, 0 = no cache
+    uint8_t*    cache;          // cacheCount bytes
+    uint32_t    cacheValid;     // bit n: cache[n] holds the device's value
+    uint32_t    transfers;      // bus transactions for this device
+    uint32_t    cacheHits;      // reads and writes the shadow saved
+    uint32_t    errors;         // transfers ended by NAK, bus error or timeout
+} I2C_DEVICE;
+
+// Static initializer: I2C_DEVICE exp = I2C_DEVICE_INIT(0x20, I2C_DEV_REG8, 0x00, expRegs);
+#define I2C_DEVICE_INIT(addr, width, first, shadow) \
+    { (addr), (width), (first), (uint8_t)sizeof(shadow), (shadow), 0, 0, 0, 0 }
+#define I2C_DEVICE_INIT_NOCACHE(addr, width) \
+    { (addr), (width), 0, 0, NULL, 0, 0, 0, 0 }
+
+// All calls return false if the device did not answer or the bus timed out
+bool I2C_DevReadReg(I2C_DEVICE* dev, uint16_t reg, uint8_t* value);
+bool I2C_DevWriteReg(I2C_DEVICE* dev, uint16_t reg, uint8_t value);
+bool I2C_DevUpdateReg(I2C_DEVICE* dev, uint16_t reg, uint8_t mask, uint8_t value);
+bool I2C_DevReadBurst(I2C_DEVICE* dev, uint16_t reg, uint8_t data[], uint16_t count);
+bool I2C_DevWriteBurst(I2C_DEVICE* dev, uint16_t reg, const uint8_t data[], uint16_t count);
+
+// Forget the shadow, e.g. after the device was reset or re-plugged
+void I2C_DevInvalidate(I2C_DEVICE* dev);
+// Address acknowledged: address-only write, no register touched. Also updates the
+// presence bitmap of the bus scan below, without a presence callback.
+bool I2C_DevProbe(I2C_DEVICE* dev);
+
+// Background bus scan: I2C_ScanTask() from the main loop probes the next few
+// addresses of 0x08~0x77 through the transaction queue (zero-length writes, so empty
+// addresses show up as NAKs in the SERCOM2 statistics) and never blocks. Whenever
+// a device answers where none did or stops answering, the callback runs from the
+// SERCOM2 interrupt: keep it short. Bus errors leave the presence unchanged.
+#define I2C_SCAN_FIRST            0x08
+#define I2C_SCAN_LAST             0x77
+#define I2C_SCAN_PROBES_PER_TICK  8     // a full sweep takes 14 calls
+
+typedef void (*I2C_PRESENCE_CALLBACK)(uint8_t address, bool present);
+void I2C_ScanStart(I2C_PRESENCE_CALLBACK callback);
+void I2C_ScanStop(void);
+void I2C_ScanTask(void);
+bool I2C_IsPresent(uint8_t address);
+uint32_t I2C_ScanSweeps(void);                  // completed sweeps since I2C_ScanStart()
+
+#endif /* I2C_DEVICE_H */
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "OLED128x64.h"
 #include "OLED_FONTS.c"
 #include "definitions.h"
@@ -12,11 +13,27 @@
 #include "OLED_FONTS.c"
 #endif
 
+/* Bus traffic counters, see OLED_StatsGet() */
+static volatile OLED_STATS OLED_Stats;
+
+/* Longest single panel write (control byte + one page) with margin, at 100 kHz */
+#define OLED_I2C_TIMEOUT_US     20000U
+
+/* Longest background refresh: a full frame at 100 kHz with margin */
+#define OLED_FRAME_TIMEOUT_US   150000U
+
 /* I2C wait with timeout - prevents hang if OLED not connected */
 static inline void i2c_wait_with_timeout(void) {
-    volatile uint32_t timeout = 100000;
-    while(SERCOM2_I2C_IsBusy() && timeout > 0) {
-        timeout--;
+    SERCOM2_I2C_DEADLINE deadline;
+
+    SERCOM2_I2C_DeadlineStart(&deadline, OLED_I2C_TIMEOUT_US);
+    SERCOM2_I2C_Tasks();
+    while(SERCOM2_I2C_IsBusy()) {
+        if (SERCOM2_I2C_DeadlineReached(&deadline)) {
+            OLED_Stats.timeouts++;
+            break;
+        }
+        SERCOM2_I2C_Tasks();
     }
 }
 
@@ -26,38 +43,180 @@ static inline void i2c_wait_with_timeout(void) {
 //extern void ReadEncoder(void);
 uint8_t     OLED_Data[4] ;
 
+/* Frame buffer and dirty tracking: one bit per column per page, set only when the
+   shadow byte actually changes, so redrawing identical content costs no bus traffic.
+   Drawing goes to OLED_FrameBuffer (back); OLED_FrontBuffer holds the last swapped
+   frame and is what the I2C interrupt streams, so rendering never races the bus. */
+uint8_t             OLED_FrameBuffer[OLED_PAGES][OLED_COLUMNS] __attribute__((aligned(4)));
+static uint8_t      OLED_FrontBuffer[OLED_PAGES][OLED_COLUMNS];
+static uint32_t     OLED_DirtyCols[OLED_PAGES][OLED_COLUMNS / 32];
+static uint8_t      OLED_DirtyPages;
+static uint8_t      OLED_ForcePages;            // panel content unknown: send without diffing
+
+/* Control byte + command staging area; display data is only copied here in vertical
+   mode, where GDDRAM order does not match the page-major frame buffer */
+static uint8_t      OLED_TxBuf[OLED_COLUMNS + 1];
+
+/* Scatter-gather list of the transfer on the bus: control byte, then the payload
+   straight from its own buffer (one front buffer slice per page of a window) */
+static SERCOM_I2C_SEGMENT   OLED_TxSegs[1 + OLED_PAGES];
+static uint8_t              OLED_DataControl = OLED_Data_Mode;
+
+/* Background refresh: dirty runs are queued as page segments and streamed from the
+   SERCOM2 completion callback, an address transfer followed by a data transfer each */
+typedef struct
+{
+    uint8_t     page;
+    uint8_t     pages;      // >1 only in horizontal/vertical mode: one window over several pages,
+                            // 0 for a single command byte held in x
+    uint8_t     x;
+    uint8_t     count;
+} OLED_SEGMENT;
+
+typedef enum
+{
+    OLED_ASYNC_IDLE = 0,
+    OLED_ASYNC_ADDRESS,
+    OLED_ASYNC_DATA,
+} OLED_ASYNC_STATE;
+
+static OLED_SEGMENT                 OLED_SegQueue[OLED_SEGMENT_QUEUE_SIZE];
+static uint8_t                      OLED_SegCount;
+static volatile uint8_t             OLED_SegHead;
+static uint8_t                      OLED_CurPage;       // vertical mode: next byte of the head segment
+static uint8_t                      OLED_CurCol;
+static uint16_t                     OLED_SegLeft;
+static volatile OLED_ASYNC_STATE    OLED_AsyncState = OLED_ASYNC_IDLE;
+static volatile bool                OLED_AsyncFailed;
+static uint8_t                      OLED_PendingCmd;    // sent after the next swap's data, 0 = none
+
+/* Scrolling log: GDDRAM pages OLED_LogFirst..7 used as a ring, slot is the oldest line */
+static uint8_t                      OLED_LogFirst = OLED_PAGES;
+static uint8_t                      OLED_LogSlot;
+
+static void OLED_WaitIdle(void);
+static void OLED_I2C_EventHandler(uintptr_t context);
+
+/* Every panel transfer goes through here so the counters see all of them. The write
+   is the first count entries of OLED_TxSegs. Background transfers go into the SERCOM2
+   transaction queue with the refresh engine as callback, so they wait behind other
+   devices instead of failing; blocking ones are direct. */
+static bool OLED_I2CWrite(uint8_t count, bool queued)
+{
+    SERCOM_I2C_TRANSACTION  xfer;
+    bool                    ok;
+    uint8_t                 i;
+
+    OLED_Stats.transactions++;
+    for (i = 0; i < count; i++)
+        OLED_Stats.bytes += OLED_TxSegs[i].size;
+    if (queued)
+    {
+        xfer.address = OLED_ADDRESS;
+        xfer.writeBuffer = NULL;
+        xfer.writeSize = 0;
+        xfer.writeSegments = OLED_TxSegs;
+        xfer.writeSegmentCount = count;
+        xfer.readBuffer = NULL;
+        xfer.readSize = 0;
+        xfer.callback = OLED_I2C_EventHandler;
+        xfer.context = 0;
+        ok = SERCOM2_I2C_TransferSubmit(&xfer);
+    }
+    else
+    {
+        ok = SERCOM2_I2C_WriteVectored(OLED_ADDRESS, OLED_TxSegs, count);
+    }
+    if (!ok)
+        OLED_Stats.naks++;                          // plib refused it: bus or queue full
+    return ok;
+}
+
+/* Wait for a blocking transfer and count it if the panel did not acknowledge */
+static void OLED_I2CWait(void)
+{
+    i2c_wait_with_timeout();
+    if (SERCOM2_I2C_ErrorGet() != SERCOM_I2C_ERROR_NONE)
+        OLED_Stats.naks++;
+}
+
+void OLED_FB_Write(uint8_t x, uint8_t page, uint8_t data)
+{
+    if ((x >= OLED_COLUMNS) || (page >= OLED_PAGES))
+        return;
+    if (OLED_FrameBuffer[page][x] != data)
+    {
+        OLED_FrameBuffer[page][x] = data;
+        OLED_DirtyCols[page][x >> 5] |= (1UL << (x & 31U));
+        OLED_DirtyPages |= (uint8_t)(1U << page);
+    }
+}
+
+/* Store 4 columns at a 4-aligned x (rows are 128 bytes), marking only changed bytes dirty */
+static void OLED_FB_Store4(uint8_t x, uint8_t page, uint32_t new4)
+{
+    uint32_t*   word = (uint32_t*)(void*)&OLED_FrameBuffer[page][x];
+    uint32_t    diff = *word ^ new4;
+    uint32_t    cols;
+
+    if (diff == 0U)
+        return;
+    *word = new4;
+    cols = ((diff & 0x000000FFUL) != 0U ? 1UL : 0UL) | ((diff & 0x0000FF00UL) != 0U ? 2UL : 0UL)
+         | ((diff & 0x00FF0000UL) != 0U ? 4UL : 0UL) | ((diff & 0xFF000000UL) != 0U ? 8UL : 0UL);
+    OLED_DirtyCols[page][x >> 5] |= cols << (x & 31U);
+    OLED_DirtyPages |= (uint8_t)(1U << page);
+}
+
+/* Panel content is unknown (power-up, re-init): resend everything on the next swap */
+void OLED_Invalidate(void)
+{
+    memset(OLED_DirtyCols, 0xFF, sizeof(OLED_DirtyCols));
+    OLED_DirtyPages = 0xFF;
+    OLED_ForcePages = 0xFF;
+}
+
+bool OLED_IsDirty(void)
+{
+    return (OLED_DirtyPages != 0U);
+}
+
+/* Power-up sequence, sent as a single command stream under one 0x00 control byte */
+static const uint8_t OLED_InitSeq[] =
+{
+    0xAE,           //display off
+    0x20, OLED_ADDRESSING_MODE, //Set Memory Addressing Mode: 00,Horizontal;01,Vertical;10,Page Addressing Mode (RESET);11,Invalid
+#if OLED_ADDRESSING_MODE != OLED_ADDR_PAGE
+    0x21, 0x00, 0x7F,   //Set Column Address window 0-127
+    0x22, 0x00, 0x07,   //Set Page Address window 0-7
+#endif
+    0xB0,           //Set Page Start Address for Page Addressing Mode,0-7
+    0xC8,           //Set COM Output Scan Direction
+    0x00,           //---set low column address
+    0x10,           //---set high column address
+    0x40,           //--set start line address
+    0x81, 0x7F,     //--set contrast control register
+    0xA1,           //--set segment re-map 0 to 127
+    0xA6,           //--set normal display
+    0xA8, 0x3F,     //--set multiplex ratio(1 to 64)
+    0xA4,           //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+    0xD3, 0x00,     //-set display offset: not offset
+    0xD5, 0xF0,     //--set display clock divide ratio/oscillator frequency
+    0xD9, 0x22,     //--set pre-charge period
+    0xDA, 0x12,     //--set com pins hardware configuration
+    0xDB, 0x20,     //--set vcomh: 0x20,0.77xVcc
+    0x8D, 0x14,     //--set DC-DC enable
+    0xAF,           //--turn on oled panel
+};
+
 void OLED_Init(void)
 {
 //    __delay_us(50);
-            OLEDWrCmd(0xAE);        //display off
-            OLEDWrCmd(0x20);	//Set Memory Addressing Mode	
-            OLEDWrCmd(0x10);	//00,Horizontal Addressing Mode;01,Vertical Addressing Mode;10,Page Addressing Mode (RESET);11,Invalid
-            OLEDWrCmd(0xB0);	//Set Page Start Address for Page Addressing Mode,0-7
-            OLEDWrCmd(0xC8);	//Set COM Output Scan Direction
-            OLEDWrCmd(0x00);    //---set low column address
-            OLEDWrCmd(0x10);    //---set high column address
-            OLEDWrCmd(0x40);    //--set start line address
-            OLEDWrCmd(0x81);    //--set contrast control register
-            OLEDWrCmd(0x7F);
-            OLEDWrCmd(0xA1);    //--set segment re-map 0 to 127
-            OLEDWrCmd(0xA6);    //--set normal display
-            OLEDWrCmd(0xA8);    //--set multiplex ratio(1 to 64)
-            OLEDWrCmd(0x3F);    //
-            OLEDWrCmd(0xA4);    //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
-            OLEDWrCmd(0xD3);    //-set display offset
-    
-	OLEDWrCmd(0x00);    //-not offset
-	OLEDWrCmd(0xD5);    //--set display clock divide ratio/oscillator frequency
-	OLEDWrCmd(0xF0);    //--set divide ratio
-	OLEDWrCmd(0xD9);    //--set pre-charge period
-	OLEDWrCmd(0x22);    //
-	OLEDWrCmd(0xDA);    //--set com pins hardware configuration
-	OLEDWrCmd(0x12);
-	OLEDWrCmd(0xDB);    //--set vcomh
-	OLEDWrCmd(0x20);    //0x20,0.77xVcc
-	OLEDWrCmd(0x8D);    //--set DC-DC enable
-	OLEDWrCmd(0x14);    //
-	OLEDWrCmd(0xAF);    //--turn on oled panel    
+    OLEDWrCmdList(OLED_InitSeq, (uint8_t)sizeof(OLED_InitSeq));
+
+    memset(OLED_FrameBuffer, 0, sizeof(OLED_FrameBuffer));
+    memset(OLED_FrontBuffer, 0, sizeof(OLED_FrontBuffer));
+    OLED_Invalidate();
 }
 
 /********** copy from LQ12864 **********/
@@ -68,106 +227,197 @@ void OLED_Put16x16Ch(uint8_t x, uint8_t y, uint8_t index)
 	unsigned char     i, j;
     
     i= index;                       // point to character which will be put to LCD
-	OLED_Set_Pos(x, y);
 	for(j=0; j<16; j++)              // upper part of Chinese character
 	{
-		OLEDWrDat(Font16x16[i][j]);
+		OLED_FB_Write((uint8_t)(x+j), y, Font16x16[i][j]);
 	}
-	OLED_Set_Pos(x, (unsigned char)(y+1) );
 	for(j=16; j<32; j++)            // lower part of Chinese character
 	{
-		OLEDWrDat(Font16x16[i][j]);
+		OLED_FB_Write((uint8_t)(x+j-16), (uint8_t)(y+1), Font16x16[i][j]);
 	} 	  	
 }
 
 /*********************set OLED display location************************************/
+/* Page mode: page + column start. Horizontal/vertical mode: column and page window,
+   the GDDRAM pointer then walks the window on its own. Returns the command count. */
+static uint8_t OLED_WindowCmds(uint8_t cmds[], uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+#if OLED_ADDRESSING_MODE == OLED_ADDR_PAGE
+	cmds[0] = (uint8_t) (0xb0+p0);
+	cmds[1] = (uint8_t)(((x0&0xf0)>>4)|0x10);
+	cmds[2] = (uint8_t)(x0&0x0f);
+    (void)x1;
+    (void)p1;
+    return 3;
+#else
+    cmds[0] = 0x21;
+    cmds[1] = x0;
+    cmds[2] = x1;
+    cmds[3] = 0x22;
+    cmds[4] = p0;
+    cmds[5] = p1;
+    return 6;
+#endif
+}
+
 void OLED_Set_Pos(uint8_t x, uint8_t y) 
 { 
-	OLEDWrCmd((uint8_t) (0xb0+y) );
-	OLEDWrCmd((uint8_t)(((x&0xf0)>>4)|0x10));
-	OLEDWrCmd((uint8_t)((x&0x0f)|0x01));
+    uint8_t     cmds[6];
+
+    OLEDWrCmdList(cmds, OLED_WindowCmds(cmds, x, OLED_COLUMNS - 1U, y, OLED_PAGES - 1U));
+}
+
+/* Horizontal/vertical mode only: following data bytes fill columns x0..x1 of pages p0..p1 */
+void OLED_SetWindow(uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    uint8_t     cmds[6];
+
+    OLEDWrCmdList(cmds, OLED_WindowCmds(cmds, x0, x1, p0, p1));
+}
+
+/********************** text: whole strings rendered as glyph runs **********************/
+/* One page of a string is rendered into a word-aligned run buffer that lines up with
+   the frame buffer columns, then stored 32 bits at a time, so a numeric field costs
+   about a memcpy and an unchanged one marks nothing dirty. */
+
+static uint8_t OLED_FontWidth(uint8_t font)
+{
+    font &= (uint8_t)~OLED_TEXT_INVERSE;
+    return (font == OLED_FONT_6X8 || font == OLED_FONT_6X16) ? 6U : 8U;
+}
+
+static uint8_t OLED_FontPages(uint8_t font)
+{
+    return ((font & (uint8_t)~OLED_TEXT_INVERSE) == OLED_FONT_6X8) ? 1U : 2U;
+}
+
+/* Glyph index with a bounds check: anything the font does not cover draws as a space */
+static uint8_t OLED_GlyphIndex(uint8_t ch, uint8_t font)
+{
+    switch (font & (uint8_t)~OLED_TEXT_INVERSE)
+    {
+        case OLED_FONT_SEG7:
+            if ((ch >= '0') && (ch <= '9'))
+                return (uint8_t)(ch - '0');
+            return (ch == '-') ? 11U : 10U;
+        case OLED_FONT_8X16:
+            return ((ch < 0x20U) || ((uint8_t)(ch - 0x20U) >= sizeof(Font8x16) / sizeof(Font8x16[0])))
+                   ? 0U : (uint8_t)(ch - 0x20U);
+        default:
+            return ((ch < 0x20U) || ((uint8_t)(ch - 0x20U) >= sizeof(Font6x8) / sizeof(Font6x8[0])))
+                   ? 0U : (uint8_t)(ch - 0x20U);
+    }
+}
+
+/* Render 'len' glyphs of one page ('half' 0 upper, 1 lower) and store them at (x, page).
+   The caller guarantees the run fits within the row. */
+static void OLED_PutRun(uint8_t x, uint8_t page, const uint8_t s[], uint8_t len, uint8_t font, uint8_t half)
+{
+    uint32_t        run32[OLED_COLUMNS / 4 + 1];
+    uint8_t*        run = (uint8_t*)run32;
+    uint8_t         lead = (uint8_t)(x & 3U);
+    uint8_t         pos = lead;
+    uint8_t         end, i, j, g;
+
+    if (page >= OLED_PAGES)
+        return;
+
+    for (i = 0; i < len; i++)
+    {
+        g = OLED_GlyphIndex(s[i], font);
+        switch (font & (uint8_t)~OLED_TEXT_INVERSE)
+        {
+            case OLED_FONT_6X16:
+                for (j = 0; j < 6U; j++)
+                    run[pos + j] = FontStretch4[(Font6x8[g][j] >> (half << 2)) & 0x0FU];
+                break;
+            case OLED_FONT_8X16:
+                memcpy(&run[pos], &Font8x16[g][half << 3], 8);
+                break;
+            case OLED_FONT_SEG7:
+                memcpy(&run[pos], &FontSeg7[g][half << 3], 8);
+                break;
+            default:
+                memcpy(&run[pos], Font6x8[g], 6);
+                break;
+        }
+        pos = (uint8_t)(pos + OLED_FontWidth(font));
+    }
+
+    if ((font & OLED_TEXT_INVERSE) != 0U)
+    {
+        for (i = 0; i < (uint8_t)((pos + 3U) >> 2); i++)
+            run32[i] ^= 0xFFFFFFFFUL;
+    }
+
+    /* Byte stores up to the first word boundary, words in the middle, bytes at the tail */
+    end = (uint8_t)(x + pos - lead);
+    for (i = lead; (x < end) && ((x & 3U) != 0U); i++, x++)
+        OLED_FB_Write(x, page, run[i]);
+    for (; (uint8_t)(end - x) >= 4U; i = (uint8_t)(i + 4U), x = (uint8_t)(x + 4U))
+        OLED_FB_Store4(x, page, run32[i >> 2]);
+    for (; x < end; i++, x++)
+        OLED_FB_Write(x, page, run[i]);
+}
+
+/* Draw 'len' characters at column x, page y, wrapping to the next text line at the edge */
+void OLED_PutText(uint8_t x, uint8_t y, const uint8_t s[], uint8_t len, uint8_t font)
+{
+    uint8_t w = OLED_FontWidth(font);
+    uint8_t pages = OLED_FontPages(font);
+    uint8_t fit, half;
+
+    while ((len > 0U) && (y < OLED_PAGES))
+    {
+        fit = 0;
+        while ((fit < len) && ((uint16_t)x + (uint16_t)(fit + 1U) * w <= OLED_COLUMNS))
+            fit++;
+        if (fit == 0U)
+        {
+            x = 0;
+            y = (uint8_t)(y + pages);
+            continue;
+        }
+        for (half = 0; half < pages; half++)
+            OLED_PutRun(x, (uint8_t)(y + half), s, fit, font, half);
+        x = (uint8_t)(x + fit * w);
+        s += fit;
+        len = (uint8_t)(len - fit);
+    }
+}
+
+void OLED_PutStr(uint8_t x, uint8_t y, const uint8_t s[], uint8_t font)
+{
+    size_t  len = strlen((const char*)s);
+
+    OLED_PutText(x, y, s, (uint8_t)((len > 255U) ? 255U : len), font);
 }
 
 /********** display 6*8 ASCII character at coordinate(x,y), y range 0~7 ***********/
 void OLED_Put6x8Str(uint8_t x, uint8_t y, const uint8_t ch[])
 {
-	uint8_t c, i, j;
-    
-    j = 0;
-	while (ch[j]!='\0')
-	{
-		c = (uint8_t) (ch[j] - 0x20);
-		if(x>126) {
-            x=0;
-            y++;
-        }
-		OLED_Set_Pos(x,y);
-		for(i=0; i<6; i++)
-            OLEDWrDat(Font6x8[c][i]);
-		x += 6;
-		j++;
-	}
+    OLED_PutStr(x, y, ch, OLED_FONT_6X8);
 }
 
 /******* display 8*16 ASCII character at coordinate(x,y), y range 0~7 *******/
 void OLED_Put8x16Str(uint8_t x, uint8_t y, const uint8_t ch[])
 {
-	uint8_t c, i, j;
-    j = 0;
-	while (ch[j]!='\0')
-	{
-		c = (uint8_t) (ch[j] - 0x20);    // ASCII not start from 0, it start from 32 (20H) to 126 (7EH)
-		if(x>120) {
-            x=0;
-            y++;
-        }
-		OLED_Set_Pos(x, y);            
-		for(i=0; i<8; i++) { OLEDWrDat(Font8x16[c][i]); }       // upper part of the ASCII character
-		OLED_Set_Pos(x, (uint8_t) (y+1));
-		for(i=8; i<16; i++) { OLEDWrDat(Font8x16[c][i]); }      // lower part of the ASCII character
-		x += 8; // 8x16 font so x move 8 for next character
-		j++;    // next character
-	}
+    OLED_PutStr(x, y, ch, OLED_FONT_8X16);
 }
 
 /******* display 8*16 ASCII character at coordinate(x,y), y range 0~7 *******/
 void OLED_Put8x16ASCII(uint8_t x, uint8_t y, uint8_t no, uint8_t data[])
 {
-	uint8_t cIndex, i, j;
-    
-    j = 0;
-	while (j < no)
-	{
-		cIndex = (uint8_t) (data[j] - 0x20);    // ASCII not start from 0, it start from 32 (20H) to 126 (7EH)
-		if(x>120) {
-            x=0;
-            y++;
-        }
-		OLED_Set_Pos(x, y);             // upper part of the ASCII character
-		for(i=0; i<8; i++) {
-            OLEDWrDat(Font8x16[cIndex][i]);
-//            ReadEncoder();
-        }
-		OLED_Set_Pos(x, (uint8_t) (y+1));
-		for(i=8; i<16; i++) {            // lower part of the ASCII character
-            OLEDWrDat(Font8x16[cIndex][i]);
-//            ReadEncoder();
-        }
-		x += 8; // 8x16 font so x move 8 for next character
-		j++;    // next data byte
-	}
+    OLED_PutText(x, y, data, no, OLED_FONT_8X16);
 }
 
 
 void OLED_CLS(void)
 {
 	uint8_t     x, y;    
-	for(y=0; y<8; y++)
+	for(y=0; y<OLED_PAGES; y++)
 	{
-		OLEDWrCmd((uint8_t) (0xb0+y));
-		OLEDWrCmd(0x00);
-		OLEDWrCmd(0x10);
-		for(x=0;x<X_WIDTH;x++)      OLEDWrDat(0);       
+		for(x=0;x<OLED_COLUMNS;x++)      OLED_FB_Write(x, y, 0);       
 	}
 }
 
@@ -181,6 +431,96 @@ void displayOff(void)           // Turns off Display
     OLEDWrCmd(0xAE);		//display off
 }
 
+/*************************** hardware scroll and start line ***************************/
+/* Display start line 0~63: GDDRAM row shown on the top panel row (0x40~0x7F). With a
+   scroll area set it counts from the area's top row and must stay below its rows. */
+void OLED_SetStartLine(uint8_t line)
+{
+    OLEDWrCmd((uint8_t)(0x40U | (line & 0x3FU)));
+}
+
+/* Vertical shift of the COM mapping, 0~63 rows (0xD3) */
+void OLED_SetDisplayOffset(uint8_t rows)
+{
+    uint8_t     cmds[2] = { 0xD3, (uint8_t)(rows & 0x3FU) };
+
+    OLEDWrCmdList(cmds, 2);
+}
+
+/* Rows 0~top-1 stay fixed, the next 'rows' rows take part in vertical scrolling (0xA3) */
+static void OLED_SetScrollArea(uint8_t top, uint8_t rows)
+{
+    uint8_t     cmds[3] = { 0xA3, top, rows };
+
+    OLEDWrCmdList(cmds, 3);
+}
+
+/* Continuous horizontal scroll of pages start~end (0x26 right, 0x27 left). interval is
+   the 3-bit frame interval code of the datasheet (0: 5 frames ... 7: 2 frames). */
+void OLED_ScrollHorizontal(bool left, uint8_t start, uint8_t end, uint8_t interval)
+{
+    uint8_t     cmds[9] = { 0x2E, left ? 0x27 : 0x26, 0x00, start, (uint8_t)(interval & 7U), end, 0x00, 0xFF, 0x2F };
+
+    OLEDWrCmdList(cmds, 9);
+}
+
+/* Continuous vertical + horizontal scroll (0x29 right, 0x2A left), moving 'offset' rows
+   per step inside the area set by OLED_SetScrollArea (whole panel unless the log set it) */
+void OLED_ScrollDiagonal(bool left, uint8_t start, uint8_t end, uint8_t interval, uint8_t offset)
+{
+    uint8_t     cmds[8] = { 0x2E, left ? 0x2A : 0x29, 0x00, start, (uint8_t)(interval & 7U), end, (uint8_t)(offset & 0x3FU), 0x2F };
+
+    OLEDWrCmdList(cmds, 8);
+}
+
+/* Stop scrolling (0x2E). GDDRAM content is not defined after a scroll, resend it all. */
+void OLED_ScrollStop(void)
+{
+    OLEDWrCmd(0x2E);
+    OLED_Invalidate();
+}
+
+/* Scrolling log on pages first~7. Pages above stay fixed; new lines are written into
+   the oldest GDDRAM page and the start line is moved down by one page, so each line
+   costs one page of data plus one command instead of redrawing the whole region. The
+   start line is relative to the scroll area (page first is line 0), as the datasheet
+   requires it to be below the area's row count. */
+void OLED_LogInit(uint8_t first)
+{
+    if (first >= OLED_PAGES)
+        return;
+    OLED_LogFirst = first;
+    OLED_LogSlot = first;
+    OLED_SetScrollArea((uint8_t)(first << 3), (uint8_t)((OLED_PAGES - first) << 3));
+    OLED_SetStartLine(0);
+    OLED_FillRect(0, (uint8_t)(first << 3), OLED_COLUMNS, (uint8_t)((OLED_PAGES - first) << 3), BLACK);
+}
+
+/* Append a 6x8 text line; it appears with the next OLED_SwapBuffers() */
+void OLED_LogLine(const uint8_t s[])
+{
+    if (OLED_LogFirst >= OLED_PAGES)
+        return;
+
+    OLED_FillRect(0, (uint8_t)(OLED_LogSlot << 3), OLED_COLUMNS, 8, BLACK);
+    OLED_PutStr(0, OLED_LogSlot, s, OLED_FONT_6X8);
+
+    OLED_LogSlot++;
+    if (OLED_LogSlot >= OLED_PAGES)
+        OLED_LogSlot = OLED_LogFirst;
+    OLED_PendingCmd = (uint8_t)(0x40U | ((OLED_LogSlot - OLED_LogFirst) << 3));    // oldest line on top
+}
+
+/* Leave log mode: whole panel unscrolled again, caller redraws the log pages */
+void OLED_LogStop(void)
+{
+    OLED_WaitIdle();
+    OLED_PendingCmd = 0;
+    OLED_LogFirst = OLED_PAGES;
+    OLED_SetScrollArea(0, Y_WIDTH);
+    OLED_SetStartLine(0);
+}
+
 
 /***** display BMP picture, initial coordinate(x,y), x range 0~127, y range 0~7 *****/
 void Draw_BMP(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t BMP[])
@@ -193,41 +533,634 @@ void Draw_BMP(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t BMP[])
     j = 0;
 	for(y=y0; y<y1; y++)
 	{
-		OLED_Set_Pos(x0,y);
         for(x=x0; x<x1; x++) {      
-	    	OLEDWrDat(BMP[j++]);
+	    	OLED_FB_Write(x, y, BMP[j++]);
 	    }
 	}
 }
 
+/************************ graphics primitives on the frame buffer ************************/
+/* Pixel (x,y) lives in OLED_FrameBuffer[y >> 3][x], bit y & 7. Everything below reduces
+   to column spans of one page with a row mask, applied a byte (8 rows) at a time or a
+   32-bit word (4 columns) at a time as new = (old & keep) ^ flip. */
+
+static void OLED_ColorMasks(uint8_t mask, uint8_t color, uint8_t* keep, uint8_t* flip)
+{
+    if (color == INVERSE)
+    {
+        *keep = 0xFF;
+        *flip = mask;
+    }
+    else
+    {
+        *keep = (uint8_t)~mask;
+        *flip = (color == WHITE) ? mask : 0U;
+    }
+}
+
+/* Rows y0..y1-1 that fall into this page, as a bit mask */
+static uint8_t OLED_RowMask(uint8_t page, uint8_t y0, uint8_t y1)
+{
+    uint8_t top = (uint8_t)(page << 3);
+    uint8_t lo = (y0 > top) ? (uint8_t)(y0 - top) : 0U;
+    uint8_t hi = ((uint16_t)y1 < (uint16_t)top + 8U) ? (uint8_t)(y1 - top) : 8U;
+
+    if (hi <= lo)
+        return 0;
+    return (uint8_t)((0xFFU >> (8U - hi)) & (0xFFU << lo));
+}
+
+static void OLED_FB_Span(uint8_t x, uint8_t page, uint8_t w, uint8_t mask, uint8_t color)
+{
+    uint8_t     keep, flip, end, old;
+    uint32_t    keep4, flip4, old4;
+
+    if ((x >= OLED_COLUMNS) || (page >= OLED_PAGES) || (w == 0U) || (mask == 0U))
+        return;
+    if (w > (uint8_t)(OLED_COLUMNS - x))
+        w = (uint8_t)(OLED_COLUMNS - x);
+    end = (uint8_t)(x + w);
+    OLED_ColorMasks(mask, color, &keep, &flip);
+
+    for (; (x < end) && ((x & 3U) != 0U); x++)
+    {
+        old = OLED_FrameBuffer[page][x];
+        OLED_FB_Write(x, page, (uint8_t)((old & keep) ^ flip));
+    }
+
+    keep4 = keep * 0x01010101UL;
+    flip4 = flip * 0x01010101UL;
+    for (; (uint8_t)(end - x) >= 4U; x = (uint8_t)(x + 4U))
+    {
+        old4 = *(const uint32_t*)(const void*)&OLED_FrameBuffer[page][x];
+        OLED_FB_Store4(x, page, (old4 & keep4) ^ flip4);
+    }
+
+    for (; x < end; x++)
+    {
+        old = OLED_FrameBuffer[page][x];
+        OLED_FB_Write(x, page, (uint8_t)((old & keep) ^ flip));
+    }
+}
+
+// the most basic function, set a single pixel
+void drawPixel(uint8_t x, uint8_t y, uint8_t color)
+{
+    if ((x >= OLED_COLUMNS) || (y >= Y_WIDTH))
+        return;
+    OLED_FB_Span(x, (uint8_t)(y >> 3), 1, (uint8_t)(1U << (y & 7U)), color);
+}
+
+void OLED_DrawHLine(uint8_t x, uint8_t y, uint8_t w, uint8_t color)
+{
+    if (y >= Y_WIDTH)
+        return;
+    OLED_FB_Span(x, (uint8_t)(y >> 3), w, (uint8_t)(1U << (y & 7U)), color);
+}
+
+void OLED_DrawVLine(uint8_t x, uint8_t y, uint8_t h, uint8_t color)
+{
+    OLED_FillRect(x, y, 1, h, color);
+}
+
+void OLED_FillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+    uint8_t     page, y1;
+
+    if ((y >= Y_WIDTH) || (h == 0U))
+        return;
+    y1 = (h > (uint8_t)(Y_WIDTH - y)) ? (uint8_t)Y_WIDTH : (uint8_t)(y + h);
+    for (page = (uint8_t)(y >> 3); page <= (uint8_t)((y1 - 1U) >> 3); page++)
+        OLED_FB_Span(x, page, w, OLED_RowMask(page, y, y1), color);
+}
+
+void OLED_DrawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+    if ((w == 0U) || (h == 0U))
+        return;
+    OLED_DrawHLine(x, y, w, color);
+    if (h > 1U)
+        OLED_DrawHLine(x, (uint8_t)(y + h - 1U), w, color);
+    if (h > 2U)
+    {
+        OLED_DrawVLine(x, (uint8_t)(y + 1U), (uint8_t)(h - 2U), color);
+        if (w > 1U)
+            OLED_DrawVLine((uint8_t)(x + w - 1U), (uint8_t)(y + 1U), (uint8_t)(h - 2U), color);
+    }
+}
+
+void OLED_DrawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t color)
+{
+    int16_t dx, dy, sx, sy, err, e2;
+
+    if (y0 == y1)
+    {
+        if (x0 > x1) swap(x0, x1);
+        OLED_DrawHLine(x0, y0, (uint8_t)(x1 - x0 + 1U), color);
+        return;
+    }
+    if (x0 == x1)
+    {
+        if (y0 > y1) swap(y0, y1);
+        OLED_DrawVLine(x0, y0, (uint8_t)(y1 - y0 + 1U), color);
+        return;
+    }
+
+    /* Bresenham */
+    dx = (int16_t)((x1 > x0) ? (x1 - x0) : (x0 - x1));
+    dy = (int16_t)-((y1 > y0) ? (y1 - y0) : (y0 - y1));
+    sx = (x0 < x1) ? 1 : -1;
+    sy = (y0 < y1) ? 1 : -1;
+    err = (int16_t)(dx + dy);
+    for (;;)
+    {
+        drawPixel(x0, y0, color);
+        if ((x0 == x1) && (y0 == y1))
+            break;
+        e2 = (int16_t)(2 * err);
+        if (e2 >= dy) { err = (int16_t)(err + dy); x0 = (uint8_t)(x0 + sx); }
+        if (e2 <= dx) { err = (int16_t)(err + dx); y0 = (uint8_t)(y0 + sy); }
+    }
+}
+
+/* Outlined bar, filled from the left in proportion to level/max */
+void OLED_DrawBar(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t level, uint16_t max)
+{
+    uint8_t fill;
+
+    if ((w < 3U) || (h < 3U))
+        return;
+    if (level > max)
+        level = max;
+    fill = (max == 0U) ? 0U : (uint8_t)(((uint32_t)level * (uint32_t)(w - 2U)) / max);
+
+    OLED_DrawRect(x, y, w, h, WHITE);
+    OLED_FillRect((uint8_t)(x + 1U), (uint8_t)(y + 1U), fill, (uint8_t)(h - 2U), WHITE);
+    OLED_FillRect((uint8_t)(x + 1U + fill), (uint8_t)(y + 1U), (uint8_t)(w - 2U - fill), (uint8_t)(h - 2U), BLACK);
+}
+
+static void OLED_ArcPoint(int16_t x, int16_t y, uint8_t color)
+{
+    if ((x >= 0) && (x < OLED_COLUMNS) && (y >= 0) && (y < Y_WIDTH))
+        drawPixel((uint8_t)x, (uint8_t)y, color);
+}
+
+/* Midpoint circle restricted to the octants set in 'octants'. Bit 0 is the octant
+   from 12 o'clock towards 1:30, the following bits continue clockwise. */
+void OLED_DrawArc(uint8_t cx, uint8_t cy, uint8_t r, uint8_t octants, uint8_t color)
+{
+    int16_t x = 0, y = r, d = (int16_t)(1 - (int16_t)r);
+
+    while (x <= y)
+    {
+        if (octants & 0x01U) OLED_ArcPoint((int16_t)(cx + x), (int16_t)(cy - y), color);
+        if (octants & 0x02U) OLED_ArcPoint((int16_t)(cx + y), (int16_t)(cy - x), color);
+        if (octants & 0x04U) OLED_ArcPoint((int16_t)(cx + y), (int16_t)(cy + x), color);
+        if (octants & 0x08U) OLED_ArcPoint((int16_t)(cx + x), (int16_t)(cy + y), color);
+        if (octants & 0x10U) OLED_ArcPoint((int16_t)(cx - x), (int16_t)(cy + y), color);
+        if (octants & 0x20U) OLED_ArcPoint((int16_t)(cx - y), (int16_t)(cy + x), color);
+        if (octants & 0x40U) OLED_ArcPoint((int16_t)(cx - y), (int16_t)(cy - x), color);
+        if (octants & 0x80U) OLED_ArcPoint((int16_t)(cx - x), (int16_t)(cy - y), color);
+        if (d < 0)
+            d = (int16_t)(d + 2 * x + 3);
+        else
+        {
+            d = (int16_t)(d + 2 * (x - y) + 5);
+            y--;
+        }
+        x++;
+    }
+}
+
+/* Blit a page-major bitmap (w bytes per 8-row band, bit 0 on top) at any pixel row.
+   Set bits are drawn in 'color', clear bits leave the frame buffer alone, so each
+   source byte lands as at most two masked byte writes. */
+void OLED_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t bmp[], uint8_t color)
+{
+    uint8_t     band, bands, col, bits, shift, page;
+    uint16_t    src = 0;
+
+    if ((y >= Y_WIDTH) || (h == 0U))
+        return;
+    bands = (uint8_t)((h + 7U) >> 3);
+    shift = (uint8_t)(y & 7U);
+    for (band = 0; band < bands; band++)
+    {
+        page = (uint8_t)((y >> 3) + band);
+        for (col = 0; col < w; col++)
+        {
+            bits = bmp[src++];
+            if ((band == (uint8_t)(bands - 1U)) && ((h & 7U) != 0U))
+                bits &= (uint8_t)(0xFFU >> (8U - (h & 7U)));
+            OLED_FB_Span((uint8_t)(x + col), page, 1, (uint8_t)(bits << shift), color);
+            if (shift != 0U)
+                OLED_FB_Span((uint8_t)(x + col), (uint8_t)(page + 1U), 1, (uint8_t)(bits >> (8U - shift)), color);
+        }
+    }
+}
+
+/* Find the next run of dirty columns in a page starting at *x. Clean gaps of up to
+   OLED_FLUSH_MERGE_GAP columns are folded into the run since re-addressing costs more */
+static bool OLED_NextDirtyRun(uint8_t page, uint8_t* x, uint8_t* end)
+{
+    const uint32_t* mask = OLED_DirtyCols[page];
+    uint8_t col = *x;
+    uint8_t last;
+
+    while ((col < OLED_COLUMNS) && ((mask[col >> 5] & (1UL << (col & 31U))) == 0U))
+    {
+        col = ((mask[col >> 5] >> (col & 31U)) == 0U) ? (uint8_t)((col | 31U) + 1U) : (uint8_t)(col + 1U);
+    }
+    if (col >= OLED_COLUMNS)
+        return false;
+
+    *x = col;
+    last = col;
+    for (col++; col < OLED_COLUMNS; col++)
+    {
+        if ((mask[col >> 5] & (1UL << (col & 31U))) != 0U)
+            last = col;
+        else if ((uint8_t)(col - last) > OLED_FLUSH_MERGE_GAP)
+            break;
+    }
+    *end = (uint8_t)(last + 1U);
+    return true;
+}
+
+static void OLED_MarkCols(uint8_t page, uint8_t x, uint8_t end, bool dirty)
+{
+    for (; x < end; x++)
+    {
+        if (dirty)
+            OLED_DirtyCols[page][x >> 5] |= (1UL << (x & 31U));
+        else
+            OLED_DirtyCols[page][x >> 5] &= ~(1UL << (x & 31U));
+    }
+    if (dirty)
+        OLED_DirtyPages |= (uint8_t)(1U << page);
+}
+
+/* Drop dirty marks on columns that ended up equal to what the panel already shows
+   (e.g. CLS followed by redrawing the same text). Returns true if any are left. */
+static bool OLED_DiffPage(uint8_t page)
+{
+    uint32_t*   mask = OLED_DirtyCols[page];
+    uint32_t    left = 0;
+    uint8_t     col;
+
+    for (col = 0; col < OLED_COLUMNS; col++)
+    {
+        if ((col & 31U) == 0U && mask[col >> 5] == 0U)
+        {
+            col |= 31U;
+            continue;
+        }
+        if ((mask[col >> 5] & (1UL << (col & 31U))) != 0U &&
+            OLED_FrameBuffer[page][col] == OLED_FrontBuffer[page][col])
+            mask[col >> 5] &= ~(1UL << (col & 31U));
+    }
+    for (col = 0; col < OLED_COLUMNS / 32; col++)
+        left |= mask[col];
+    return (left != 0U);
+}
+
+static uint8_t OLED_LastDirtyCol(uint8_t page)
+{
+    const uint32_t* mask = OLED_DirtyCols[page];
+    uint8_t         col = OLED_COLUMNS - 1U;
+
+    while ((col > 0U) && ((mask[col >> 5] & (1UL << (col & 31U))) == 0U))
+        col--;
+    return col;
+}
+
+/* Describe the next data transfer of the head segment in OLED_TxSegs, returns the
+   number of entries. Page/horizontal mode: the whole window goes in one transfer as
+   one front buffer slice per page, nothing is copied. Vertical mode: GDDRAM wants
+   column-major order, so up to one transfer's worth is staged in OLED_TxBuf and a
+   larger window continues in the next transfer without re-addressing. */
+static uint8_t OLED_FillData(const OLED_SEGMENT* seg)
+{
+    uint8_t     n = 0;
+
+    OLED_TxSegs[0].data = &OLED_DataControl;
+    OLED_TxSegs[0].size = 1;
+#if OLED_ADDRESSING_MODE == OLED_ADDR_VERTICAL
+    while ((n < OLED_COLUMNS) && (OLED_SegLeft != 0U))
+    {
+        OLED_TxBuf[n++] = OLED_FrontBuffer[OLED_CurPage][OLED_CurCol];
+        OLED_SegLeft--;
+        if (++OLED_CurPage == (uint8_t)(seg->page + seg->pages))
+        {
+            OLED_CurPage = seg->page;
+            OLED_CurCol++;
+        }
+    }
+    OLED_TxSegs[1].data = OLED_TxBuf;
+    OLED_TxSegs[1].size = n;
+    return 2;
+#else
+    for (n = 0; n < seg->pages; n++)
+    {
+        OLED_TxSegs[1U + n].data = &OLED_FrontBuffer[seg->page + n][seg->x];
+        OLED_TxSegs[1U + n].size = seg->count;
+    }
+    OLED_SegLeft = 0;
+    return (uint8_t)(1U + n);
+#endif
+}
+
+/* Start the transfer for the current phase of the head segment. Runs in thread
+   context for the first segment and in the SERCOM2 ISR for all following ones. */
+static void OLED_AsyncSend(void)
+{
+    const OLED_SEGMENT* seg = &OLED_SegQueue[OLED_SegHead];
+    uint8_t             count = 1;
+
+    OLED_TxSegs[0].data = OLED_TxBuf;
+    if ((OLED_AsyncState == OLED_ASYNC_ADDRESS) && (seg->pages == 0U))
+    {
+        OLED_TxBuf[0] = OLED_Command_Stream;
+        OLED_TxBuf[1] = seg->x;
+        OLED_TxSegs[0].size = 2;
+        OLED_SegLeft = 0;
+    }
+    else if (OLED_AsyncState == OLED_ASYNC_ADDRESS)
+    {
+        OLED_TxBuf[0] = OLED_Command_Stream;
+        OLED_TxSegs[0].size = 1U + OLED_WindowCmds(&OLED_TxBuf[1], seg->x, (uint8_t)(seg->x + seg->count - 1U),
+                                                   seg->page, (uint8_t)(seg->page + seg->pages - 1U));
+        OLED_CurPage = seg->page;
+        OLED_CurCol = seg->x;
+        OLED_SegLeft = (uint16_t)((uint16_t)seg->count * seg->pages);
+    }
+    else
+    {
+        count = OLED_FillData(seg);
+    }
+
+    if (!OLED_I2CWrite(count, true))
+    {
+        OLED_AsyncFailed = true;
+        OLED_AsyncState = OLED_ASYNC_IDLE;
+    }
+}
+
+static void OLED_I2C_EventHandler(uintptr_t context)
+{
+    if (OLED_AsyncState == OLED_ASYNC_IDLE)
+        return;                                     // no refresh running
+
+    if (SERCOM2_I2C_ErrorGet() != SERCOM_I2C_ERROR_NONE)
+    {
+        OLED_Stats.naks++;
+        OLED_AsyncFailed = true;                    // unsent segments are re-queued next swap
+        OLED_AsyncState = OLED_ASYNC_IDLE;
+        return;
+    }
+
+    if ((OLED_AsyncState == OLED_ASYNC_ADDRESS) && (OLED_SegLeft != 0U))
+    {
+        OLED_AsyncState = OLED_ASYNC_DATA;
+    }
+    else if (OLED_SegLeft == 0U)
+    {
+        OLED_SegHead++;
+        if (OLED_SegHead >= OLED_SegCount)
+        {
+            OLED_AsyncState = OLED_ASYNC_IDLE;
+            return;
+        }
+        OLED_AsyncState = OLED_ASYNC_ADDRESS;
+    }
+    OLED_AsyncSend();                               // DATA with bytes left: next chunk of the window
+}
+
+bool OLED_IsBusy(void)
+{
+    return (OLED_AsyncState != OLED_ASYNC_IDLE);
+}
+
+static void OLED_WaitIdle(void)
+{
+    SERCOM2_I2C_DEADLINE deadline;
+
+    SERCOM2_I2C_DeadlineStart(&deadline, OLED_FRAME_TIMEOUT_US);
+    while ((OLED_AsyncState != OLED_ASYNC_IDLE) && !SERCOM2_I2C_DeadlineReached(&deadline))
+        SERCOM2_I2C_Tasks();
+    if (OLED_AsyncState != OLED_ASYNC_IDLE)
+    {
+        /* No completion seen: take the refresh transfer off the queue (and off the
+           bus), its callback ends the refresh as failed and nothing late can follow */
+        OLED_Stats.timeouts++;
+        (void)SERCOM2_I2C_TransferCancel(OLED_I2C_EventHandler, 0);
+        OLED_AsyncFailed = true;
+        OLED_AsyncState = OLED_ASYNC_IDLE;
+    }
+    i2c_wait_with_timeout();
+}
+
+#if OLED_ADDRESSING_MODE != OLED_ADDR_PAGE
+/* Grow a window that ends on the page above down over this run when the extra clean
+   bytes cost less than a separate window (e.g. the two pages of an 8x16 field or a
+   bitmap become one window and one burst). Clean bytes are equal in both buffers. */
+static bool OLED_MergeWindow(uint8_t page, uint8_t x, uint8_t end)
+{
+    OLED_SEGMENT*   seg;
+    uint8_t         i, x0, x1;
+    uint16_t        cost;
+
+    for (i = OLED_SegCount; i > 0U; i--)
+    {
+        seg = &OLED_SegQueue[i - 1U];
+        if ((uint8_t)(seg->page + seg->pages) != page)
+            continue;
+
+        x0 = (seg->x < x) ? seg->x : x;
+        x1 = ((uint8_t)(seg->x + seg->count) > end) ? (uint8_t)(seg->x + seg->count) : end;
+        cost = (uint16_t)((uint16_t)(x1 - x0) * (uint16_t)(seg->pages + 1U)
+                        - (uint16_t)seg->count * seg->pages - (uint16_t)(end - x));
+        if (cost <= OLED_WINDOW_MERGE_COST)
+        {
+            seg->x = x0;
+            seg->count = (uint8_t)(x1 - x0);
+            seg->pages++;
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+/* Diff the back buffer against the front buffer, copy the changed spans across and
+   start streaming them in the background. The whole frame is taken in one go so the
+   panel never mixes two frames. Returns false if the previous frame is still on the
+   bus; nothing is touched then and the frame is picked up by the next call. */
+bool OLED_SwapBuffers(void)
+{
+    uint8_t page, x, end, i, slots, pending;
+
+    if (OLED_AsyncState != OLED_ASYNC_IDLE)
+    {
+        /* Lets the plib start a parked transfer or end one hung on the bus */
+        SERCOM2_I2C_Tasks();
+        OLED_Stats.swapsBusy++;
+        return false;
+    }
+    OLED_Stats.swaps++;
+
+    if (OLED_AsyncFailed)
+    {
+        /* Front already holds these bytes, only the panel missed them */
+        for (i = OLED_SegHead; i < OLED_SegCount; i++)
+        {
+            if ((OLED_SegQueue[i].pages == 0U) && (OLED_PendingCmd == 0U))
+                OLED_PendingCmd = OLED_SegQueue[i].x;
+            for (page = OLED_SegQueue[i].page; page < OLED_SegQueue[i].page + OLED_SegQueue[i].pages; page++)
+            {
+                OLED_MarkCols(page, OLED_SegQueue[i].x,
+                              (uint8_t)(OLED_SegQueue[i].x + OLED_SegQueue[i].count), true);
+                OLED_ForcePages |= (uint8_t)(1U << page);
+            }
+        }
+        OLED_AsyncFailed = false;
+    }
+
+    OLED_SegCount = 0;
+    OLED_SegHead = 0;
+    for (page = 0; page < OLED_PAGES; page++)
+    {
+        if ((OLED_DirtyPages & (1U << page)) == 0U)
+            continue;
+        if (((OLED_ForcePages & (1U << page)) == 0U) && !OLED_DiffPage(page))
+        {
+            OLED_DirtyPages &= (uint8_t)~(1U << page);
+            continue;
+        }
+
+        /* Keep one slot for every dirty page still to come; when this page runs out
+           of slots its remaining runs are sent as a single span */
+        pending = (OLED_PendingCmd != 0U) ? 1U : 0U;
+        for (i = (uint8_t)(page + 1U); i < OLED_PAGES; i++)
+            if ((OLED_DirtyPages & (1U << i)) != 0U)
+                pending++;
+        slots = (uint8_t)(OLED_SEGMENT_QUEUE_SIZE - OLED_SegCount - pending);
+
+        x = 0;
+        while (OLED_NextDirtyRun(page, &x, &end))
+        {
+            if (slots == 1U)
+                end = (uint8_t)(OLED_LastDirtyCol(page) + 1U);
+            memcpy(&OLED_FrontBuffer[page][x], &OLED_FrameBuffer[page][x], (size_t)(end - x));
+            OLED_MarkCols(page, x, end, false);
+#if OLED_ADDRESSING_MODE != OLED_ADDR_PAGE
+            if (OLED_MergeWindow(page, x, end))
+            {
+                x = end;
+                continue;
+            }
+#endif
+            OLED_SegQueue[OLED_SegCount].page = page;
+            OLED_SegQueue[OLED_SegCount].pages = 1;
+            OLED_SegQueue[OLED_SegCount].x = x;
+            OLED_SegQueue[OLED_SegCount].count = (uint8_t)(end - x);
+            OLED_SegCount++;
+            slots--;
+            x = end;
+        }
+        OLED_DirtyPages &= (uint8_t)~(1U << page);
+        OLED_ForcePages &= (uint8_t)~(1U << page);
+    }
+
+    /* Register changes tied to this frame (log scroll) go out after its data */
+    if (OLED_PendingCmd != 0U)
+    {
+        OLED_SegQueue[OLED_SegCount].page = 0;
+        OLED_SegQueue[OLED_SegCount].pages = 0;
+        OLED_SegQueue[OLED_SegCount].x = OLED_PendingCmd;
+        OLED_SegQueue[OLED_SegCount].count = 0;
+        OLED_SegCount++;
+        OLED_PendingCmd = 0;
+    }
+
+    if (OLED_SegCount != 0U)
+    {
+        OLED_AsyncState = OLED_ASYNC_ADDRESS;
+        OLED_AsyncSend();
+    }
+    return true;
+}
+
+/* Snapshot of the bus counters; the ISR only adds to them, so copying with the
+   SERCOM2 interrupt masked gives one consistent set */
+void OLED_StatsGet(OLED_STATS* stats)
+{
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    *stats = OLED_Stats;
+    NVIC_EnableIRQ(SERCOM2_IRQn);
+}
+
+void OLED_StatsClear(void)
+{
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    memset((void*)&OLED_Stats, 0, sizeof(OLED_Stats));
+    NVIC_EnableIRQ(SERCOM2_IRQn);
+}
+
+/* Blocking refresh: swap and wait until the frame is on the panel */
+void OLED_Flush(void)
+{
+    OLED_WaitIdle();
+    if (OLED_SwapBuffers())
+        OLED_WaitIdle();
+}
+
 /********************* End of LQ12864 ******************/
 
 void  OLEDWrCmd(uint8_t command)
 {
+    OLED_WaitIdle();
     OLED_Data[0] = OLED_Command_Mode;
     OLED_Data[1] = command;
-    SERCOM2_I2C_Write(OLED_ADDRESS, OLED_Data, 2);
-    i2c_wait_with_timeout();
+    OLED_TxSegs[0].data = OLED_Data;
+    OLED_TxSegs[0].size = 2;
+    if (OLED_I2CWrite(1, false))
+        OLED_I2CWait();
 }
 
 void  OLEDWrDat(uint8_t data)
 {
+    OLED_WaitIdle();
     OLED_Data[0] = OLED_Data_Mode;
     OLED_Data[1] = data;
-    SERCOM2_I2C_Write(OLED_ADDRESS, OLED_Data, 2);
-    i2c_wait_with_timeout();
+    OLED_TxSegs[0].data = OLED_Data;
+    OLED_TxSegs[0].size = 2;
+    if (OLED_I2CWrite(1, false))
+        OLED_I2CWait();
 }
 
+/* Control byte + caller's bytes in one START..STOP, sent from where they are */
+static void OLEDWrStream(uint8_t control, const uint8_t src[], uint8_t count)
+{
+    if (count == 0U)
+        return;
+    OLED_WaitIdle();
+    OLED_Data[0] = control;
+    OLED_TxSegs[0].data = OLED_Data;
+    OLED_TxSegs[0].size = 1;
+    OLED_TxSegs[1].data = (uint8_t*)src;            // only read by the plib
+    OLED_TxSegs[1].size = count;
+    if (OLED_I2CWrite(2, false))
+        OLED_I2CWait();
+}
+
+void  OLEDWrCmdList(const uint8_t cmds[], uint8_t count)
+{
+    OLEDWrStream(OLED_Command_Stream, cmds, count);
+}
+
+void  OLEDWrDatBurst(const uint8_t data[], uint8_t count)
+{
+    OLEDWrStream(OLED_Data_Mode, data, count);
+}
 
-// the most basic function, set a single pixel
-//void drawPixel(uint8_t x, uint8_t y, uint8_t color) 
-//{
-//    if ((x < 0) || (x >= 128) || (y < 0) || (y >= 64))
-//        return;
-//
-//    // x is which column
-//    if (color == WHITE) 
-//        BMP_buffer[x+ (y/8)*128] |= _BV((y%8));  
-//    else
-//        BMP_buffer[x+ (y/8)*128] &= ~_BV((y%8)); 
-//}
@@ -45,29 +45,106 @@
 #define Y_WIDTH         64
 #define OLED_Command_Mode         0x80  // SSD1360
 #define OLED_Data_Mode		    0x40  // SSD1306
+#define OLED_Command_Stream       0x00  // Co=0, D/C#=0: every following byte is a command
 // #define _BV(x) (1 << x)    
 #define BLACK   0
 #define WHITE   1
+#define INVERSE 2
 #define swap(a, b) { uint8_t t = a; a = b; b = t; }
 
+// Frame buffer: RAM shadow of the SSD1306 GDDRAM, page-major (8 pages x 128 columns),
+// each byte holds 8 vertical pixels with bit 0 at the top of the page.
+#define OLED_PAGES                8
+#define OLED_COLUMNS              128
+#define OLED_FLUSH_MERGE_GAP      6     // clean columns bridged inside one run rather than re-addressing
+#define OLED_SEGMENT_QUEUE_SIZE   16    // dirty runs queued per swap, at least OLED_PAGES
+
+// GDDRAM addressing mode (command 0x20). Page mode re-addresses every page run;
+// horizontal/vertical mode sets a 0x21/0x22 window once and streams the whole region.
+#define OLED_ADDR_HORIZONTAL      0x00
+#define OLED_ADDR_VERTICAL        0x01
+#define OLED_ADDR_PAGE            0x02
+#ifndef OLED_ADDRESSING_MODE
+#define OLED_ADDRESSING_MODE      OLED_ADDR_HORIZONTAL
+#endif
+#define OLED_WINDOW_MERGE_COST    16    // clean bytes worth sending to save one window setup
+
+extern uint8_t OLED_FrameBuffer[OLED_PAGES][OLED_COLUMNS];
+
 // I2C2_MESSAGE_STATUS I2C_status;
 // i2c2_status_t I2C_status;
 
 // OLED
 void  OLEDWrCmd(uint8_t command);
 void  OLEDWrDat(uint8_t data);
+void  OLEDWrCmdList(const uint8_t cmds[], uint8_t count);
+void  OLEDWrDatBurst(const uint8_t data[], uint8_t count);
 void  OLED_Init();
 void displayOn(void);
 void displayOff(void);
 void drawPixel(uint8_t x, uint8_t y, uint8_t color);
 void OLED_CLS(void);
 void OLED_Set_Pos(uint8_t x, uint8_t y);
+void OLED_SetWindow(uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1);
 void OLED_Put6x8Str(uint8_t x, uint8_t y, const uint8_t ch[]);
 void OLED_Put8x16Str(uint8_t x, uint8_t y, const uint8_t ch[]);
 void OLED_Put8x16ASCII(uint8_t x, uint8_t y, uint8_t no, uint8_t data[]);
 void OLED_Put16x16Ch(uint8_t x, uint8_t y, uint8_t index);
 void Draw_BMP(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t BMP[]);
 
+// Text: x 0~127, y page 0~7; font is one of OLED_FONT_*, optionally | OLED_TEXT_INVERSE
+#define OLED_FONT_6X8             0x00  // Font6x8
+#define OLED_FONT_6X16            0x01  // Font6x8 at double height
+#define OLED_FONT_8X16            0x02  // Font8x16
+#define OLED_FONT_SEG7            0x03  // 8x16 7-segment numerals: '0'~'9', ' ', '-'
+#define OLED_TEXT_INVERSE         0x80
+void OLED_PutStr(uint8_t x, uint8_t y, const uint8_t s[], uint8_t font);
+void OLED_PutText(uint8_t x, uint8_t y, const uint8_t s[], uint8_t len, uint8_t font);
+
+// Hardware scroll: start/end are pages 0~7, interval is the datasheet frame interval code
+void OLED_SetStartLine(uint8_t line);
+void OLED_SetDisplayOffset(uint8_t rows);
+void OLED_ScrollHorizontal(bool left, uint8_t start, uint8_t end, uint8_t interval);
+void OLED_ScrollDiagonal(bool left, uint8_t start, uint8_t end, uint8_t interval, uint8_t offset);
+void OLED_ScrollStop(void);
+
+// Scrolling text log on pages first~7, scrolled by the panel's start line
+void OLED_LogInit(uint8_t first);
+void OLED_LogLine(const uint8_t s[]);
+void OLED_LogStop(void);
+
+// Graphics: x 0~127, y 0~63 in pixels; color is BLACK, WHITE or INVERSE
+void OLED_DrawHLine(uint8_t x, uint8_t y, uint8_t w, uint8_t color);
+void OLED_DrawVLine(uint8_t x, uint8_t y, uint8_t h, uint8_t color);
+void OLED_DrawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t color);
+void OLED_DrawRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t color);
+void OLED_FillRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t color);
+void OLED_DrawBar(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t level, uint16_t max);
+void OLED_DrawArc(uint8_t cx, uint8_t cy, uint8_t r, uint8_t octants, uint8_t color);
+void OLED_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t bmp[], uint8_t color);
+
+// Frame buffer: drawing calls above only touch the back buffer, OLED_SwapBuffers() diffs it
+// against the front buffer and streams the changes in the background; OLED_Flush() waits for it
+void OLED_FB_Write(uint8_t x, uint8_t page, uint8_t data);
+void OLED_Invalidate(void);
+bool OLED_IsDirty(void);
+void OLED_Flush(void);
+bool OLED_SwapBuffers(void);
+bool OLED_IsBusy(void);
+
+// Bus traffic counters since reset or OLED_StatsClear(), all wrapping
+typedef struct
+{
+    uint32_t    transactions;   // I2C writes issued to the panel
+    uint32_t    bytes;          // control + payload bytes of those writes
+    uint32_t    naks;           // writes refused by the plib or ended by NAK / bus error
+    uint32_t    timeouts;       // waits that gave up on the bus (OLED not answering)
+    uint32_t    swaps;          // frames handed to the background refresh
+    uint32_t    swapsBusy;      // swaps skipped because the previous frame was still on the bus
+} OLED_STATS;
+void OLED_StatsGet(OLED_STATS* stats);
+void OLED_StatsClear(void);
+
 // ELOAD
 //void CurrentSet(void);
 //void Read_IVT(void);
@@ -332,6 +332,48 @@ const unsigned char Font8x16[][16] = {
     {0x00,0x02,0x02,0x7C,0x80,0x00,0x00,0x00,0x00,0x40,0x40,0x3F,0x00,0x00,0x00,0x00},//} 93
     {0x00,0x06,0x01,0x01,0x02,0x02,0x04,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},//~ 94
 };
+
+/****** Font variants, generated at compile time ******/
+
+/* Double-height 6x16 from Font6x8: each source nibble becomes one byte with every
+   row doubled, low nibble for the upper page, high nibble for the lower page */
+#define STRETCH4(n)     ((((n) & 1) ? 0x03 : 0) | (((n) & 2) ? 0x0C : 0) | \
+                         (((n) & 4) ? 0x30 : 0) | (((n) & 8) ? 0xC0 : 0))
+const unsigned char FontStretch4[16] = {
+    STRETCH4(0),  STRETCH4(1),  STRETCH4(2),  STRETCH4(3),
+    STRETCH4(4),  STRETCH4(5),  STRETCH4(6),  STRETCH4(7),
+    STRETCH4(8),  STRETCH4(9),  STRETCH4(10), STRETCH4(11),
+    STRETCH4(12), STRETCH4(13), STRETCH4(14), STRETCH4(15),
+};
+
+/* 8x16 7-segment numerals, same layout as Font8x16 (8 upper then 8 lower bytes).
+   Segments: a top, b upper right, c lower right, d bottom, e lower left, f upper left, g middle */
+#define SEG_A   0x01
+#define SEG_B   0x02
+#define SEG_C   0x04
+#define SEG_D   0x08
+#define SEG_E   0x10
+#define SEG_F   0x20
+#define SEG_G   0x40
+#define SEG7_UP(s)      ((((s) & SEG_A) ? 0x03 : 0) | (((s) & SEG_G) ? 0x80 : 0))
+#define SEG7_LO(s)      ((((s) & SEG_G) ? 0x01 : 0) | (((s) & SEG_D) ? 0xC0 : 0))
+#define SEG7_GLYPH(s)   { 0x00, ((s) & SEG_F) ? 0x7C : 0, SEG7_UP(s), SEG7_UP(s), SEG7_UP(s), SEG7_UP(s), ((s) & SEG_B) ? 0x7C : 0, 0x00, \
+                          0x00, ((s) & SEG_E) ? 0x3E : 0, SEG7_LO(s), SEG7_LO(s), SEG7_LO(s), SEG7_LO(s), ((s) & SEG_C) ? 0x3E : 0, 0x00 }
+
+const unsigned char FontSeg7[][16] = {      // FontSeg7[x][16], x = ASCII_Code - '0', then ' ' and '-'
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F),          // 0
+    SEG7_GLYPH(SEG_B | SEG_C),                                          // 1
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_D | SEG_E | SEG_G),                  // 2
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_C | SEG_D | SEG_G),                  // 3
+    SEG7_GLYPH(SEG_B | SEG_C | SEG_F | SEG_G),                          // 4
+    SEG7_GLYPH(SEG_A | SEG_C | SEG_D | SEG_F | SEG_G),                  // 5
+    SEG7_GLYPH(SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G),          // 6
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_C),                                  // 7
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G),  // 8
+    SEG7_GLYPH(SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G),          // 9
+    SEG7_GLYPH(0),                                                      // space
+    SEG7_GLYPH(SEG_G),                                                  // -
+};
 /****** End of ASCII font ******/
 
 /****** 16*16 font for Chinese character ******/
@@ -0,0 +1,300 @@
+/*
+ * File:   SLCAN.c
+ * Comments: SLCAN (Lawicel) command parser and frame output, see SLCAN.h.
+ *           Included by main.c like the terminal; compiles on its own too.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "FORMAT.h"
+#include "SLCAN.h"
+
+#define SLCAN_OK        '\r'
+#define SLCAN_BELL      '\a'
+#define SLCAN_ESC       0x1BU
+
+static SLCAN_WRITE      SLCAN_Out;
+static SLCAN_ROOM       SLCAN_Free;
+static SLCAN_KEY        SLCAN_Key;
+static char             SLCAN_Line[SLCAN_LINE_MAX];
+static uint8_t          SLCAN_Len;
+static bool             SLCAN_Overflow;
+static volatile bool    SLCAN_Active, SLCAN_Open, SLCAN_ListenOnly, SLCAN_Timestamps;
+static SLCAN_STATS      SLCAN_Stats;
+
+static void SLCAN_Write(const char* s, size_t n)
+{
+    if (SLCAN_Out != NULL)
+        (void)SLCAN_Out(s, n);
+}
+
+static void SLCAN_Reply(char c)
+{
+    SLCAN_Write(&c, 1);
+    if (c == SLCAN_BELL)
+        SLCAN_Stats.errors++;
+    else
+        SLCAN_Stats.commands++;
+}
+
+/* digits hex characters at p into value; false on anything else */
+static bool SLCAN_ParseHex(const char* p, uint8_t digits, uint32_t* value)
+{
+    uint32_t    v = 0;
+    char        c;
+
+    while (digits-- > 0U) {
+        c = *p++;
+        if ((c >= '0') && (c <= '9'))
+            v = (v << 4) | (uint32_t)(c - '0');
+        else if ((c >= 'A') && (c <= 'F'))
+            v = (v << 4) | (uint32_t)(c - 'A' + 10);
+        else if ((c >= 'a') && (c <= 'f'))
+            v = (v << 4) | (uint32_t)(c - 'a' + 10);
+        else
+            return false;
+    }
+    *value = v;
+    return true;
+}
+
+/* t/T/r/R from the host: checked and acknowledged, the simulation has no
+   receiver for it */
+static char SLCAN_Transmit(void)
+{
+    bool        ext = (SLCAN_Line[0] == 'T') || (SLCAN_Line[0] == 'R');
+    bool        rtr = (SLCAN_Line[0] == 'r') || (SLCAN_Line[0] == 'R');
+    uint8_t     idLen = ext ? 8U : 3U;
+    uint32_t    id, dlc, byte;
+    uint8_t     i;
+
+    if (!SLCAN_Open || SLCAN_ListenOnly || (SLCAN_Len < (idLen + 2U)))
+        return SLCAN_BELL;
+    if (!SLCAN_ParseHex(&SLCAN_Line[1], idLen, &id) || (id > (ext ? 0x1FFFFFFFUL : 0x7FFUL)))
+        return SLCAN_BELL;
+    if (!SLCAN_ParseHex(&SLCAN_Line[1U + idLen], 1, &dlc) || (dlc > 8U))
+        return SLCAN_BELL;
+    if (SLCAN_Len != (2U + idLen + (rtr ? 0U : 2U * dlc)))
+        return SLCAN_BELL;
+    for (i = 0; !rtr && (i < dlc); i++) {
+        if (!SLCAN_ParseHex(&SLCAN_Line[2U + idLen + 2U * i], 2, &byte))
+            return SLCAN_BELL;
+    }
+    SLCAN_Stats.received++;
+    SLCAN_Write(ext ? "Z" : "z", 1);
+    return SLCAN_OK;
+}
+
+/* Can line[0..len) start (complete: be) a command that makes the interface active:
+   Sn, sxxyy, O, L, V or N. Nothing else is taken away from the console. */
+static bool SLCAN_Opening(const char* line, uint8_t len, bool complete)
+{
+    uint32_t    v;
+
+    switch (line[0]) {
+    case 'S':
+        return (len == 2U) ? ((line[1] >= '0') && (line[1] <= '8')) : ((len == 1U) && !complete);
+    case 's':
+        return (len <= 5U) && SLCAN_ParseHex(&line[1], (uint8_t)(len - 1U), &v) && (!complete || (len == 5U));
+    case 'O':
+    case 'L':
+    case 'V':
+    case 'N':
+        return (len == 1U);
+    default:
+        return false;
+    }
+}
+
+/* Bytes held as a possible opening command turned out to be console keys */
+static void SLCAN_Release(void)
+{
+    uint8_t     i;
+
+    for (i = 0; i < SLCAN_Len; i++) {
+        if (SLCAN_Key != NULL)
+            SLCAN_Key((uint8_t)SLCAN_Line[i]);
+    }
+    SLCAN_Len = 0;
+}
+
+static char SLCAN_Command(void)
+{
+    uint32_t    v;
+
+    switch (SLCAN_Line[0]) {
+    case 'S':
+        /* The simulated bus has no bit rate, any valid one is fine */
+        return (!SLCAN_Open && (SLCAN_Len == 2U) && (SLCAN_Line[1] >= '0') && (SLCAN_Line[1] <= '8'))
+             ? SLCAN_OK : SLCAN_BELL;
+    case 's':
+        return (!SLCAN_Open && (SLCAN_Len == 5U) && SLCAN_ParseHex(&SLCAN_Line[1], 4, &v))
+             ? SLCAN_OK : SLCAN_BELL;
+    case 'O':
+    case 'L':
+        if (SLCAN_Open || (SLCAN_Len != 1U))
+            return SLCAN_BELL;
+        SLCAN_ListenOnly = (SLCAN_Line[0] == 'L');
+        SLCAN_Open = true;
+        return SLCAN_OK;
+    case 'C':
+        /* Also when closed: tools close first to get a known state */
+        if (SLCAN_Len != 1U)
+            return SLCAN_BELL;
+        SLCAN_Open = false;
+        return SLCAN_OK;
+    case 'Z':
+        if ((SLCAN_Len != 2U) || ((SLCAN_Line[1] != '0') && (SLCAN_Line[1] != '1')))
+            return SLCAN_BELL;
+        SLCAN_Timestamps = (SLCAN_Line[1] == '1');
+        return SLCAN_OK;
+    case 'M':
+    case 'm':
+        return ((SLCAN_Len == 9U) && SLCAN_ParseHex(&SLCAN_Line[1], 8, &v)) ? SLCAN_OK : SLCAN_BELL;
+    case 'X':
+        return ((SLCAN_Len == 2U) && SLCAN_ParseHex(&SLCAN_Line[1], 1, &v)) ? SLCAN_OK : SLCAN_BELL;
+    case 'V':
+        SLCAN_Write("V1013", 5);
+        return SLCAN_OK;
+    case 'N':
+        SLCAN_Write("N0001", 5);
+        return SLCAN_OK;
+    case 'F':
+        if (!SLCAN_Open)
+            return SLCAN_BELL;
+        SLCAN_Write("F00", 3);
+        return SLCAN_OK;
+    case 't':
+    case 'T':
+    case 'r':
+    case 'R':
+        return SLCAN_Transmit();
+    default:
+        return SLCAN_BELL;
+    }
+}
+
+void SLCAN_Init(SLCAN_WRITE write, SLCAN_ROOM room, SLCAN_KEY key)
+{
+    SLCAN_Out = write;
+    SLCAN_Free = room;
+    SLCAN_Key = key;
+    SLCAN_Len = 0;
+    SLCAN_Overflow = false;
+    SLCAN_Active = false;
+    SLCAN_Open = false;
+    SLCAN_Timestamps = false;
+    SLCAN_StatsClear();
+}
+
+void SLCAN_Input(uint8_t c)
+{
+    char    reply;
+
+    if (!SLCAN_Active) {
+        /* Hold bytes while they can still be an opening command, run it on its CR
+           and hand everything else back as console keys, in order */
+        if ((c != '\r') || (SLCAN_Len == 0U) || !SLCAN_Opening(SLCAN_Line, SLCAN_Len, true)) {
+            SLCAN_Line[SLCAN_Len] = (char)c;
+            if ((c != '\r') && SLCAN_Opening(SLCAN_Line, (uint8_t)(SLCAN_Len + 1U), false)) {
+                SLCAN_Len++;
+                return;
+            }
+            SLCAN_Release();
+            SLCAN_Line[0] = (char)c;
+            if ((c != '\r') && SLCAN_Opening(SLCAN_Line, 1, false))
+                SLCAN_Len = 1;
+            else if (SLCAN_Key != NULL)
+                SLCAN_Key(c);
+            return;
+        }
+    } else if (c == SLCAN_ESC) {
+        /* Leave: close and hand the console back */
+        SLCAN_Active = false;
+        SLCAN_Open = false;
+        SLCAN_Len = 0;
+        SLCAN_Overflow = false;
+        return;
+    } else if (c == '\n') {
+        return;
+    } else if (c != '\r') {
+        if (SLCAN_Len < sizeof(SLCAN_Line))
+            SLCAN_Line[SLCAN_Len++] = (char)c;
+        else
+            SLCAN_Overflow = true;
+        return;
+    }
+
+    /* End of a command. An empty line (tools send a few to flush) gets no reply. */
+    if (SLCAN_Overflow) {
+        reply = SLCAN_BELL;
+    } else if (SLCAN_Len == 0U) {
+        return;
+    } else {
+        reply = SLCAN_Command();
+        if (reply == SLCAN_OK)
+            SLCAN_Active = true;
+    }
+    SLCAN_Len = 0;
+    SLCAN_Overflow = false;
+    SLCAN_Reply(reply);
+}
+
+void SLCAN_Idle(void)
+{
+    if (!SLCAN_Active)
+        SLCAN_Release();
+}
+
+bool SLCAN_IsActive(void)
+{
+    return SLCAN_Active;
+}
+
+bool SLCAN_IsOpen(void)
+{
+    return SLCAN_Open;
+}
+
+bool SLCAN_Frame(uint32_t id, uint8_t dlc, const uint8_t* data, uint32_t ms)
+{
+    char        buf[1U + 8U + 1U + 16U + 4U + 1U];
+    char*       p = buf;
+    bool        ext = (id > 0x7FFUL);
+    uint8_t     i;
+    size_t      len;
+
+    if (!SLCAN_Open || (SLCAN_Out == NULL))
+        return false;
+    if (dlc > 8U)
+        dlc = 8U;
+
+    *p++ = ext ? 'T' : 't';
+    p += FMT_Hex(p, id, ext ? 8U : 3U);
+    p += FMT_Hex(p, dlc, 1);
+    for (i = 0; i < dlc; i++)
+        p += FMT_Hex(p, data[i], 2);
+    if (SLCAN_Timestamps)
+        p += FMT_Hex(p, ms % 60000UL, 4);
+    *p++ = '\r';
+    len = (size_t)(p - buf);
+
+    if ((SLCAN_Free != NULL) && (SLCAN_Free() < len)) {
+        SLCAN_Stats.dropped++;
+        return false;
+    }
+    SLCAN_Write(buf, len);
+    SLCAN_Stats.frames++;
+    return true;
+}
+
+void SLCAN_StatsGet(SLCAN_STATS* stats)
+{
+    *stats = SLCAN_Stats;
+}
+
+void SLCAN_StatsClear(void)
+{
+    memset(&SLCAN_Stats, 0, sizeof(SLCAN_Stats));
+}
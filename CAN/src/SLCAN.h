@@ -0,0 +1,70 @@
+/*
+ * File:   SLCAN.h
+ * Comments: SLCAN (Lawicel CANUSB) ASCII protocol on the UART console, so
+ *           slcand + candump or python-can see the simulated bus as a CAN
+ *           adapter. Commands are lines ending in CR:
+ *
+ *             Sn           bit rate 0..8 (10k..1M), only while closed
+ *             sxxyy        BTR0/BTR1, accepted and ignored
+ *             O / L        open / open listen-only
+ *             C            close
+ *             Zn           timestamps off/on
+ *             tiiildd..    11-bit frame to the bus ("z" reply), rii l: remote
+ *             Tiiiiiiiildd..  29-bit frame ("Z" reply), Riiiiiiiil: remote
+ *             V / N / F    version, serial number, status flags
+ *             Mxxxxxxxx / mxxxxxxxx / Xn   accepted and ignored
+ *
+ *           A command is answered with CR, or BEL when it is refused. While the
+ *           channel is open every simulated frame goes out as tiiildd.. or
+ *           Tiiiiiiiildd.., followed by a 4-digit hex timestamp in ms (0..59999)
+ *           when Z1 is on.
+ *
+ *           A complete opening command (Sn, sxxyy, O, L, V or N and its CR)
+ *           makes the interface active: from then on every received byte is
+ *           SLCAN, until ESC. Before that bytes are only held while they can
+ *           still become such a line; any other line, or a held one that stops
+ *           short (see SLCAN_Idle()), goes back to the caller as console keys,
+ *           upper case included.
+ */
+
+#ifndef SLCAN_H
+#define SLCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SLCAN_LINE_MAX          32U         // longest command: T, 8 + 1 + 16 digits
+
+// Where replies and frames go and how much room there is. Replies are written
+// from SLCAN_Input(), i.e. the receive interrupt on the board: every other writer
+// to the same port must keep that interrupt out while it writes.
+typedef size_t (*SLCAN_WRITE)(const void* buffer, size_t size);
+typedef size_t (*SLCAN_ROOM)(void);
+// Console keys: received bytes that are not SLCAN, in order, from SLCAN_Input()
+// or SLCAN_Idle()
+typedef void (*SLCAN_KEY)(uint8_t c);
+
+typedef struct
+{
+    uint32_t    frames;         // sent to the host
+    uint32_t    dropped;        // not enough room in the write ring
+    uint32_t    received;       // t/T/r/R from the host, acknowledged
+    uint32_t    commands;       // accepted
+    uint32_t    errors;         // refused with BEL
+} SLCAN_STATS;
+
+void SLCAN_Init(SLCAN_WRITE write, SLCAN_ROOM room, SLCAN_KEY key);
+// One received byte: SLCAN, held, or passed on to the key function
+void SLCAN_Input(uint8_t c);
+// Nothing received for a while: bytes held as a possible opening command are
+// console keys after all. Not to be called concurrently with SLCAN_Input().
+void SLCAN_Idle(void);
+bool SLCAN_IsActive(void);
+bool SLCAN_IsOpen(void);
+// A frame on the simulated bus; whole or not at all, false when closed or no room
+bool SLCAN_Frame(uint32_t id, uint8_t dlc, const uint8_t* data, uint32_t ms);
+void SLCAN_StatsGet(SLCAN_STATS* stats);
+void SLCAN_StatsClear(void);
+
+#endif /* SLCAN_H */
@@ -0,0 +1,188 @@
+/*
+ * File:   TELEMETRY.c
+ * Comments: COBS-framed binary records for the UART console, see TELEMETRY.h.
+ *           Included by main.c like the terminal; the host decoder and tests
+ *           compile it on its own.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "TELEMETRY.h"
+
+static TELEM_WRITE  TELEM_Out;
+static TELEM_ROOM   TELEM_Free;
+static uint8_t      TELEM_Seq;
+static TELEM_STATS  TELEM_Stats;
+
+void TELEM_Init(TELEM_WRITE write, TELEM_ROOM room)
+{
+    TELEM_Out = write;
+    TELEM_Free = room;
+    TELEM_Seq = 0;
+    TELEM_StatsClear();
+}
+
+/* CRC-16/CCITT-FALSE: polynomial 0x1021, initial 0xFFFF, a nibble at a time */
+uint16_t TELEM_Crc16(const uint8_t* data, size_t len)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    uint16_t    crc = 0xFFFFU;
+
+    while (len-- > 0U) {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (*data >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (*data & 0x0FU)]);
+        data++;
+    }
+    return crc;
+}
+
+/* Each 0x00 becomes the distance to the next one; a code byte of 0xFF is a run
+   of 254 bytes with no zero after it */
+size_t TELEM_CobsEncode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t  code = 0, n = 1, i;
+
+    out[0] = 1;
+    for (i = 0; i < len; i++) {
+        if (in[i] == 0U) {
+            code = n++;
+            out[code] = 1;
+        } else {
+            out[n++] = in[i];
+            if (++out[code] == 0xFFU) {
+                code = n++;
+                out[code] = 1;
+            }
+        }
+    }
+    return n;
+}
+
+size_t TELEM_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t max)
+{
+    size_t  i = 0, n = 0;
+    uint8_t code, k;
+
+    while (i < len) {
+        code = in[i++];
+        if ((code == 0U) || ((i + code - 1U) > len) || ((n + code - 1U) > max))
+            return 0;
+        for (k = 1; k < code; k++) {
+            if (in[i] == 0U)
+                return 0;
+            out[n++] = in[i++];
+        }
+        if ((code != 0xFFU) && (i < len)) {
+            if (n >= max)
+                return 0;
+            out[n++] = 0;
+        }
+    }
+    return n;
+}
+
+size_t TELEM_Encode(const TELEM_CAN_RECORD* record, uint8_t* frame)
+{
+    uint8_t     buf[TELEM_RECORD_MAX];
+    size_t      n = 0, len;
+    uint16_t    crc;
+    uint8_t     dlc = (record->dlc > 8U) ? 8U : record->dlc;
+
+    buf[n++] = TELEM_TYPE_CAN;
+    buf[n++] = record->seq;
+    buf[n++] = (uint8_t)record->time;
+    buf[n++] = (uint8_t)(record->time >> 8);
+    buf[n++] = (uint8_t)(record->time >> 16);
+    buf[n++] = (uint8_t)(record->time >> 24);
+    buf[n++] = (uint8_t)record->id;
+    buf[n++] = (uint8_t)(record->id >> 8);
+    buf[n++] = dlc;
+    memcpy(&buf[n], record->data, dlc);
+    n += dlc;
+    buf[n++] = (uint8_t)record->crc15;
+    buf[n++] = (uint8_t)(record->crc15 >> 8);
+    buf[n++] = (uint8_t)record->rpm;
+    buf[n++] = (uint8_t)(record->rpm >> 8);
+    buf[n++] = record->speed;
+    buf[n++] = record->throttle;
+    buf[n++] = record->flags;
+    crc = TELEM_Crc16(buf, n);
+    buf[n++] = (uint8_t)crc;
+    buf[n++] = (uint8_t)(crc >> 8);
+
+    len = TELEM_CobsEncode(buf, n, frame);
+    frame[len++] = 0;
+    return len;
+}
+
+bool TELEM_Decode(const uint8_t* frame, size_t len, TELEM_CAN_RECORD* record)
+{
+    uint8_t     buf[TELEM_RECORD_MAX];
+    size_t      n = TELEM_CobsDecode(frame, len, buf, sizeof(buf));
+    const uint8_t* p;
+
+    if ((n < TELEM_RECORD_MIN) || (buf[0] != TELEM_TYPE_CAN) || (buf[8] > 8U)
+            || (n != (TELEM_RECORD_MIN + buf[8])))
+        return false;
+    if (TELEM_Crc16(buf, n - 2U) != (uint16_t)(buf[n - 2U] | (buf[n - 1U] << 8)))
+        return false;
+
+    record->seq = buf[1];
+    record->time = (uint32_t)buf[2] | ((uint32_t)buf[3] << 8)
+                 | ((uint32_t)buf[4] << 16) | ((uint32_t)buf[5] << 24);
+    record->id = (uint16_t)(buf[6] | (buf[7] << 8));
+    record->dlc = buf[8];
+    memcpy(record->data, &buf[9], record->dlc);
+    p = &buf[9U + record->dlc];
+    record->crc15 = (uint16_t)(p[0] | (p[1] << 8));
+    record->rpm = (uint16_t)(p[2] | (p[3] << 8));
+    record->speed = p[4];
+    record->throttle = p[5];
+    record->flags = p[6];
+    return true;
+}
+
+void TELEM_Start(void)
+{
+    static const uint8_t delimiter = 0;
+
+    if (TELEM_Out != NULL) {
+        (void)TELEM_Out(&delimiter, 1);
+        TELEM_Stats.bytes++;
+    }
+}
+
+bool TELEM_SendCan(TELEM_CAN_RECORD* record, bool wait)
+{
+    uint8_t frame[TELEM_FRAME_MAX];
+    size_t  len;
+
+    if (TELEM_Out == NULL)
+        return false;
+    record->seq = TELEM_Seq++;
+    len = TELEM_Encode(record, frame);
+    while ((TELEM_Free != NULL) && (TELEM_Free() < len)) {
+        if (!wait) {
+            TELEM_Stats.dropped++;
+            return false;
+        }
+    }
+    (void)TELEM_Out(frame, len);
+    TELEM_Stats.records++;
+    TELEM_Stats.bytes += len;
+    return true;
+}
+
+void TELEM_StatsGet(TELEM_STATS* stats)
+{
+    *stats = TELEM_Stats;
+}
+
+void TELEM_StatsClear(void)
+{
+    memset(&TELEM_Stats, 0, sizeof(TELEM_Stats));
+}
@@ -0,0 +1,93 @@
+/*
+ * File:   TELEMETRY.h
+ * Comments: Binary telemetry stream for the UART console. Every CAN frame the
+ *           simulation transmits becomes one record: timestamp, ID, DLC,
+ *           payload, CRC-15 and the vehicle state, protected by a CRC-16 and
+ *           COBS-framed, so a record never contains 0x00 and every 0x00 on the
+ *           wire ends one. A reader that starts mid-stream, or after a dropped
+ *           byte, loses at most the record it is in.
+ *
+ *           Record, little-endian, before COBS:
+ *
+ *             0   type        TELEM_TYPE_CAN
+ *             1   seq         +1 per record sent, gaps are dropped records
+ *             2   time        u32, microseconds since start-up
+ *             6   id          u16, 11-bit identifier
+ *             8   dlc         0..8
+ *             9   data        dlc bytes
+ *             +0  crc15       u16, the frame's CAN CRC
+ *             +2  rpm         u16
+ *             +4  speed       km/h
+ *             +5  throttle    %
+ *             +6  flags       TELEM_FLAG_*
+ *             +7  crc16       u16, CRC-16/CCITT-FALSE of everything before it
+ *
+ *           A 2-byte frame is 20 bytes, 22 on the wire: about 520 records/s at
+ *           115200 baud, 2000/s at 460800. The same file decodes on the host,
+ *           see CAN/test/telemetry_decode.c.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TELEM_TYPE_CAN          0x01U
+
+#define TELEM_FLAG_BRAKE        0x01U
+#define TELEM_FLAG_MANUAL       0x02U
+#define TELEM_FLAG_SW1          0x04U
+#define TELEM_FLAG_SW2          0x08U
+
+#define TELEM_RECORD_MIN        18U                         // dlc 0
+#define TELEM_RECORD_MAX        (TELEM_RECORD_MIN + 8U)
+#define TELEM_FRAME_MAX         (TELEM_RECORD_MAX + 2U)     // COBS code byte and 0x00
+
+// Where the frames go and how much room there is, SERCOM0_USART_Write() and
+// SERCOM0_USART_WriteFreeBufferCountGet() on the board
+typedef size_t (*TELEM_WRITE)(const void* buffer, size_t size);
+typedef size_t (*TELEM_ROOM)(void);
+
+typedef struct
+{
+    uint8_t     seq;            // set by TELEM_SendCan()
+    uint32_t    time;
+    uint16_t    id;
+    uint8_t     dlc;
+    uint8_t     data[8];
+    uint16_t    crc15;
+    uint16_t    rpm;
+    uint8_t     speed;
+    uint8_t     throttle;
+    uint8_t     flags;
+} TELEM_CAN_RECORD;
+
+typedef struct
+{
+    uint32_t    records;        // sent
+    uint32_t    bytes;          // on the wire, delimiters included
+    uint32_t    dropped;        // not enough room in the write ring
+} TELEM_STATS;
+
+void TELEM_Init(TELEM_WRITE write, TELEM_ROOM room);
+// A lone 0x00 that ends whatever text came before the first record
+void TELEM_Start(void);
+// Whole record or nothing: with wait false a record that does not fit is dropped
+// (and its seq skipped), with wait true this spins until the ring has room
+bool TELEM_SendCan(TELEM_CAN_RECORD* record, bool wait);
+void TELEM_StatsGet(TELEM_STATS* stats);
+void TELEM_StatsClear(void);
+
+// Record -> frame with the trailing 0x00, returns its length (<= TELEM_FRAME_MAX)
+size_t TELEM_Encode(const TELEM_CAN_RECORD* record, uint8_t* frame);
+// One frame without the 0x00 -> record; false for bad COBS, length, type or CRC
+bool TELEM_Decode(const uint8_t* frame, size_t len, TELEM_CAN_RECORD* record);
+
+uint16_t TELEM_Crc16(const uint8_t* data, size_t len);
+size_t TELEM_CobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+// 0 for malformed input or more than max bytes of output
+size_t TELEM_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t max);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,138 @@
+/*
+ * File:   TERMINAL.c
+ * Comments: Differential ANSI screen for the UART console, see TERMINAL.h.
+ *           Included by main.c like the OLED driver; compiles on its own too.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "FORMAT.h"
+#include "TERMINAL.h"
+
+static TERM_WRITE   TERM_Out;
+static uint8_t      TERM_Screen = 1;        // fields drawn on another screen are redrawn
+static uint8_t      TERM_Row, TERM_Col;     // cursor position, row 0 = unknown
+static uint32_t     TERM_Bytes;
+
+static void TERM_Write(const char* s, size_t n)
+{
+    if ((TERM_Out != NULL) && (n != 0U)) {
+        (void)TERM_Out(s, n);
+        TERM_Bytes += n;
+    }
+}
+
+/* Cursor to row/col: nothing if it is already there, ESC [ col G on the same row,
+   ESC [ row ; col H otherwise */
+static void TERM_Goto(uint8_t row, uint8_t col)
+{
+    char    buf[12];
+    size_t  n = 0;
+
+    if ((row == TERM_Row) && (col == TERM_Col))
+        return;
+    buf[n++] = '\033';
+    buf[n++] = '[';
+    if (row != TERM_Row) {
+        n += FMT_UInt(&buf[n], row);
+        buf[n++] = ';';
+        n += FMT_UInt(&buf[n], col);
+        buf[n++] = 'H';
+    } else {
+        n += FMT_UInt(&buf[n], col);
+        buf[n++] = 'G';
+    }
+    TERM_Write(buf, n);
+    TERM_Row = row;
+    TERM_Col = col;
+}
+
+void TERM_Init(TERM_WRITE write)
+{
+    TERM_Out = write;
+    TERM_Row = 0;
+    TERM_Bytes = 0;
+}
+
+void TERM_Clear(void)
+{
+    static const char clear[] = "\033[?25l\033[2J\033[H";
+
+    TERM_Write(clear, sizeof(clear) - 1U);
+    TERM_Row = 1;
+    TERM_Col = 1;
+    if (++TERM_Screen == 0U)
+        TERM_Screen = 1;
+}
+
+void TERM_Text(uint8_t row, uint8_t col, const char* text)
+{
+    size_t  len = strlen(text);
+
+    TERM_Goto(row, col);
+    TERM_Write(text, len);
+    TERM_Col = (uint8_t)(TERM_Col + len);
+}
+
+void TERM_MoveTo(uint8_t row, uint8_t col)
+{
+    TERM_Goto(row, col);
+    TERM_Row = 0;                           // the caller prints from here
+}
+
+void TERM_ClearFrom(uint8_t row)
+{
+    TERM_MoveTo(row, 1);
+    TERM_Write("\033[J", 3);
+}
+
+void TERM_FieldText(TERM_FIELD* field, const char* text)
+{
+    bool    all = field->screen != TERM_Screen;
+    size_t  len = strlen(text);
+    uint8_t first = field->width, last = 0;
+    uint8_t i;
+    char    c;
+
+    /* Update the shadow, noting the first and last column that changed */
+    for (i = 0; i < field->width; i++) {
+        c = (i < len) ? text[i] : ' ';
+        if (all || (field->shown[i] != c)) {
+            if (first == field->width)
+                first = i;
+            last = i;
+            field->shown[i] = c;
+        }
+    }
+    field->screen = TERM_Screen;
+    if (first == field->width)
+        return;
+
+    TERM_Goto(field->row, (uint8_t)(field->col + first));
+    TERM_Write(&field->shown[first], (size_t)(last - first) + 1U);
+    TERM_Col = (uint8_t)(TERM_Col + (last - first) + 1U);
+}
+
+void TERM_FieldInt(TERM_FIELD* field, int32_t value)
+{
+    char    buf[12];
+
+    (void)FMT_Int(buf, value);
+    TERM_FieldText(field, buf);
+}
+
+void TERM_FieldHex(TERM_FIELD* field, uint16_t value, uint8_t digits)
+{
+    char    buf[7];
+
+    if (digits > 4U)
+        digits = 4U;
+    (void)FMT_Hex(&buf[FMT_Str(buf, "0x")], value, digits);
+    TERM_FieldText(field, buf);
+}
+
+uint32_t TERM_BytesGet(void)
+{
+    return TERM_Bytes;
+}
@@ -0,0 +1,59 @@
+/*
+ * File:   TERMINAL.h
+ * Comments: Differential ANSI (VT100) screen for the UART console. The static
+ *           layout is printed once; values live in fields at fixed positions
+ *           that remember what they last showed. Setting a field emits only
+ *           a cursor move and the characters that changed, so a status screen
+ *           that used to be reprinted in full every frame costs a few dozen
+ *           bytes when only some numbers change.
+ *
+ *           Field text is stored in a buffer the caller provides, one byte per
+ *           column: declare fields with TERM_FIELD_DEFINE(). TERM_Clear() blanks
+ *           the screen and marks every field for a full redraw.
+ */
+
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Where the escape sequences go, SERCOM0_USART_Write() on the board
+typedef size_t (*TERM_WRITE)(const void* buffer, size_t size);
+
+typedef struct
+{
+    uint8_t     row;            // screen position of the first column, 1-based
+    uint8_t     col;
+    uint8_t     width;          // columns, shorter text is padded with spaces
+    uint8_t     screen;         // TERM_Clear() count when last drawn
+    char*       shown;          // width characters on the screen now
+} TERM_FIELD;
+
+// static TERM_FIELD name at row/col, width columns
+#define TERM_FIELD_DEFINE(name, r, c, w)                                        \
+    static char name##_shown[(w)];                                              \
+    static TERM_FIELD name = { (r), (c), (w), 0, name##_shown }
+
+void TERM_Init(TERM_WRITE write);
+// Blank the screen, hide the cursor, home; every field is redrawn on its next set
+void TERM_Clear(void);
+// Static text at a position
+void TERM_Text(uint8_t row, uint8_t col, const char* text);
+// Cursor to row/col for plain output, e.g. a block below the fields. The output
+// must not run over fields: they only know what they wrote themselves.
+void TERM_MoveTo(uint8_t row, uint8_t col);
+// TERM_MoveTo() the start of row and erase from there to the end of the screen
+void TERM_ClearFrom(uint8_t row);
+
+// Show text in a field: only the changed span goes out
+void TERM_FieldText(TERM_FIELD* field, const char* text);
+// Decimal, left-aligned
+void TERM_FieldInt(TERM_FIELD* field, int32_t value);
+// "0x" and digits hex digits
+void TERM_FieldHex(TERM_FIELD* field, uint16_t value, uint8_t digits);
+
+uint32_t TERM_BytesGet(void);           // bytes emitted since TERM_Init()
+
+#endif /* TERMINAL_H */
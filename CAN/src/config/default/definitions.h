@@ -56,8 +56,10 @@
 #include "peripheral/sercom/usart/plib_sercom0_usart.h"
 #include "peripheral/port/plib_port.h"
 #include "peripheral/clock/plib_clock.h"
+#include "peripheral/systick/plib_systick.h"
 #include "peripheral/nvic/plib_nvic.h"
 #include "peripheral/adc/plib_adc.h"
+#include "stdio/xc32_monitor.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -125,13 +125,13 @@
 static void STDIO_BufferModeSet(void)
 {
     /* MISRAC 2023 deviation block start */
-    /* MISRA C-2023 Rule 21.6 deviated 2 times in this file.  Deviation record ID -  H3_MISRAC_2023_R_21_6_DR_3 */
+    /* MISRA C-2023 Rule 21.6 deviated 1 times in this file.  Deviation record ID -  H3_MISRAC_2023_R_21_6_DR_3 */
 
     /* Make stdin unbuffered */
     setbuf(stdin, NULL);
 
-    /* Make stdout unbuffered */
-    setbuf(stdout, NULL);
+    /* Buffer stdout in front of the SERCOM0 transmit ring, see xc32_monitor.h */
+    STDIO_StdoutModeSet(STDIO_STDOUT_MODE);
     /* MISRAC 2023 deviation block end */
 }
 
@@ -176,6 +176,7 @@ void SYS_Initialize ( void* data )
 
     SERCOM0_USART_Initialize();
 
+	SYSTICK_TimerInitialize();
     ADC_Initialize();
 
     NVIC_Initialize();
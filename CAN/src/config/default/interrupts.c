@@ -79,7 +79,6 @@ void __attribute__((optimize("-O1"), long_call, noreturn, used))Dummy_Handler(vo
 /* Device vectors list dummy definition*/
 extern void SVCall_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void PendSV_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
-extern void SysTick_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void PM_Handler                 ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void SYSCTRL_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void WDT_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
@@ -87,7 +86,6 @@ extern void RTC_Handler                ( void ) __attribute__((weak, alias("Dumm
 extern void EIC_Handler                ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void NVMCTRL_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void EVSYS_Handler              ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
-extern void SERCOM0_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void SERCOM3_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void SERCOM4_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void SERCOM5_Handler            ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
@@ -110,7 +108,7 @@ extern void PTC_Handler                ( void ) __attribute__((weak, alias("Dumm
 
 
 /* MISRAC 2023 deviation block start */
-/* MISRA C-2023 Rule 2.8 deviated 24 times.  Deviation record ID -  H3_MISRAC_2023_R_2_8_DR_1 */
+/* MISRA C-2023 Rule 2.8 deviated 23 times.  Deviation record ID -  H3_MISRAC_2023_R_2_8_DR_1 */
 
 __attribute__ ((section(".vectors"), used))
 const H3DeviceVectors exception_table=
@@ -131,7 +129,7 @@ const H3DeviceVectors exception_table=
     .pfnEIC_Handler                = EIC_Handler,
     .pfnNVMCTRL_Handler            = NVMCTRL_Handler,
     .pfnEVSYS_Handler              = EVSYS_Handler,
-    .pfnSERCOM0_Handler            = SERCOM0_Handler,
+    .pfnSERCOM0_Handler            = SERCOM0_USART_InterruptHandler,
     .pfnSERCOM1_Handler            = SERCOM1_SPI_InterruptHandler,
     .pfnSERCOM2_Handler            = SERCOM2_I2C_InterruptHandler,
     .pfnSERCOM3_Handler            = SERCOM3_Handler,
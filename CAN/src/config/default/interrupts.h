@@ -59,6 +59,7 @@
 void Reset_Handler (void);
 void NonMaskableInt_Handler (void);
 void HardFault_Handler (void);
+void SERCOM0_USART_InterruptHandler (void);
 void SERCOM1_SPI_InterruptHandler (void);
 void SERCOM2_I2C_InterruptHandler (void);
 
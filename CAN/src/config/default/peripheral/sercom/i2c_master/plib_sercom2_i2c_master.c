@@ -50,6 +50,9 @@
 
 #include "interrupts.h"
 #include "plib_sercom2_i2c_master.h"
+#include "peripheral/nvic/plib_nvic.h"
+#include "peripheral/port/plib_port.h"
+#include "peripheral/systick/plib_systick.h"
 
 
 // *****************************************************************************
@@ -61,12 +64,268 @@
 
 #define SERCOM2_I2CM_SPEED_HZ           100000
 
+/* SDA hold time below Fast-mode Plus */
+#define SERCOM2_I2CM_SDAHOLD            SERCOM_I2CM_CTRLA_SDAHOLD_450NS
+
+/* Bus rise time assumed by the SCL timing, pull-ups and wiring dependent */
+#define SERCOM2_I2CM_TRISE_NS           100U
+
 /* SERCOM2 I2C baud value */
 #define SERCOM2_I2CM_BAUD_VALUE         (0x22U)
 
+/* Bus recovery takes the pads over as GPIO: PA12 = PAD0 (SDA), PA13 = PAD1 (SCL) */
+#define SERCOM2_I2C_SDA_PIN             PORT_PIN_PA12
+
+#define SERCOM2_I2C_SCL_PIN             PORT_PIN_PA13
+
+/* Longest wait for the bus to go idle or for an address byte to complete */
+#define SERCOM2_I2C_BUS_TIMEOUT_US      1000U
+
+#define SERCOM2_I2C_BUS_TIMEOUT_MS      (SERCOM2_I2C_BUS_TIMEOUT_US / 1000U)
+
+/* Longest register synchronization, a few GCLK cycles when the clock runs */
+#define SERCOM2_I2C_SYNC_TIMEOUT_US     100U
+
+/* Transfer watchdog: twice the bus time of the transfer's bytes plus this margin */
+#define SERCOM2_I2C_XFER_MARGIN_MS      2U
+
 
 static volatile SERCOM_I2C_OBJ sercom2I2CObj;
 
+static volatile SERCOM_I2C_STATISTICS sercom2I2CStats;
+
+/* Transaction queue: head is the transaction on the bus while queueActive is set */
+static SERCOM_I2C_TRANSACTION sercom2I2CQueue[SERCOM2_I2C_QUEUE_SIZE];
+
+static volatile uint32_t sercom2I2CQueueHead;
+
+static volatile uint32_t sercom2I2CQueueCount;
+
+static volatile bool sercom2I2CQueueActive;
+
+/* Scatter-gather write: segments still to be sent after the current write buffer */
+static const SERCOM_I2C_SEGMENT* volatile sercom2I2CSegments;
+
+static volatile uint32_t sercom2I2CSegmentsLeft;
+
+/* Transfer watchdog: start tick and allowed duration of the transfer on the bus */
+static volatile uint32_t sercom2I2CXferStart;
+
+static volatile uint32_t sercom2I2CXferTimeoutMs;
+
+static uint32_t sercom2I2CUsPerByte = 9000000U / SERCOM2_I2CM_SPEED_HZ;
+
+/* Set from the last MB/SB of a transfer until the ISR issues either the repeated START
+   of the next transfer or the STOP: the master is stretching SCL and still owns the bus */
+static volatile bool sercom2I2CBusHeld;
+
+/* Bus found busy or SDA low: tick since when, SERCOM2_I2C_Tasks() recovers it after
+   SERCOM2_I2C_BUS_TIMEOUT_MS. Set for a transfer parked in BUS_WAIT or an idle driver. */
+static volatile bool sercom2I2CBusWaiting;
+
+static volatile uint32_t sercom2I2CBusWaitStart;
+
+static void SERCOM2_I2C_QueueComplete(SERCOM_I2C_CALLBACK callback, uintptr_t context);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SERCOM2 I2C Bus Recovery
+// *****************************************************************************
+// *****************************************************************************
+
+void SERCOM2_I2C_DeadlineStart(SERCOM2_I2C_DEADLINE* deadline, uint32_t us)
+{
+    deadline->last = SYSTICK_TimerCounterGet();
+    deadline->left = us * (SYSTICK_FREQ / 1000000U);
+}
+
+bool SERCOM2_I2C_DeadlineReached(SERCOM2_I2C_DEADLINE* deadline)
+{
+    uint32_t now = SYSTICK_TimerCounterGet();
+    uint32_t elapsed;
+
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+        /* SysTick not running: count every poll as one microsecond */
+        elapsed = SYSTICK_FREQ / 1000000U;
+    }
+    else if (now <= deadline->last)
+    {
+        elapsed = deadline->last - now;
+    }
+    else
+    {
+        elapsed = deadline->last + SYSTICK_TimerPeriodGet() + 1U - now;
+    }
+
+    deadline->last = now;
+    deadline->left = (elapsed < deadline->left) ? (deadline->left - elapsed) : 0U;
+
+    return (deadline->left == 0U);
+}
+
+/* Core cycles since a SysTick counter reading, for the interrupt profile (SysTick runs
+   from the CPU clock). Valid for less than one SysTick period. */
+static uint32_t SERCOM2_I2C_CyclesSince(uint32_t start)
+{
+    uint32_t now = SYSTICK_TimerCounterGet();
+
+    return (now <= start) ? (start - now) : (start + SYSTICK_TimerPeriodGet() + 1U - now);
+}
+
+static void SERCOM2_I2C_DelayUs(uint32_t us)
+{
+    SERCOM2_I2C_DEADLINE deadline;
+
+    SERCOM2_I2C_DeadlineStart(&deadline, us);
+    while (SERCOM2_I2C_DeadlineReached(&deadline) == false)
+    {
+        /* Do nothing */
+    }
+}
+
+static bool SERCOM2_I2C_WaitBusIdle(void)
+{
+    SERCOM2_I2C_DEADLINE deadline;
+
+    SERCOM2_I2C_DeadlineStart(&deadline, SERCOM2_I2C_BUS_TIMEOUT_US);
+    while((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) != SERCOM_I2CM_STATUS_BUSSTATE(0x01U))
+    {
+        if (SERCOM2_I2C_DeadlineReached(&deadline) == true)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Register synchronization with a deadline: false if SYNCBUSY never cleared
+   (peripheral clock stopped), the caller carries on like the Harmony code would */
+static bool SERCOM2_I2C_SyncWait(void)
+{
+    SERCOM2_I2C_DEADLINE deadline;
+
+    SERCOM2_I2C_DeadlineStart(&deadline, SERCOM2_I2C_SYNC_TIMEOUT_US);
+    while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
+    {
+        if (SERCOM2_I2C_DeadlineReached(&deadline) == true)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool SERCOM2_I2C_BusFree(void)
+{
+    return ((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) == SERCOM_I2CM_STATUS_BUSSTATE(0x01U)) &&
+           (PORT_PinRead(SERCOM2_I2C_SDA_PIN) == true);
+}
+
+/* Open-drain emulation: released lines float high on the pad pull-up */
+static void SERCOM2_I2C_PinRelease(PORT_PIN pin)
+{
+    PORT_PinInputEnable(pin);
+    PORT_PinSet(pin);
+}
+
+static void SERCOM2_I2C_PinLow(PORT_PIN pin)
+{
+    PORT_PinClear(pin);
+    PORT_PinOutputEnable(pin);
+}
+
+bool SERCOM2_I2C_BusRecover(void)
+{
+    uint32_t pulses;
+    bool busFree;
+
+    sercom2I2CStats.recoveries++;
+
+    /* Disable the I2C module and take the pads over */
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA &= ~SERCOM_I2CM_CTRLA_ENABLE_Msk;
+
+    /* Wait for synchronization */
+    (void)SERCOM2_I2C_SyncWait();
+
+    SERCOM2_I2C_PinRelease(SERCOM2_I2C_SDA_PIN);
+    SERCOM2_I2C_PinRelease(SERCOM2_I2C_SCL_PIN);
+    PORT_PinGPIOConfig(SERCOM2_I2C_SDA_PIN);
+    PORT_PinGPIOConfig(SERCOM2_I2C_SCL_PIN);
+    SERCOM2_I2C_DelayUs(5U);
+
+    /* A slave stopped in the middle of a byte holds SDA low: clock the rest of the
+       byte and its ACK out, at most nine pulses at about 100 kHz */
+    for (pulses = 0U; (pulses < 9U) && (PORT_PinRead(SERCOM2_I2C_SDA_PIN) == false); pulses++)
+    {
+        SERCOM2_I2C_PinLow(SERCOM2_I2C_SCL_PIN);
+        SERCOM2_I2C_DelayUs(5U);
+        SERCOM2_I2C_PinRelease(SERCOM2_I2C_SCL_PIN);
+        SERCOM2_I2C_DelayUs(5U);
+    }
+
+    /* STOP condition: SDA rises while SCL is high */
+    SERCOM2_I2C_PinLow(SERCOM2_I2C_SCL_PIN);
+    SERCOM2_I2C_DelayUs(5U);
+    SERCOM2_I2C_PinLow(SERCOM2_I2C_SDA_PIN);
+    SERCOM2_I2C_DelayUs(5U);
+    SERCOM2_I2C_PinRelease(SERCOM2_I2C_SCL_PIN);
+    SERCOM2_I2C_DelayUs(5U);
+    SERCOM2_I2C_PinRelease(SERCOM2_I2C_SDA_PIN);
+    SERCOM2_I2C_DelayUs(5U);
+
+    busFree = PORT_PinRead(SERCOM2_I2C_SDA_PIN) && PORT_PinRead(SERCOM2_I2C_SCL_PIN);
+
+    /* Give the pads back to SERCOM2 and restart it */
+    PORT_PinPeripheralFunctionConfig(SERCOM2_I2C_SDA_PIN, PERIPHERAL_FUNCTION_C);
+    PORT_PinPeripheralFunctionConfig(SERCOM2_I2C_SCL_PIN, PERIPHERAL_FUNCTION_C);
+
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_ENABLE_Msk;
+
+    /* Wait for synchronization */
+    (void)SERCOM2_I2C_SyncWait();
+
+    /* Since the I2C module was disabled, re-initialize the bus state to IDLE */
+    SERCOM2_REGS->I2CM.SERCOM_STATUS = (uint16_t)SERCOM_I2CM_STATUS_BUSSTATE(0x01UL);
+
+    /* Wait for synchronization */
+    (void)SERCOM2_I2C_SyncWait();
+
+    SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
+    sercom2I2CObj.state = SERCOM_I2C_STATE_IDLE;
+
+    return busFree;
+}
+
+/* Transfer watchdog, polled from SERCOM2_I2C_Tasks(): a transfer whose completion
+   interrupt never came (SCL held low, lost STOP) is ended with a bus error after a
+   recovery, and its callback runs from the polling context. Only the SERCOM2 line is
+   masked, the recovery takes about 100us. */
+static void SERCOM2_I2C_XferTimeoutCheck(void)
+{
+    if ((sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE) || (sercom2I2CObj.state == SERCOM_I2C_STATE_BUS_WAIT) ||
+        ((SYSTICK_GetTickCounter() - sercom2I2CXferStart) <= sercom2I2CXferTimeoutMs))
+    {
+        return;
+    }
+
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    if ((sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE) || (sercom2I2CObj.state == SERCOM_I2C_STATE_BUS_WAIT))
+    {
+        /* Completed in the meantime */
+        NVIC_EnableIRQ(SERCOM2_IRQn);
+        return;
+    }
+    sercom2I2CStats.timeouts++;
+    (void)SERCOM2_I2C_BusRecover();
+    sercom2I2CObj.error = SERCOM_I2C_ERROR_BUS;
+    NVIC_EnableIRQ(SERCOM2_IRQn);
+
+    SERCOM2_I2C_QueueComplete(sercom2I2CObj.callback, sercom2I2CObj.context);
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: SERCOM2 I2C Implementation
@@ -98,7 +357,7 @@ void SERCOM2_I2C_Initialize(void)
     SERCOM2_REGS->I2CM.SERCOM_BAUD = SERCOM2_I2CM_BAUD_VALUE;
 
     /* Set Operation Mode (Master), SDA Hold time, run in stand by and i2c master enable */
-    SERCOM2_REGS->I2CM.SERCOM_CTRLA = SERCOM_I2CM_CTRLA_MODE_I2C_MASTER | SERCOM_I2CM_CTRLA_SDAHOLD_450NS | SERCOM_I2CM_CTRLA_ENABLE_Msk ;
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA = SERCOM_I2CM_CTRLA_MODE_I2C_MASTER | SERCOM2_I2CM_SDAHOLD | SERCOM_I2CM_CTRLA_ENABLE_Msk ;
 
     /* Wait for synchronization */
     while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
@@ -123,12 +382,20 @@ void SERCOM2_I2C_Initialize(void)
     SERCOM2_REGS->I2CM.SERCOM_INTENSET = (uint8_t)SERCOM_I2CM_INTENSET_Msk;
 }
 
+/* SCL timing per bus mode: minimum low/high times (ns) from the I2C specification;
+   the low phase gets the larger share of every period like the spec minima do */
 static bool SERCOM2_I2C_CalculateBaudValue(uint32_t srcClkFreq, uint32_t i2cClkSpeed, uint32_t* baudVal)
 {
-    uint32_t baudValue = 0U;
-    float fSrcClkFreq = (float)srcClkFreq;
-    float fI2cClkSpeed = (float)i2cClkSpeed;
-    float fBaudValue = 0.0f;
+    uint32_t tLowNs;
+    uint32_t tHighNs;
+    uint32_t lowPermille;
+    uint32_t srcClkKHz = srcClkFreq / 1000U;
+    uint32_t riseCycles;
+    uint32_t total;
+    uint32_t baudLow;
+    uint32_t baudHigh;
+    uint32_t minLow;
+    uint32_t minHigh;
 
     /* Reference clock frequency must be atleast two times the baud rate */
     if (srcClkFreq < (2U * i2cClkSpeed))
@@ -136,33 +403,55 @@ static bool SERCOM2_I2C_CalculateBaudValue(uint32_t srcClkFreq, uint32_t i2cClkS
         return false;
     }
 
-    if (i2cClkSpeed <= 400000U)
+    if (i2cClkSpeed <= SERCOM_I2C_SPEED_STANDARD)
     {
-        /* Standard, FM and FM+ baud calculation */
-        fBaudValue = (fSrcClkFreq / fI2cClkSpeed) - ((fSrcClkFreq * (100.0f / 1000000000.0f)) + 10.0f);
-        baudValue = (uint32_t)fBaudValue;
-
-        /* For I2C clock speed upto 400 KHz, the value of BAUD<7:0> determines both SCL_L and SCL_H with SCL_L = SCL_H */
-        if (baudValue > (0xFFU * 2U))
-        {
-            /* Set baud rate to the minimum possible value */
-            baudValue = 0xFFU;
-        }
-        else if (baudValue <= 1U)
-        {
-            /* Baud value cannot be 0. Set baud rate to maximum possible value */
-            baudValue = 1U;
-        }
-        else
-        {
-            baudValue /= 2U;
-        }
+        tLowNs = 4700U;  tHighNs = 4000U;  lowPermille = 540U;
+    }
+    else if (i2cClkSpeed <= SERCOM_I2C_SPEED_FAST)
+    {
+        tLowNs = 1300U;  tHighNs = 600U;   lowPermille = 684U;
+    }
+    else if (i2cClkSpeed <= SERCOM_I2C_SPEED_FAST_PLUS)
+    {
+        tLowNs = 500U;   tHighNs = 260U;   lowPermille = 658U;
     }
     else
     {
+        /* High speed mode is not supported */
         return false;
     }
-    *baudVal = baudValue;
+
+    /* f(SCL) = f(GCLK) / (10 + BAUD + BAUDLOW + f(GCLK) * t(rise)): SCL low lasts
+       BAUDLOW + 5 cycles, high BAUD + 5 cycles plus the rise time */
+    riseCycles = (srcClkKHz * SERCOM2_I2CM_TRISE_NS) / 1000000U;
+    total = (srcClkFreq + i2cClkSpeed - 1U) / i2cClkSpeed;
+    total = (total > (riseCycles + 10U)) ? (total - riseCycles - 10U) : 0U;
+
+    minLow = (srcClkKHz * tLowNs + 999999U) / 1000000U;
+    minLow = (minLow > 5U) ? (minLow - 5U) : 1U;
+    minHigh = (srcClkKHz * tHighNs + 999999U) / 1000000U;
+    minHigh = (minHigh > (riseCycles + 5U)) ? (minHigh - riseCycles - 5U) : 1U;
+
+    baudLow = (total * lowPermille) / 1000U;
+    if (baudLow < minLow)
+    {
+        baudLow = minLow;
+    }
+    baudHigh = (total > baudLow) ? (total - baudLow) : 0U;
+    if (baudHigh < minHigh)
+    {
+        /* Clock too slow for the requested speed: run at the fastest legal one */
+        baudHigh = minHigh;
+    }
+
+    if ((baudLow > 0xFFU) || (baudHigh > 0xFFU))
+    {
+        /* Set baud rate to the minimum possible value */
+        baudLow = 0xFFU;
+        baudHigh = 0xFFU;
+    }
+
+    *baudVal = SERCOM_I2CM_BAUD_BAUD(baudHigh) | SERCOM_I2CM_BAUD_BAUDLOW(baudLow);
     return true;
 }
 
@@ -199,9 +488,15 @@ bool SERCOM2_I2C_TransferSetup(SERCOM_I2C_TRANSFER_SETUP* setup, uint32_t srcClk
     }
 
 
-    /* Baud rate - Master Baud Rate*/
+    /* Baud rate - Master Baud Rate, BAUDLOW sets the low phase separately */
     SERCOM2_REGS->I2CM.SERCOM_BAUD = (uint16_t)baudValue;
 
+    sercom2I2CUsPerByte = 9000000U / i2cClkSpeed;
+
+    /* Fm+ leaves only 0.5us of SCL low: use the short SDA hold time there */
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA = (SERCOM2_REGS->I2CM.SERCOM_CTRLA & ~SERCOM_I2CM_CTRLA_SDAHOLD_Msk) |
+        ((i2cClkSpeed > SERCOM_I2C_SPEED_FAST) ? SERCOM_I2CM_CTRLA_SDAHOLD_75NS : SERCOM2_I2CM_SDAHOLD);
+
 
     /* Re-enable the I2C module */
     SERCOM2_REGS->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_ENABLE_Msk;
@@ -252,14 +547,10 @@ static void SERCOM2_I2C_SendAddress(uint16_t address, bool dir)
     }
 
 
+    /* No wait for synchronization: the next MB/SB interrupt only comes after the
+       address went out, nothing touches a synchronized register before that */
     SERCOM2_REGS->I2CM.SERCOM_ADDR = ((uint8_t)address << 1U) | (dir ? 1U :0U);
-
-    /* Wait for synchronization */
-    while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-    {
-        /* Do nothing */
-    }
-
+    sercom2I2CStats.bytes++;
 }
 
 static void SERCOM2_I2C_InitiateTransfer(uint16_t address, bool dir)
@@ -267,18 +558,21 @@ static void SERCOM2_I2C_InitiateTransfer(uint16_t address, bool dir)
     sercom2I2CObj.writeCount = 0U;
     sercom2I2CObj.readCount = 0U;
 
-    /* Clear all flags */
-    SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
-
-    /* Smart mode enabled with SCLSM = 0, - ACK is set to send while receiving the data */
-    SERCOM2_REGS->I2CM.SERCOM_CTRLB &= ~SERCOM_I2CM_CTRLB_ACKACT_Msk;
-
-    /* Wait for synchronization */
-    while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
+    if (sercom2I2CBusHeld == true)
     {
-        /* Do nothing */
+        /* Chained from the end of the previous transfer: writing ADDR performs the pending
+           acknowledge action (NACK after a read) and a repeated START. MB/SB are cleared
+           by that write, clearing them here would release SCL. */
+        sercom2I2CBusHeld = false;
+    }
+    else
+    {
+        /* Clear all flags */
+        SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
     }
 
+    /* Smart mode and ACKACT (ACK while receiving) are set up by the first byte read,
+       ACKACT may still hold the NACK for the repeated START above */
 
     SERCOM2_I2C_SendAddress(address, dir);
 }
@@ -287,12 +581,17 @@ static bool SERCOM2_I2C_XferSetup(
     uint16_t address,
     uint8_t* wrData,
     uint32_t wrLength,
+    const SERCOM_I2C_SEGMENT* wrSegments,
+    uint32_t wrSegmentCount,
     uint8_t* rdData,
     uint32_t rdLength,
     bool dir,
     bool isHighSpeed
 )
 {
+    uint32_t bytes;
+    uint32_t i;
+
     /* Check for ongoing transfer */
     if(sercom2I2CObj.state != SERCOM_I2C_STATE_IDLE)
     {
@@ -304,10 +603,33 @@ static bool SERCOM2_I2C_XferSetup(
     sercom2I2CObj.readSize       = rdLength;
     sercom2I2CObj.writeBuffer    = wrData;
     sercom2I2CObj.writeSize      = wrLength;
+    sercom2I2CSegments           = wrSegments;
+    sercom2I2CSegmentsLeft       = wrSegmentCount;
     sercom2I2CObj.transferDir    = dir;
     sercom2I2CObj.isHighSpeed    = isHighSpeed;
     sercom2I2CObj.error          = SERCOM_I2C_ERROR_NONE;
 
+    sercom2I2CStats.transfers++;
+
+    /* Watchdog limit from the bytes this transfer puts on the bus */
+    bytes = wrLength + rdLength + ((rdLength != 0U) ? 2U : 1U);
+    for (i = 0U; i < wrSegmentCount; i++)
+    {
+        bytes += wrSegments[i].size;
+    }
+    sercom2I2CXferTimeoutMs = ((bytes * sercom2I2CUsPerByte) >> 9) + SERCOM2_I2C_XFER_MARGIN_MS;
+    sercom2I2CXferStart = SYSTICK_GetTickCounter();
+
+    /* Bus busy or SDA held low by a slave: no waiting here, this also runs from the
+       interrupt. The transfer is parked and SERCOM2_I2C_Tasks() starts it once the bus
+       is free, or recovers the bus first if it stays stuck. */
+    if ((sercom2I2CBusHeld == false) && (SERCOM2_I2C_BusFree() == false))
+    {
+        sercom2I2CObj.state = SERCOM_I2C_STATE_BUS_WAIT;
+        sercom2I2CBusWaiting = true;
+        sercom2I2CBusWaitStart = sercom2I2CXferStart;
+        return true;
+    }
 
     SERCOM2_I2C_InitiateTransfer(address, dir);
 
@@ -316,17 +638,88 @@ static bool SERCOM2_I2C_XferSetup(
 
 bool SERCOM2_I2C_Read(uint16_t address, uint8_t* rdData, uint32_t rdLength)
 {
-    return SERCOM2_I2C_XferSetup(address, NULL, 0, rdData, rdLength, true, false);
+    return SERCOM2_I2C_XferSetup(address, NULL, 0, NULL, 0, rdData, rdLength, true, false);
 }
 
 bool SERCOM2_I2C_Write(uint16_t address, uint8_t* wrData, uint32_t wrLength)
 {
-    return SERCOM2_I2C_XferSetup(address, wrData, wrLength, NULL, 0, false, false);
+    return SERCOM2_I2C_XferSetup(address, wrData, wrLength, NULL, 0, NULL, 0, false, false);
 }
 
 bool SERCOM2_I2C_WriteRead(uint16_t address, uint8_t* wrData, uint32_t wrLength, uint8_t* rdData, uint32_t rdLength)
 {
-    return SERCOM2_I2C_XferSetup(address, wrData, wrLength, rdData, rdLength, false, false);
+    return SERCOM2_I2C_XferSetup(address, wrData, wrLength, NULL, 0, rdData, rdLength, false, false);
+}
+
+bool SERCOM2_I2C_WriteVectored(uint16_t address, const SERCOM_I2C_SEGMENT* segments, uint32_t segmentCount)
+{
+    if ((segments == NULL) || (segmentCount == 0U))
+    {
+        return false;
+    }
+
+    return SERCOM2_I2C_XferSetup(address, NULL, 0, segments, segmentCount, NULL, 0, false, false);
+}
+
+/* Start the transaction at the head of the queue if the bus is free.
+   Called with interrupts disabled or from the SERCOM2 interrupt. */
+static void SERCOM2_I2C_QueueStart(void)
+{
+    const SERCOM_I2C_TRANSACTION* xfer;
+
+    if ((sercom2I2CQueueCount == 0U) || (sercom2I2CQueueActive == true))
+    {
+        return;
+    }
+
+    xfer = &sercom2I2CQueue[sercom2I2CQueueHead];
+
+    /* Read direction only for a pure read: an empty transaction is an address-only write */
+    if (SERCOM2_I2C_XferSetup(xfer->address, xfer->writeBuffer, xfer->writeSize,
+                              xfer->writeSegments, xfer->writeSegmentCount, xfer->readBuffer, xfer->readSize,
+                              ((xfer->readSize != 0U) && (xfer->writeSize == 0U) && (xfer->writeSegmentCount == 0U)), false) == true)
+    {
+        sercom2I2CQueueActive = true;
+    }
+}
+
+bool SERCOM2_I2C_TransferSubmit(const SERCOM_I2C_TRANSACTION* transaction)
+{
+    bool interruptState;
+    uint32_t tail;
+
+    if (transaction == NULL)
+    {
+        return false;
+    }
+
+    interruptState = NVIC_INT_Disable();
+
+    if (sercom2I2CQueueCount >= SERCOM2_I2C_QUEUE_SIZE)
+    {
+        NVIC_INT_Restore(interruptState);
+        return false;
+    }
+
+    tail = sercom2I2CQueueHead + sercom2I2CQueueCount;
+    if (tail >= SERCOM2_I2C_QUEUE_SIZE)
+    {
+        tail -= SERCOM2_I2C_QUEUE_SIZE;
+    }
+    sercom2I2CQueue[tail] = *transaction;
+    sercom2I2CQueueCount++;
+
+    /* Bus idle: start right away, otherwise the interrupt handler picks it up */
+    SERCOM2_I2C_QueueStart();
+
+    NVIC_INT_Restore(interruptState);
+
+    return true;
+}
+
+uint32_t SERCOM2_I2C_QueueCountGet(void)
+{
+    return sercom2I2CQueueCount;
 }
 
 
@@ -334,6 +727,7 @@ bool SERCOM2_I2C_BusScan(uint16_t start_addr, uint16_t end_addr, void* pDevicesL
 {
     uint8_t* pDevList = (uint8_t*)pDevicesList;
     uint8_t nDevFound = 0;
+    SERCOM2_I2C_DEADLINE deadline;
 
     /* Check for ongoing transfer */
     if(sercom2I2CObj.state != SERCOM_I2C_STATE_IDLE)
@@ -356,23 +750,34 @@ bool SERCOM2_I2C_BusScan(uint16_t start_addr, uint16_t end_addr, void* pDevicesL
 
     for (uint16_t dev_addr = start_addr; dev_addr <= end_addr; dev_addr++)
     {
-        while(((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) != SERCOM_I2CM_STATUS_BUSSTATE(0x01U)))
+        /* Wait for the bus to become IDLE */
+        if (SERCOM2_I2C_WaitBusIdle() == false)
         {
-            /* Wait for the bus to become IDLE */
+            (void)SERCOM2_I2C_BusRecover();
         }
 
         /* Put the 7-bit device address on the bus with WR bit */
             SERCOM2_REGS->I2CM.SERCOM_ADDR = ((uint8_t)dev_addr << 1U);
 
         /* Wait for synchronization */
-        while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
+        (void)SERCOM2_I2C_SyncWait();
+
+        /* Wait for the address transfer to complete */
+        SERCOM2_I2C_DeadlineStart(&deadline, SERCOM2_I2C_BUS_TIMEOUT_US);
+        while ((SERCOM2_REGS->I2CM.SERCOM_INTFLAG & SERCOM_I2CM_INTFLAG_MB_Msk) == 0U)
         {
-            /* Do nothing */
+            if (SERCOM2_I2C_DeadlineReached(&deadline) == true)
+            {
+                break;
+            }
         }
 
-        while ((SERCOM2_REGS->I2CM.SERCOM_INTFLAG & SERCOM_I2CM_INTFLAG_MB_Msk) == 0U)
+        if ((SERCOM2_REGS->I2CM.SERCOM_INTFLAG & SERCOM_I2CM_INTFLAG_MB_Msk) == 0U)
         {
-            /* Wait for the address transfer to complete */
+            /* Address never went out: free the bus, nothing found here */
+            sercom2I2CStats.timeouts++;
+            (void)SERCOM2_I2C_BusRecover();
+            continue;
         }
 
         if ((SERCOM2_REGS->I2CM.SERCOM_STATUS & (SERCOM_I2CM_STATUS_ARBLOST_Msk | SERCOM_I2CM_STATUS_BUSERR_Msk | SERCOM_I2CM_STATUS_RXNACK_Msk)) == 0U)
@@ -387,10 +792,7 @@ bool SERCOM2_I2C_BusScan(uint16_t start_addr, uint16_t end_addr, void* pDevicesL
         SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
 
         /* Wait for synchronization */
-        while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-        {
-            /* Do nothing */
-        }
+        (void)SERCOM2_I2C_SyncWait();
     }
 
     *nDevicesFound = nDevFound;
@@ -404,14 +806,77 @@ bool SERCOM2_I2C_BusScan(uint16_t start_addr, uint16_t end_addr, void* pDevicesL
 bool SERCOM2_I2C_IsBusy(void)
 {
     bool isBusy = true;
-    if((sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE))
+
+    if((sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE) && ((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) == SERCOM_I2CM_STATUS_BUSSTATE(0x01U)))
+    {
+       isBusy = false;
+    }
+    return isBusy;
+}
+
+/* Thread context service, call it from the main loop and from every loop that waits on
+   the driver. Starts a transfer parked behind a busy bus, recovers a bus that stays busy
+   or has SDA held low for SERCOM2_I2C_BUS_TIMEOUT_MS, and runs the transfer watchdog.
+   The interrupt and the submit paths only park transfers, all waiting happens here. */
+void SERCOM2_I2C_Tasks(void)
+{
+    bool busFree;
+
+    SERCOM2_I2C_XferTimeoutCheck();
+
+    busFree = SERCOM2_I2C_BusFree();
+
+    if ((sercom2I2CObj.state != SERCOM_I2C_STATE_IDLE) && (sercom2I2CObj.state != SERCOM_I2C_STATE_BUS_WAIT))
+    {
+        /* Our transfer is on the bus */
+        sercom2I2CBusWaiting = false;
+        return;
+    }
+
+    if ((busFree == true) && (sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE))
+    {
+        sercom2I2CBusWaiting = false;
+        return;
+    }
+
+    if (busFree == false)
     {
-        if(((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) == SERCOM_I2CM_STATUS_BUSSTATE(0x01U)))
+        if (sercom2I2CBusWaiting == false)
+        {
+            sercom2I2CBusWaiting = true;
+            sercom2I2CBusWaitStart = SYSTICK_GetTickCounter();
+            return;
+        }
+        if ((SYSTICK_GetTickCounter() - sercom2I2CBusWaitStart) <= SERCOM2_I2C_BUS_TIMEOUT_MS)
         {
-           isBusy = false;
+            return;
         }
     }
-    return isBusy;
+
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    if ((sercom2I2CObj.state != SERCOM_I2C_STATE_IDLE) && (sercom2I2CObj.state != SERCOM_I2C_STATE_BUS_WAIT))
+    {
+        /* Submitted from an interrupt in the meantime */
+        NVIC_EnableIRQ(SERCOM2_IRQn);
+        return;
+    }
+    if (busFree == false)
+    {
+        /* BusRecover() leaves the driver IDLE, the parked transfer is started below */
+        SERCOM_I2C_STATE state = sercom2I2CObj.state;
+
+        (void)SERCOM2_I2C_BusRecover();
+        sercom2I2CObj.state = state;
+    }
+    sercom2I2CBusWaiting = false;
+
+    if (sercom2I2CObj.state == SERCOM_I2C_STATE_BUS_WAIT)
+    {
+        /* Watchdog runs from the START on */
+        sercom2I2CXferStart = SYSTICK_GetTickCounter();
+        SERCOM2_I2C_InitiateTransfer(sercom2I2CObj.address, sercom2I2CObj.transferDir);
+    }
+    NVIC_EnableIRQ(SERCOM2_IRQn);
 }
 
 SERCOM_I2C_ERROR SERCOM2_I2C_ErrorGet(void)
@@ -419,8 +884,49 @@ SERCOM_I2C_ERROR SERCOM2_I2C_ErrorGet(void)
     return sercom2I2CObj.error;
 }
 
+void SERCOM2_I2C_StatisticsGet(SERCOM_I2C_STATISTICS* stats)
+{
+    if (stats != NULL)
+    {
+        /* Counters are updated from the interrupt, take a consistent copy */
+        NVIC_DisableIRQ(SERCOM2_IRQn);
+        stats->transfers = sercom2I2CStats.transfers;
+        stats->bytes     = sercom2I2CStats.bytes;
+        stats->naks      = sercom2I2CStats.naks;
+        stats->busErrors = sercom2I2CStats.busErrors;
+        stats->timeouts  = sercom2I2CStats.timeouts;
+        stats->recoveries = sercom2I2CStats.recoveries;
+        stats->isrCalls  = sercom2I2CStats.isrCalls;
+        stats->isrCycles = sercom2I2CStats.isrCycles;
+        stats->isrCyclesMax = sercom2I2CStats.isrCyclesMax;
+        NVIC_EnableIRQ(SERCOM2_IRQn);
+    }
+}
+
+void SERCOM2_I2C_StatisticsClear(void)
+{
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    sercom2I2CStats.transfers = 0U;
+    sercom2I2CStats.bytes     = 0U;
+    sercom2I2CStats.naks      = 0U;
+    sercom2I2CStats.busErrors = 0U;
+    sercom2I2CStats.timeouts  = 0U;
+    sercom2I2CStats.recoveries = 0U;
+    sercom2I2CStats.isrCalls  = 0U;
+    sercom2I2CStats.isrCycles = 0U;
+    sercom2I2CStats.isrCyclesMax = 0U;
+    NVIC_EnableIRQ(SERCOM2_IRQn);
+}
+
 void SERCOM2_I2C_TransferAbort( void )
 {
+    bool interruptState = NVIC_INT_Disable();
+
+    /* Queued transactions are dropped without their callbacks */
+    sercom2I2CQueueCount = 0U;
+    sercom2I2CQueueActive = false;
+    NVIC_INT_Restore(interruptState);
+
     sercom2I2CObj.error = SERCOM_I2C_ERROR_NONE;
 
     // Reset the plib to IDLE state
@@ -454,11 +960,118 @@ void SERCOM2_I2C_TransferAbort( void )
     }
 }
 
+/* Thread context: remove every queued transaction with this callback and context, a
+   transfer of theirs already on the bus is stopped and the bus recovered. Each removed
+   transaction's callback runs from here with SERCOM_I2C_ERROR_BUS, the SERCOM2 line
+   masked like for the watchdog. Other queued transactions are kept in order. */
+uint32_t SERCOM2_I2C_TransferCancel(SERCOM_I2C_CALLBACK callback, uintptr_t context)
+{
+    SERCOM_I2C_TRANSACTION cancelled[SERCOM2_I2C_QUEUE_SIZE];
+    uint32_t count = 0U;
+    uint32_t kept = 0U;
+    uint32_t from;
+    uint32_t to;
+    uint32_t i;
+
+    NVIC_DisableIRQ(SERCOM2_IRQn);
+    for (i = 0U; i < sercom2I2CQueueCount; i++)
+    {
+        from = sercom2I2CQueueHead + i;
+        if (from >= SERCOM2_I2C_QUEUE_SIZE)
+        {
+            from -= SERCOM2_I2C_QUEUE_SIZE;
+        }
+        if ((sercom2I2CQueue[from].callback != callback) || (sercom2I2CQueue[from].context != context))
+        {
+            to = sercom2I2CQueueHead + kept;
+            if (to >= SERCOM2_I2C_QUEUE_SIZE)
+            {
+                to -= SERCOM2_I2C_QUEUE_SIZE;
+            }
+            sercom2I2CQueue[to] = sercom2I2CQueue[from];
+            kept++;
+            continue;
+        }
+        if ((i == 0U) && (sercom2I2CQueueActive == true))
+        {
+            /* Ours is the head: stop it, a transfer parked in BUS_WAIT never started */
+            if (sercom2I2CObj.state != SERCOM_I2C_STATE_BUS_WAIT)
+            {
+                (void)SERCOM2_I2C_BusRecover();
+            }
+            sercom2I2CObj.state = SERCOM_I2C_STATE_IDLE;
+            sercom2I2CQueueActive = false;
+        }
+        cancelled[count] = sercom2I2CQueue[from];
+        count++;
+    }
+    sercom2I2CQueueCount = kept;
+
+    for (i = 0U; i < count; i++)
+    {
+        /* Set again for each one, a callback may have started the next transfer */
+        sercom2I2CObj.error = SERCOM_I2C_ERROR_BUS;
+        if (cancelled[i].callback != NULL)
+        {
+            cancelled[i].callback(cancelled[i].context);
+        }
+    }
+
+    if (sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE)
+    {
+        SERCOM2_I2C_QueueStart();
+    }
+    NVIC_EnableIRQ(SERCOM2_IRQn);
+
+    return count;
+}
+
+/* End of a transfer: run the callback of the transaction that finished (the queued
+   one or the registered callback for a direct transfer), then start the next queued
+   transaction unless the callback has already started a direct transfer. */
+static void SERCOM2_I2C_QueueComplete(SERCOM_I2C_CALLBACK callback, uintptr_t context)
+{
+    bool interruptState;
+
+    if (sercom2I2CQueueActive == true)
+    {
+        interruptState = NVIC_INT_Disable();
+        callback = sercom2I2CQueue[sercom2I2CQueueHead].callback;
+        context  = sercom2I2CQueue[sercom2I2CQueueHead].context;
+        sercom2I2CQueueHead = (sercom2I2CQueueHead + 1U < SERCOM2_I2C_QUEUE_SIZE) ? (sercom2I2CQueueHead + 1U) : 0U;
+        sercom2I2CQueueCount--;
+        sercom2I2CQueueActive = false;
+        NVIC_INT_Restore(interruptState);
+    }
+
+    if (callback != NULL)
+    {
+        callback(context);
+    }
+
+    interruptState = NVIC_INT_Disable();
+    if (sercom2I2CObj.state == SERCOM_I2C_STATE_IDLE)
+    {
+        SERCOM2_I2C_QueueStart();
+    }
+    NVIC_INT_Restore(interruptState);
+}
+
+/* The handler never waits on SYNCBUSY or BUSSTATE: every register write it makes is
+   followed by the next MB/SB interrupt or by nothing, and a finished transfer leaves
+   the bus held (SCL stretched) until the next queued transfer has been started with a
+   repeated START or a STOP was issued. Only a bus error / lost arbitration, after
+   which the bus belongs to nobody, parks the next queued transfer in BUS_WAIT for
+   SERCOM2_I2C_Tasks() to start; nothing reachable from here waits or recovers. */
 void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
 {
+    uint32_t isrStart = SYSTICK_TimerCounterGet();
+    uint32_t isrCycles;
+
     if(SERCOM2_REGS->I2CM.SERCOM_INTENSET != 0U)
     {
         uintptr_t context = sercom2I2CObj.context;
+        SERCOM_I2C_CALLBACK callback = sercom2I2CObj.callback;
 
         /* Checks if the arbitration lost in multi-master scenario */
         if((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_ARBLOST_Msk) == SERCOM_I2CM_STATUS_ARBLOST_Msk)
@@ -466,6 +1079,7 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
             /* Set Error status */
             sercom2I2CObj.state = SERCOM_I2C_STATE_ERROR;
             sercom2I2CObj.error = SERCOM_I2C_ERROR_BUS;
+            sercom2I2CStats.busErrors++;
 
         }
         /* Check for Bus Error during transmission */
@@ -474,12 +1088,14 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
             /* Set Error status */
             sercom2I2CObj.state = SERCOM_I2C_STATE_ERROR;
             sercom2I2CObj.error = SERCOM_I2C_ERROR_BUS;
+            sercom2I2CStats.busErrors++;
         }
         /* Checks slave acknowledge for address or data */
         else if((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_RXNACK_Msk) == SERCOM_I2CM_STATUS_RXNACK_Msk)
         {
             sercom2I2CObj.state = SERCOM_I2C_STATE_ERROR;
             sercom2I2CObj.error = SERCOM_I2C_ERROR_NAK;
+            sercom2I2CStats.naks++;
         }
         else
         {
@@ -511,6 +1127,16 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
                 {
                     size_t writeCount = sercom2I2CObj.writeCount;
 
+                    /* Scatter-gather: carry on with the next non-empty segment, same START...STOP */
+                    while ((writeCount == sercom2I2CObj.writeSize) && (sercom2I2CSegmentsLeft != 0U))
+                    {
+                        sercom2I2CObj.writeBuffer = sercom2I2CSegments->data;
+                        sercom2I2CObj.writeSize   = sercom2I2CSegments->size;
+                        sercom2I2CSegments++;
+                        sercom2I2CSegmentsLeft--;
+                        writeCount = 0U;
+                    }
+
                     if (writeCount == (sercom2I2CObj.writeSize))
                     {
                         if(sercom2I2CObj.readSize != 0U)
@@ -518,27 +1144,14 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
 
                             /* Write 7bit address with direction (ADDR.ADDR[0]) equal to 1*/
                             SERCOM2_REGS->I2CM.SERCOM_ADDR =  ((uint8_t)(sercom2I2CObj.address) << 1U) | (uint8_t)I2C_TRANSFER_READ;
-
-                            /* Wait for synchronization */
-                            while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-                            {
-                                /* Do nothing */
-                            }
+                            sercom2I2CStats.bytes++;
 
                             sercom2I2CObj.state = SERCOM_I2C_STATE_TRANSFER_READ;
 
                         }
                         else
                         {
-                            SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
-
-                            /* Wait for synchronization */
-                            while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-                            {
-                                /* Do nothing */
-                            }
-
-
+                            /* Last byte acknowledged: STOP or repeated START is decided below */
                             sercom2I2CObj.state = SERCOM_I2C_STATE_TRANSFER_DONE;
                         }
                     }
@@ -547,11 +1160,7 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
                     {
                         SERCOM2_REGS->I2CM.SERCOM_DATA = sercom2I2CObj.writeBuffer[writeCount];
                         writeCount++;
-                        /* Wait for synchronization */
-                            while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-                            {
-                                /* Do nothing */
-                            }
+                        sercom2I2CStats.bytes++;
                         sercom2I2CObj.writeCount = writeCount;
                     }
                 }
@@ -565,27 +1174,26 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
 
                     if(readCount == (sercom2I2CObj.readSize - 1U))
                     {
-                        /* Set NACK and send stop condition to the slave from master */
-                        SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_ACKACT_Msk | SERCOM_I2CM_CTRLB_CMD(3UL);
-
-                        /* Wait for synchronization */
-                        while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-                        {
-                            /* Do nothing */
-                        }
+                        /* Last byte: smart mode off so reading DATA sends nothing yet, the NACK
+                           goes out with the STOP or repeated START decided below */
+                        SERCOM2_REGS->I2CM.SERCOM_CTRLB = (SERCOM2_REGS->I2CM.SERCOM_CTRLB & ~SERCOM_I2CM_CTRLB_SMEN_Msk) | SERCOM_I2CM_CTRLB_ACKACT_Msk;
 
                         sercom2I2CObj.state = SERCOM_I2C_STATE_TRANSFER_DONE;
                     }
-
-                    /* Wait for synchronization */
-                        while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
-                        {
-                            /* Do nothing */
-                        }
+                    else if (readCount == 0U)
+                    {
+                        /* Smart mode: reading DATA acknowledges the byte and starts the next one */
+                        SERCOM2_REGS->I2CM.SERCOM_CTRLB = (SERCOM2_REGS->I2CM.SERCOM_CTRLB | SERCOM_I2CM_CTRLB_SMEN_Msk) & ~SERCOM_I2CM_CTRLB_ACKACT_Msk;
+                    }
+                    else
+                    {
+                        /* Do nothing */
+                    }
 
                     /* Read the received data */
                     sercom2I2CObj.readBuffer[readCount] = (uint8_t) SERCOM2_REGS->I2CM.SERCOM_DATA;
                     readCount++;
+                    sercom2I2CStats.bytes++;
 
                     sercom2I2CObj.readCount = readCount;
                 }
@@ -605,22 +1213,20 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
             /* Reset the PLib objects and Interrupts */
             sercom2I2CObj.state = SERCOM_I2C_STATE_IDLE;
 
-            /* Generate STOP condition */
-            SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
-
-            /* Wait for synchronization */
-            while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
+            if (sercom2I2CObj.error == SERCOM_I2C_ERROR_NAK)
             {
-                /* Do nothing */
+                /* The master still owns the bus after a NAK, end it like a completed transfer */
+                sercom2I2CBusHeld = true;
             }
-
-
-            SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
-
-            if (sercom2I2CObj.callback != NULL)
+            else
             {
-                sercom2I2CObj.callback(context);
+                /* Generate STOP condition */
+                SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
+
+                SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
             }
+
+            SERCOM2_I2C_QueueComplete(callback, context);
         }
         /* Transfer Complete */
         else if(sercom2I2CObj.state == SERCOM_I2C_STATE_TRANSFER_DONE)
@@ -628,26 +1234,31 @@ void __attribute__((used)) SERCOM2_I2C_InterruptHandler(void)
             /* Reset the PLib objects and interrupts */
             sercom2I2CObj.state = SERCOM_I2C_STATE_IDLE;
             sercom2I2CObj.error = SERCOM_I2C_ERROR_NONE;
+            sercom2I2CBusHeld = true;
 
-            SERCOM2_REGS->I2CM.SERCOM_INTFLAG = (uint8_t)SERCOM_I2CM_INTFLAG_Msk;
-
-            /* Wait for the NAK and STOP bit to be transmitted out and I2C state machine to rest in IDLE state */
-            while((SERCOM2_REGS->I2CM.SERCOM_STATUS & SERCOM_I2CM_STATUS_BUSSTATE_Msk) != SERCOM_I2CM_STATUS_BUSSTATE(0x01U))
-            {
-                /* Do nothing */
-            }
-
-            if(sercom2I2CObj.callback != NULL)
-            {
-                sercom2I2CObj.callback(context);
-            }
-
+            SERCOM2_I2C_QueueComplete(callback, context);
         }
         else
         {
             /* Do nothing */
         }
+
+        if (sercom2I2CBusHeld == true)
+        {
+            /* Nothing was chained with a repeated START: acknowledge action and STOP.
+               The next transfer finds the bus idle or waits for it in thread context. */
+            sercom2I2CBusHeld = false;
+            SERCOM2_REGS->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
+        }
+    }
+
+    isrCycles = SERCOM2_I2C_CyclesSince(isrStart);
+    sercom2I2CStats.isrCalls++;
+    sercom2I2CStats.isrCycles += isrCycles;
+    if (isrCycles > sercom2I2CStats.isrCyclesMax)
+    {
+        sercom2I2CStats.isrCyclesMax = isrCycles;
     }
 
     return;
-}
\ No newline at end of file
+}
@@ -73,6 +73,19 @@
  * this interface.
  */
 
+/* Transactions that can wait in the queue behind the one on the bus */
+#define SERCOM2_I2C_QUEUE_SIZE          4U
+
+/* Busy-wait deadline on the SysTick down-counter, so it also runs out inside an ISR
+   or with interrupts masked where the millisecond tick does not advance */
+typedef struct
+{
+    uint32_t last;
+
+    uint32_t left;
+
+} SERCOM2_I2C_DEADLINE;
+
 void SERCOM2_I2C_Initialize(void);
 
 bool SERCOM2_I2C_Read(uint16_t address, uint8_t* rdData, uint32_t rdLength);
@@ -81,6 +94,8 @@ bool SERCOM2_I2C_Write(uint16_t address, uint8_t* wrData, uint32_t wrLength);
 
 bool SERCOM2_I2C_WriteRead(uint16_t address, uint8_t* wrData, uint32_t wrLength, uint8_t* rdData, uint32_t rdLength);
 
+bool SERCOM2_I2C_WriteVectored(uint16_t address, const SERCOM_I2C_SEGMENT* segments, uint32_t segmentCount);
+
 bool SERCOM2_I2C_IsBusy(void);
 
 SERCOM_I2C_ERROR SERCOM2_I2C_ErrorGet(void);
@@ -92,8 +107,26 @@ bool SERCOM2_I2C_TransferSetup(SERCOM_I2C_TRANSFER_SETUP* setup, uint32_t srcClk
 
 void SERCOM2_I2C_TransferAbort( void );
 
+uint32_t SERCOM2_I2C_TransferCancel(SERCOM_I2C_CALLBACK callback, uintptr_t context);
+
 bool SERCOM2_I2C_BusScan(uint16_t start_addr, uint16_t end_addr, void* pDevicesList, uint8_t* nDevicesFound);
 
+void SERCOM2_I2C_StatisticsGet(SERCOM_I2C_STATISTICS* stats);
+
+void SERCOM2_I2C_StatisticsClear(void);
+
+bool SERCOM2_I2C_BusRecover(void);
+
+bool SERCOM2_I2C_TransferSubmit(const SERCOM_I2C_TRANSACTION* transaction);
+
+uint32_t SERCOM2_I2C_QueueCountGet(void);
+
+void SERCOM2_I2C_Tasks(void);
+
+void SERCOM2_I2C_DeadlineStart(SERCOM2_I2C_DEADLINE* deadline, uint32_t us);
+
+bool SERCOM2_I2C_DeadlineReached(SERCOM2_I2C_DEADLINE* deadline);
+
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
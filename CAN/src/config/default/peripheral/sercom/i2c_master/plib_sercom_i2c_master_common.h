@@ -156,6 +156,9 @@ typedef enum
     /* SERCOM PLib Task Transfer Done State */
     SERCOM_I2C_STATE_TRANSFER_DONE,
 
+    /* SERCOM PLib Task Bus Wait State: transfer set up, START held back until the bus is free */
+    SERCOM_I2C_STATE_BUS_WAIT,
+
 } SERCOM_I2C_STATE;
 
 // *****************************************************************************
@@ -249,6 +252,120 @@ typedef struct
 
 } SERCOM_I2C_TRANSFER_SETUP;
 
+/* clkSpeed values of the supported bus modes; any speed up to the mode limit works */
+#define SERCOM_I2C_SPEED_STANDARD       100000U
+
+#define SERCOM_I2C_SPEED_FAST           400000U
+
+#define SERCOM_I2C_SPEED_FAST_PLUS      1000000U
+
+// *****************************************************************************
+/* SERCOM I2C Statistics
+
+   Summary:
+    Bus traffic counters kept by the PLib.
+
+   Description:
+    Counts of transfers started, bytes clocked on the bus (address bytes
+    included), transfers ended by a NAK or a bus error / arbitration loss,
+    waits that ran into their deadline and bus recoveries (SCL pulses + STOP).
+    The interrupt profile counts handler calls and their CPU cycles (total and
+    worst case) measured on the SysTick counter, callbacks included.
+    The counters wrap; read them with SERCOMx_I2C_StatisticsGet().
+
+   Remarks:
+    None.
+*/
+
+typedef struct
+{
+    uint32_t transfers;
+
+    uint32_t bytes;
+
+    uint32_t naks;
+
+    uint32_t busErrors;
+
+    uint32_t timeouts;
+
+    uint32_t recoveries;
+
+    uint32_t isrCalls;
+
+    uint32_t isrCycles;
+
+    uint32_t isrCyclesMax;
+
+} SERCOM_I2C_STATISTICS;
+
+// *****************************************************************************
+/* SERCOM I2C Write Segment
+
+   Summary:
+    One piece of a scatter-gather write.
+
+   Description:
+    SERCOMx_I2C_WriteVectored() sends a list of these back-to-back inside one
+    START...STOP, so a header and a payload can go out straight from where they
+    are kept without being copied together first. Zero length segments are
+    skipped.
+
+   Remarks:
+    The list and the data must stay valid until the transfer has completed.
+*/
+
+typedef struct
+{
+    uint8_t*                    data;
+
+    size_t                      size;
+
+} SERCOM_I2C_SEGMENT;
+
+// *****************************************************************************
+/* SERCOM I2C Transaction
+
+   Summary:
+    One queued I2C transaction.
+
+   Description:
+    Describes a write, read or write-then-read transfer to one slave together
+    with the callback to run when it completes. The write part is writeBuffer
+    followed by the writeSegmentCount entries of writeSegments, if any. SERCOMx_I2C_TransferSubmit()
+    copies the descriptor into the PLib queue; the data buffers must stay valid
+    until the callback has run. A transaction with nothing to write or read is
+    a zero-length write: the address alone, to see whether a device ACKs it.
+
+   Remarks:
+    The callback is called from the interrupt context, from SERCOMx_I2C_Tasks()
+    when the transfer watchdog ends the transaction, or from
+    SERCOMx_I2C_TransferCancel() with a bus error. SERCOMx_I2C_ErrorGet()
+    returns the result of the transaction while the callback runs.
+*/
+
+typedef struct
+{
+    uint16_t                    address;
+
+    uint8_t*                    writeBuffer;
+
+    uint8_t*                    readBuffer;
+
+    size_t                      writeSize;
+
+    size_t                      readSize;
+
+    const SERCOM_I2C_SEGMENT*   writeSegments;
+
+    uint32_t                    writeSegmentCount;
+
+    SERCOM_I2C_CALLBACK         callback;
+
+    uintptr_t                   context;
+
+} SERCOM_I2C_TRANSACTION;
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -5,7 +5,7 @@
  * 
  * Peripherals:
  *   - UART: SERCOM0 (PA08=TX, PA09=RX) @ 115200 baud
- *   - OLED: SERCOM2 I2C (PA12=SDA, PA13=SCL) @ 100 kHz, SSD1306 128x64
+ *   - OLED: SERCOM2 I2C (PA12=SDA, PA13=SCL) @ 400 kHz, SSD1306 128x64
  *   - ADC:  PA03 (AIN1) for potentiometer
  *   - GPIO: LEDs (PA00-PA01, PA10-PA11), RGB1 (PB09, PA04, PA05)
  *   - GPIO: Buttons SW1 (PB10), SW2 (PA15), Buzzer (PA14)
@@ -14,6 +14,8 @@
  *   - SW1 (ACC): Hold to accelerate (rate depends on throttle)
  *   - SW2 (BRK): Hold to brake (fixed deceleration)
  *   - Potentiometer: Set throttle level (0-100%)
+ *   - UART: console keys, binary telemetry, or an SLCAN (Lawicel) CAN adapter
+ *     for slcand / python-can, see SLCAN.h
  ******************************************************************************/
 
 #include <stddef.h>
@@ -28,7 +30,10 @@
  ******************************************************************************/
 #define CPU_FREQ        8000000UL
 #define BUZZER_ENABLED  0           /* Set to 1 to enable buzzer feedback */
-#define UPDATE_INTERVAL 200         /* Main loop update interval (ms) */
+#define UPDATE_INTERVAL 200         /* Vehicle simulation and CAN frame interval (ms) */
+#define CONSOLE_INTERVAL 20         /* Main loop and terminal refresh interval (ms) */
+#define STATS_INTERVAL  1000        /* Statistics block refresh interval (ms) */
+#define I2C_SPEED_HZ    SERCOM_I2C_SPEED_FAST   /* OLED bus: _STANDARD, _FAST or _FAST_PLUS */
 
 /*******************************************************************************
  * LED MACROS (Active-Low)
@@ -62,6 +67,7 @@ static void delay_ms(uint32_t ms) {
  ******************************************************************************/
 static void print(const char* s);
 static void println(const char* s);
+static void show_layout(void);
 
 /*******************************************************************************
  * OLED DISPLAY
@@ -69,53 +75,35 @@ static void println(const char* s);
 #include "OLED128x64.h"
 #define OLED_STANDALONE 1
 #include "OLED128x64.c"
+#include "FORMAT.c"
+#include "I2C_DEVICE.c"
+#include "TERMINAL.c"
+#include "TELEMETRY.c"
+#include "SLCAN.c"
 
 static char oled_buf[24];
 
-static void int_to_str(int32_t val, char* buf, int width) {
-    int len = 0, neg = 0;
-    char temp[12];
-    
-    if(val < 0) { neg = 1; val = -val; }
-    if(val == 0) { temp[len++] = '0'; }
-    else { while(val > 0) { temp[len++] = '0' + (val % 10); val /= 10; } }
-    
-    int pad = width - len - neg;
-    int i = 0;
-    while(pad-- > 0) buf[i++] = ' ';
-    if(neg) buf[i++] = '-';
-    while(len > 0) buf[i++] = temp[--len];
-    buf[i] = '\0';
-}
-
-static void hex_to_str(uint16_t val, char* buf, int digits) {
-    const char hex[] = "0123456789ABCDEF";
-    for(int i = digits - 1; i >= 0; i--) {
-        buf[digits - 1 - i] = hex[(val >> (i * 4)) & 0xF];
-    }
-    buf[digits] = '\0';
-}
-
 static void oled_update_display(uint16_t rpm_val, uint8_t speed_val, uint8_t thr_val,
                                 bool acc_on, bool brk_on,
                                 uint16_t can_id, uint8_t dlc, uint8_t* data, uint16_t crc_val) {
-    /* Line 0: Title */
-    OLED_Put6x8Str(16, 0, (const uint8_t*)"CAN BUS MONITOR");
+    /* Line 0: Title, inverted */
+    OLED_FillRect(0, 0, 16, 8, WHITE);
+    OLED_PutStr(16, 0, (const uint8_t*)"CAN BUS MONITOR", OLED_FONT_6X8 | OLED_TEXT_INVERSE);
+    OLED_FillRect(106, 0, 22, 8, WHITE);
     OLED_Put6x8Str(0, 1, (const uint8_t*)"---------------------");
     
     /* Line 2-3: RPM (large font) */
     OLED_Put6x8Str(0, 2, (const uint8_t*)"RPM:");
-    int_to_str(rpm_val, oled_buf, 5);
-    OLED_Put8x16Str(30, 2, (const uint8_t*)oled_buf);
+    FMT_IntW(oled_buf, rpm_val, 5);
+    OLED_PutStr(30, 2, (const uint8_t*)oled_buf, OLED_FONT_SEG7);
     
     /* Line 4: Speed + Throttle */
     OLED_Put6x8Str(0, 4, (const uint8_t*)"SPD:");
-    int_to_str(speed_val, oled_buf, 3);
+    FMT_IntW(oled_buf, speed_val, 3);
     OLED_Put6x8Str(24, 4, (const uint8_t*)oled_buf);
     OLED_Put6x8Str(48, 4, (const uint8_t*)"km/h");
     OLED_Put6x8Str(78, 4, (const uint8_t*)"T:");
-    int_to_str(thr_val, oled_buf, 3);
-    strcat(oled_buf, "%");
+    FMT_Str(&oled_buf[FMT_IntW(oled_buf, thr_val, 3)], "%");
     OLED_Put6x8Str(90, 4, (const uint8_t*)oled_buf);
     
     /* Line 5: Button status */
@@ -125,23 +113,40 @@ static void oled_update_display(uint16_t rpm_val, uint8_t speed_val, uint8_t thr
     OLED_Put6x8Str(78, 5, brk_on ? (const uint8_t*)"[*]" : (const uint8_t*)"[ ]");
     
     /* Line 6: CAN frame data */
-    hex_to_str(can_id, oled_buf, 3);
+    FMT_Hex(oled_buf, can_id, 3);
     OLED_Put6x8Str(0, 6, (const uint8_t*)oled_buf);
     OLED_Put6x8Str(18, 6, (const uint8_t*)":");
     for(int i = 0; i < dlc && i < 2; i++) {
-        hex_to_str(data[i], oled_buf, 2);
+        FMT_Hex(oled_buf, data[i], 2);
         OLED_Put6x8Str(24 + i * 12, 6, (const uint8_t*)oled_buf);
     }
     OLED_Put6x8Str(54, 6, (const uint8_t*)"CRC:");
-    hex_to_str(crc_val, oled_buf, 4);
+    FMT_Hex(oled_buf, crc_val, 4);
     OLED_Put6x8Str(78, 6, (const uint8_t*)oled_buf);
     
-    /* Line 7: Footer */
-    OLED_Put6x8Str(0, 7, (const uint8_t*)"---------------------");
+    /* Line 7: Throttle bar graph */
+    OLED_FillRect(0, 56, 128, 8, BLACK);
+    OLED_DrawBar(0, 57, 128, 6, thr_val, 100);
+    
+    /* Everything above only touched the back buffer; hand the finished frame to
+       the I2C interrupt. If the previous frame is still on the bus this one stays
+       in the back buffer and goes out with the next call. */
+    (void)OLED_SwapBuffers();
+}
+
+/* Panel presence, kept by the background bus scan. The callback runs in the SERCOM2
+   interrupt, the main loop re-initializes a panel that was plugged (back) in. */
+static I2C_DEVICE oled_dev = I2C_DEVICE_INIT_NOCACHE(OLED_ADDRESS, I2C_DEV_REG8);
+static volatile bool oled_present, oled_reinit;
+
+static void i2c_presence_changed(uint8_t address, bool present) {
+    if(address == OLED_ADDRESS) {
+        oled_present = present;
+        oled_reinit = present;
+    }
 }
 
 static void oled_init_display(void) {
-    delay_ms(100);
     OLED_Init();
     OLED_CLS();
     delay_ms(10);
@@ -150,6 +155,7 @@ static void oled_init_display(void) {
     OLED_Put8x16Str(8, 1, (const uint8_t*)"NCUExMICROCHIP");
     OLED_Put8x16Str(8, 3, (const uint8_t*)"CAN Simulation");
     OLED_Put6x8Str(22, 6, (const uint8_t*)"PIC32CM3204GV");
+    OLED_Flush();
     delay_ms(1500);
     OLED_CLS();
 }
@@ -157,44 +163,173 @@ static void oled_init_display(void) {
 /*******************************************************************************
  * UART FUNCTIONS
  ******************************************************************************/
-static void uart_putc(char c) {
-    uint32_t timeout = 50000;
-    while(!(SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_DRE_Msk)) {
-        if(--timeout == 0) return;
-    }
-    SERCOM0_REGS->USART_INT.SERCOM_DATA = c;
+/* Output is copied into the SERCOM0 write ring and sent by the DRE interrupt.
+   SLCAN replies are written from the receive interrupt and SERCOM0_USART_Write()
+   is not reentrant, so every writer in the main loop (print, terminal, telemetry,
+   SLCAN frames) goes through uart_tx() with the SERCOM0 interrupt masked: a reply
+   waits until the copy is done and never lands inside another write.
+   A newline also erases the rest of the line, so blocks can be redrawn in place. */
+static size_t uart_tx(const void* buffer, size_t size) {
+    size_t n;
+    NVIC_DisableIRQ(SERCOM0_IRQn);
+    n = SERCOM0_USART_Write(buffer, size);
+    NVIC_EnableIRQ(SERCOM0_IRQn);
+    return n;
 }
 
+static void uart_write(const char* s, size_t n) { (void)uart_tx(s, n); }
+
 static void print(const char* s) {
-    while(*s) { if(*s == '\n') uart_putc('\r'); uart_putc(*s++); }
+    const char* p = s;
+    for(; *p; p++) {
+        if(*p == '\n') { uart_write(s, p - s); uart_write("\033[K\r\n", 5); s = p + 1; }
+    }
+    uart_write(s, p - s);
 }
 
 static void println(const char* s) { print(s); print("\n"); }
 
-static void print_int(int32_t v) {
-    char buf[12]; int i = 0;
-    if(v < 0) { uart_putc('-'); v = -v; }
-    if(v == 0) { uart_putc('0'); return; }
-    while(v > 0) { buf[i++] = '0' + (v % 10); v /= 10; }
-    while(i > 0) uart_putc(buf[--i]);
+/* Received bytes are parsed in the SERCOM0 receive interrupt: SLCAN commands are
+   answered there, console keys are queued for console_poll(). Bytes SLCAN holds as
+   a possible opening command are handed back once the line has been quiet for
+   SLCAN_HOLD_MS, a tool sends its command line in one go. */
+#define KEY_QUEUE_SIZE 8U
+#define SLCAN_HOLD_MS  50U
+
+static volatile uint8_t key_queue[KEY_QUEUE_SIZE];
+static volatile uint8_t key_in, key_out;
+static volatile uint32_t uart_rx_tick;
+
+static void key_put(uint8_t c) {
+    uint8_t next = (key_in + 1U) % KEY_QUEUE_SIZE;
+    if(next != key_out) { key_queue[key_in] = c; key_in = next; }
 }
 
-static void print_hex(uint16_t v, int digits) {
-    const char hex[] = "0123456789ABCDEF";
-    print("0x");
-    for(int i = (digits-1)*4; i >= 0; i -= 4) uart_putc(hex[(v >> i) & 0xF]);
+static void uart_rx_callback(SERCOM_USART_EVENT event, uintptr_t context) {
+    uint8_t c;
+    if(event != SERCOM_USART_EVENT_READ_THRESHOLD_REACHED) return;
+    while(SERCOM0_USART_Read(&c, 1) != 0U) SLCAN_Input(c);
+    uart_rx_tick = SYSTICK_GetTickCounter();
 }
 
-static void print_pad(int32_t v, int width) {
-    int len = 0; int32_t temp = v;
-    if(temp == 0) len = 1;
-    else { if(temp < 0) { len++; temp = -temp; } while(temp > 0) { len++; temp /= 10; } }
-    print_int(v);
-    for(int i = len; i < width; i++) uart_putc(' ');
+static bool key_get(uint8_t* c) {
+    if(key_out == key_in) return false;
+    *c = key_queue[key_out];
+    key_out = (key_out + 1U) % KEY_QUEUE_SIZE;
+    return true;
+}
+
+static void print_int(int32_t v) {
+    char buf[12];
+    uart_write(buf, FMT_Int(buf, v));
 }
 
 static void clear(void) { print("\033[2J\033[H"); }
 
+/*******************************************************************************
+ * REFRESH INSTRUMENTATION
+ ******************************************************************************/
+static uint32_t oled_us_last, oled_us_max, oled_us_sum, oled_frames;
+static uint32_t uart_us_last, uart_us_max;
+static bool     show_stats_on = false;
+static bool     telemetry_on = false;       /* binary records instead of the screen */
+static bool     telemetry_burst = false;
+
+/* Console rows below the status screen: statistics and benchmark output */
+#define ROW_STATS 26
+
+/* Microseconds since start-up: 1 ms SysTick ticks plus the part of the current tick
+   already counted down. Re-read if the tick interrupt fired in between. */
+static uint32_t time_us(void) {
+    uint32_t ms, cnt;
+    do {
+        ms = SYSTICK_GetTickCounter();
+        cnt = SYSTICK_TimerCounterGet();
+    } while(ms != SYSTICK_GetTickCounter());
+    return ms * 1000U + (SYSTICK_TimerPeriodGet() - cnt) / (CPU_FREQ / 1000000U);
+}
+
+static void stats_clear(void) {
+    oled_us_last = 0; oled_us_max = 0; oled_us_sum = 0; oled_frames = 0;
+    uart_us_last = 0; uart_us_max = 0;
+    OLED_StatsClear();
+    SERCOM0_USART_StatisticsClear();
+    SERCOM2_I2C_StatisticsClear();
+    TELEM_StatsClear();
+    SLCAN_StatsClear();
+}
+
+static void print_isr_profile(const SERCOM_I2C_STATISTICS* i2c) {
+    print("  SERCOM2 ISR:    "); print_int(i2c->isrCalls); print(" calls  max ");
+    print_int(i2c->isrCyclesMax); print(" cycles  avg ");
+    print_int(i2c->isrCalls ? i2c->isrCycles / i2c->isrCalls : 0); println(" cycles");
+}
+
+/* I2C benchmark: full-screen refreshes (every byte of GDDRAM rewritten) with the
+   SERCOM2 interrupt profile, so ISR changes can be compared cycle for cycle */
+#define I2C_BENCH_FRAMES 16U
+
+static void i2c_benchmark(void) {
+    SERCOM_I2C_STATISTICS i2c;
+    uint32_t t0, t;
+
+    SERCOM2_I2C_StatisticsClear();
+    t0 = time_us();
+    for(uint32_t i = 0; i < I2C_BENCH_FRAMES; i++) {
+        OLED_Invalidate();
+        OLED_Flush();
+    }
+    t = time_us() - t0;
+    SERCOM2_I2C_StatisticsGet(&i2c);
+    println("------------------------------------------------------------");
+    print("I2C BENCHMARK: "); print_int(I2C_BENCH_FRAMES); print(" full frames in ");
+    print_int(t); print(" us, "); print_int(i2c.bytes); println(" bytes");
+    print_isr_profile(&i2c);
+    println("");
+}
+
+/* Console query: 's' toggles the statistics block, 'c' clears the counters,
+   'b' runs the I2C benchmark, 'r' redraws the screen (e.g. after connecting),
+   't' switches between the screen and the binary telemetry stream. While the
+   stream runs only 't', 'c' and 'b' (a burst of records at line rate) work.
+   Keys work in either case; 's'/'S' can come up to SLCAN_HOLD_MS late, SLCAN
+   holds them as a possible opening command until the line stays quiet.
+   While SLCAN is active no keys arrive here, ESC hands them back. */
+static void console_poll(void) {
+    uint8_t c;
+    if(SYSTICK_GetTickCounter() - uart_rx_tick > SLCAN_HOLD_MS) {
+        NVIC_DisableIRQ(SERCOM0_IRQn);
+        SLCAN_Idle();
+        NVIC_EnableIRQ(SERCOM0_IRQn);
+    }
+    while(key_get(&c)) {
+        if(c == 't' || c == 'T') {
+            telemetry_on = !telemetry_on;
+            if(telemetry_on) TELEM_Start(); else show_layout();
+            continue;
+        }
+        if(telemetry_on) {
+            if(c == 'c' || c == 'C') stats_clear();
+            if(c == 'b' || c == 'B') telemetry_burst = true;
+            continue;
+        }
+        switch(c) {
+            case 's': case 'S':
+                show_stats_on = !show_stats_on;
+                TERM_ClearFrom(ROW_STATS);
+                break;
+            case 'c': case 'C': stats_clear(); break;
+            case 'b': case 'B':
+                show_stats_on = false;
+                TERM_ClearFrom(ROW_STATS);
+                i2c_benchmark();
+                break;
+            case 'r': case 'R': show_layout(); break;
+            default: break;
+        }
+    }
+}
+
 /*******************************************************************************
  * RGB1 LED (Common Cathode: HIGH = ON)
  ******************************************************************************/
@@ -348,56 +483,222 @@ static void update(void) {
 /*******************************************************************************
  * TERMINAL DISPLAY
  ******************************************************************************/
-static void show_title(void) {
-    println("");
-    println("============================================================");
-    println("           CAN BUS PROTOCOL - EDUCATIONAL SIMULATION");
-    println("============================================================");
-    println("");
+/* The static text is drawn once; every pass only updates the fields whose
+   values changed, a few dozen bytes instead of the whole screen */
+#define ROW_STATUS  9
+#define ROW_FRAMES  18
+#define ROW_CALC    22
+
+static const struct {
+    uint16_t    id;
+    uint8_t     dlc;
+    const char* name;
+} can_msgs[3] = {
+    { 0x0C0, 2, "ENGINE_RPM" },
+    { 0x0D0, 1, "VEHICLE_SPEED" },
+    { 0x0F0, 2, "THROTTLE_BRAKE" },
+};
+
+TERM_FIELD_DEFINE(f_rpm,      ROW_STATUS + 0, 19, 5);
+TERM_FIELD_DEFINE(f_speed,    ROW_STATUS + 1, 19, 3);
+TERM_FIELD_DEFINE(f_throttle, ROW_STATUS + 2, 19, 3);
+TERM_FIELD_DEFINE(f_brake,    ROW_STATUS + 3, 19, 8);
+TERM_FIELD_DEFINE(f_mode,     ROW_STATUS + 4, 19, 9);
+TERM_FIELD_DEFINE(f_sw1,      ROW_STATUS + 5, 8, 7);
+TERM_FIELD_DEFINE(f_sw2,      ROW_STATUS + 5, 26, 7);
+TERM_FIELD_DEFINE(f_mark0,    ROW_FRAMES + 0, 3, 1);
+TERM_FIELD_DEFINE(f_mark1,    ROW_FRAMES + 1, 3, 1);
+TERM_FIELD_DEFINE(f_mark2,    ROW_FRAMES + 2, 3, 1);
+TERM_FIELD_DEFINE(f_data0,    ROW_FRAMES + 0, 34, 10);
+TERM_FIELD_DEFINE(f_data1,    ROW_FRAMES + 1, 34, 10);
+TERM_FIELD_DEFINE(f_data2,    ROW_FRAMES + 2, 34, 10);
+TERM_FIELD_DEFINE(f_crc0,     ROW_FRAMES + 0, 46, 6);
+TERM_FIELD_DEFINE(f_crc1,     ROW_FRAMES + 1, 46, 6);
+TERM_FIELD_DEFINE(f_crc2,     ROW_FRAMES + 2, 46, 6);
+TERM_FIELD_DEFINE(f_calc0,    ROW_CALC + 0, 44, 23);
+TERM_FIELD_DEFINE(f_calc1,    ROW_CALC + 1, 44, 8);
+TERM_FIELD_DEFINE(f_calc2,    ROW_CALC + 2, 44, 13);
+
+static TERM_FIELD* const f_mark[3] = { &f_mark0, &f_mark1, &f_mark2 };
+static TERM_FIELD* const f_data[3] = { &f_data0, &f_data1, &f_data2 };
+static TERM_FIELD* const f_crc[3]  = { &f_crc0, &f_crc1, &f_crc2 };
+
+#define LINE_DOUBLE "============================================================"
+#define LINE_SINGLE "------------------------------------------------------------"
+
+/* A full redraw is larger than the write ring: wait for room only while it is written,
+   the per-pass updates after it must never stall the main loop */
+static void show_layout(void) {
+    char buf[8];
+
+    SERCOM0_USART_WriteBlockingSet(true);
+    TERM_Clear();
+    TERM_Text(1, 1, LINE_DOUBLE);
+    TERM_Text(2, 1, "           CAN BUS PROTOCOL - EDUCATIONAL SIMULATION");
+    TERM_Text(3, 1, LINE_DOUBLE);
+    TERM_Text(4, 1, "CONTROLS:  [SW1] Hold = ACCELERATE    [SW2] Hold = BRAKE");
+    TERM_Text(5, 1, "           [POT] Turn = Set throttle level (0-100%)");
+    TERM_Text(6, 1, "           [UART] s stats, c clear, b I2C bench, r redraw, t telemetry");
+    TERM_Text(7, 1, LINE_SINGLE);
+    TERM_Text(8, 1, "VEHICLE STATUS:");
+    TERM_Text(ROW_STATUS + 0, 3, "Engine RPM:");
+    TERM_Text(ROW_STATUS + 1, 3, "Speed:");
+    TERM_Text(ROW_STATUS + 1, 23, "km/h");
+    TERM_Text(ROW_STATUS + 2, 3, "Throttle:");
+    TERM_Text(ROW_STATUS + 2, 23, "%");
+    TERM_Text(ROW_STATUS + 3, 3, "Brake:");
+    TERM_Text(ROW_STATUS + 4, 3, "Mode:");
+    TERM_Text(ROW_STATUS + 5, 3, "SW1:");
+    TERM_Text(ROW_STATUS + 5, 21, "SW2:");
+    TERM_Text(15, 1, LINE_SINGLE);
+    TERM_Text(16, 1, "CAN FRAMES:                                * = last transmitted");
+    TERM_Text(17, 5, "ID     Message          DLC  Data        CRC-15");
+    for(int i = 0; i < 3; i++) {
+        FMT_Hex(&buf[FMT_Str(buf, "0x")], can_msgs[i].id, 3);
+        TERM_Text(ROW_FRAMES + i, 5, buf);
+        TERM_Text(ROW_FRAMES + i, 12, can_msgs[i].name);
+        FMT_UInt(buf, can_msgs[i].dlc);
+        TERM_Text(ROW_FRAMES + i, 29, buf);
+    }
+    TERM_Text(ROW_CALC + 0, 3, "RPM      = (Data[0] << 8) | Data[1]   =");
+    TERM_Text(ROW_CALC + 1, 3, "Speed    = Data[0]                    =");
+    TERM_Text(ROW_CALC + 2, 3, "Throttle = Data[0], Brake = Data[1]   =");
+    TERM_Text(25, 1, LINE_DOUBLE);
+    TERM_MoveTo(ROW_STATS, 1);
+    SERCOM0_USART_WriteBlockingSet(false);
 }
 
-static void show_controls(void) {
-    println("CONTROLS:");
-    println("  [SW1] Hold = ACCELERATE    [SW2] Hold = BRAKE");
-    println("  [POT] Turn = Set throttle level (0-100%)");
-    println("");
+static void show_status(void) {
+    TERM_FieldInt(&f_rpm, rpm);
+    TERM_FieldInt(&f_speed, speed);
+    TERM_FieldInt(&f_throttle, throttle);
+    TERM_FieldText(&f_brake, brake ? "ENGAGED" : "Released");
+    TERM_FieldText(&f_mode, manual ? "MANUAL" : "AUTO DEMO");
+    TERM_FieldText(&f_sw1, sw1() ? "PRESSED" : "---");
+    TERM_FieldText(&f_sw2, sw2() ? "PRESSED" : "---");
 }
 
-static void show_status(void) {
-    println("------------------------------------------------------------");
-    println("VEHICLE STATUS:");
-    println("");
-    print("  Engine RPM:     "); print_pad(rpm, 6); println("");
-    print("  Speed:          "); print_pad(speed, 3); println(" km/h");
-    print("  Throttle:       "); print_pad(throttle, 3); println(" %");
-    print("  Brake:          "); println(brake ? "ENGAGED" : "Released");
-    print("  Mode:           "); println(manual ? "MANUAL" : "AUTO DEMO");
-    println("");
-    print("  SW1: "); print(sw1() ? "PRESSED  " : "---      ");
-    print("  SW2: "); println(sw2() ? "PRESSED" : "---");
-    println("");
+static void show_can(uint8_t msg, uint8_t* data, uint16_t crc) {
+    char buf[24];
+    char* p = buf;
+
+    for(int i = 0; i < 3; i++) TERM_FieldText(f_mark[i], (i == msg) ? "*" : " ");
+
+    *p = '\0';
+    for(int i = 0; i < can_msgs[msg].dlc; i++) {
+        p += FMT_Str(p, "0x");
+        p += FMT_Hex(p, data[i], 2);
+        p += FMT_Str(p, " ");
+    }
+    TERM_FieldText(f_data[msg], buf);
+    TERM_FieldHex(f_crc[msg], crc, 4);
+
+    /* The formula worked out with this frame's bytes */
+    switch(msg) {
+        case 0:
+            p = buf;
+            p += FMT_Str(p, "(");
+            p += FMT_Int(p, data[0]);
+            p += FMT_Str(p, " x 256) + ");
+            p += FMT_Int(p, data[1]);
+            p += FMT_Str(p, " = ");
+            FMT_Int(p, rpm);
+            TERM_FieldText(&f_calc0, buf);
+            break;
+        case 1:
+            FMT_Str(&buf[FMT_Int(buf, speed)], " km/h");
+            TERM_FieldText(&f_calc1, buf);
+            break;
+        default:
+            FMT_Str(&buf[FMT_Int(buf, throttle)], data[1] ? "%, ON (1)" : "%, OFF (0)");
+            TERM_FieldText(&f_calc2, buf);
+            break;
+    }
 }
 
-static void show_can(uint16_t id, const char* name, uint8_t dlc, uint8_t* data) {
-    LED1_ON();
-#if BUZZER_ENABLED
-    beep(3000, 5);
-#endif
-    
-    println("------------------------------------------------------------");
-    println("CAN FRAME TRANSMITTED:");
-    println("");
-    print("  Message:        "); println(name);
-    print("  CAN ID:         "); print_hex(id, 3); println("");
-    print("  Data Length:    "); print_int(dlc); println(" bytes");
-    print("  Data Bytes:     ");
-    for(int i = 0; i < dlc; i++) { print_hex(data[i], 2); print(" "); }
+static void show_stats(void) {
+    OLED_STATS oled;
+    SERCOM_I2C_STATISTICS i2c;
+    SERCOM_USART_RING_BUFFER_STATISTICS uart;
+    USART_BAUD_SETTING baud;
+    TELEM_STATS tel;
+    SLCAN_STATS slcan;
+
+    OLED_StatsGet(&oled);
+    SERCOM2_I2C_StatisticsGet(&i2c);
+    SERCOM0_USART_StatisticsGet(&uart);
+    SERCOM0_USART_BaudSettingGet(&baud);
+    TELEM_StatsGet(&tel);
+    SLCAN_StatsGet(&slcan);
+    TERM_MoveTo(ROW_STATS, 1);
+    println("OLED REFRESH STATISTICS:");
     println("");
-    print("  CRC-15:         "); print_hex(crc15(id, dlc, data), 4); println("");
+    print("  Frames:         "); print_int(oled_frames);
+    print("   swapped "); print_int(oled.swaps);
+    print("   skipped (bus busy) "); print_int(oled.swapsBusy); println("");
+    print("  Update time us: last "); print_int(oled_us_last);
+    print("   max "); print_int(oled_us_max);
+    print("   avg "); print_int(oled_frames ? oled_us_sum / oled_frames : 0); println("");
+    print("  OLED I2C:       "); print_int(oled.transactions); print(" writes  ");
+    print_int(oled.bytes); print(" bytes  ");
+    print_int(oled.naks); print(" NAK  ");
+    print_int(oled.timeouts); println(" timeouts");
+    print("  SERCOM2:        "); print_int(i2c.transfers); print(" transfers  ");
+    print_int(i2c.bytes); print(" bytes  ");
+    print_int(i2c.naks); print(" NAK  ");
+    print_int(i2c.busErrors); println(" bus errors");
+    print("                  "); print_int(i2c.timeouts); print(" timeouts  ");
+    print_int(i2c.recoveries); println(" bus recoveries");
+    print_isr_profile(&i2c);
+    print("  Console us:     last "); print_int(uart_us_last);
+    print("   max "); print_int(uart_us_max); println("");
+    print("  SERCOM0 TX:     "); print_int(uart.txBytes); print(" bytes  peak ");
+    print_int(uart.txHighWater); print("/"); print_int(SERCOM0_USART_WriteBufferSizeGet());
+    print("  "); print_int(uart.txBlocked); print(" blocked  ");
+    print_int(uart.txDropped); println(" dropped");
+    print("  SERCOM0 RX:     "); print_int(uart.rxBytes); print(" bytes  peak ");
+    print_int(uart.rxHighWater); print("  "); print_int(uart.rxDropped); print(" dropped  ");
+    print_int(uart.rxErrors); println(" errors");
+    print("  SERCOM0 baud:   "); print_int(baud.baudRate); print(" (BAUD ");
+    print_int(baud.baudValue); print(")  error "); print_int(baud.errorPpm); println(" ppm");
+    print("  Telemetry:      "); print_int(tel.records); print(" records  ");
+    print_int(tel.bytes); print(" bytes  "); print_int(tel.dropped); println(" dropped");
+    print("  SLCAN:          "); print_int(slcan.frames); print(" frames  ");
+    print_int(slcan.dropped); print(" dropped  "); print_int(slcan.commands); print(" commands  ");
+    print_int(slcan.errors); println(" refused");
     println("");
-    
-    delay_ms(50);
-    LED1_OFF();
+}
+
+/*******************************************************************************
+ * BINARY TELEMETRY
+ ******************************************************************************/
+/* The last CAN frame with the vehicle state, one record per frame. A record that
+   does not fit in the write ring is dropped whole, the decoder sees the gap. */
+#define TELEMETRY_BURST     1000U
+
+static TELEM_CAN_RECORD tel_rec;
+
+static void telemetry_frame(uint16_t id, uint8_t dlc, uint8_t* data, uint16_t crc) {
+    tel_rec.time = time_us();
+    tel_rec.id = id;
+    tel_rec.dlc = dlc;
+    memcpy(tel_rec.data, data, dlc);
+    tel_rec.crc15 = crc;
+    tel_rec.rpm = rpm;
+    tel_rec.speed = speed;
+    tel_rec.throttle = throttle;
+    tel_rec.flags = (brake ? TELEM_FLAG_BRAKE : 0) | (manual ? TELEM_FLAG_MANUAL : 0)
+                  | (sw1() ? TELEM_FLAG_SW1 : 0) | (sw2() ? TELEM_FLAG_SW2 : 0);
+    (void)TELEM_SendCan(&tel_rec, false);
+}
+
+/* The last frame again, back to back, waiting for room: the decoder's rate from
+   the timestamps is what the link sustains */
+static void telemetry_burst_send(void) {
+    for(uint32_t i = 0; i < TELEMETRY_BURST; i++) {
+        tel_rec.time = time_us();
+        (void)TELEM_SendCan(&tel_rec, true);
+    }
 }
 
 /*******************************************************************************
@@ -405,6 +706,20 @@ static void show_can(uint16_t id, const char* name, uint8_t dlc, uint8_t* data)
  ******************************************************************************/
 int main(void) {
     SYS_Initialize(NULL);
+    SYSTICK_TimerStart();
+    /* The start-up text is larger than the write ring: wait for room rather than
+       drop the tail of it. The first show_layout() switches this off again. */
+    SERCOM0_USART_WriteBlockingSet(true);
+    TERM_Init(uart_tx);
+    TELEM_Init(uart_tx, SERCOM0_USART_WriteFreeBufferCountGet);
+    SLCAN_Init(uart_tx, SERCOM0_USART_WriteFreeBufferCountGet, key_put);
+    SERCOM0_USART_ReadCallbackRegister(uart_rx_callback, 0);
+    (void)SERCOM0_USART_ReadNotificationEnable(true, true);
+    
+    /* SERCOM2 starts at 100 kHz; the SSD1306 takes Fast-mode, which cuts the
+       refresh time per byte to a quarter (Fm+ is limited to ~625 kHz at 8 MHz) */
+    SERCOM_I2C_TRANSFER_SETUP i2c_setup = { .clkSpeed = I2C_SPEED_HZ };
+    SERCOM2_I2C_TransferSetup(&i2c_setup, 0);
     btn_init();
     ADC_Enable();
     rgb_init();
@@ -441,8 +756,15 @@ int main(void) {
     print("  ADC:     "); print_int(read_pot()); println("%");
     
     print("  OLED:    ");
-    oled_init_display();
-    println("OK");
+    delay_ms(100);                  /* panel power-up */
+    if(I2C_DevProbe(&oled_dev)) {
+        oled_present = true;
+        oled_init_display();
+        println("OK");
+    } else {
+        println("not found (initialized when connected)");
+    }
+    I2C_ScanStart(i2c_presence_changed);
     
     println("");
     println("System ready. Starting simulation...");
@@ -460,66 +782,96 @@ int main(void) {
     uint16_t current_can_id = 0x0C0;
     uint8_t current_dlc = 2;
     uint16_t current_crc = 0;
+    uint32_t pass = 0, stats_pass = 0;
+    bool slcan_on = false;
+    
+    show_layout();
     
+    /* The terminal refreshes every CONSOLE_INTERVAL; the vehicle, the CAN frame and
+       the OLED advance on every UPDATE_INTERVAL / CONSOLE_INTERVAL-th pass */
     while(1) {
-        update();
-        clear();
-        show_title();
-        show_controls();
-        show_status();
+        bool tick = (pass == 0);
         
-        /* Cycle through CAN messages */
-        switch(msg) {
-            case 0: /* Engine RPM */
-                data[0] = (rpm >> 8) & 0xFF;
-                data[1] = rpm & 0xFF;
-                current_can_id = 0x0C0;
-                current_dlc = 2;
-                current_crc = crc15(current_can_id, current_dlc, data);
-                show_can(0x0C0, "ENGINE_RPM", 2, data);
-                print("  Formula:        RPM = (Data[0] << 8) | Data[1]\n");
-                print("  Calculation:    RPM = (");
-                print_int(data[0]); print(" x 256) + ");
-                print_int(data[1]); print(" = ");
-                print_int(rpm); println("");
-                println("");
-                break;
-                
-            case 1: /* Vehicle Speed */
-                data[0] = speed;
-                current_can_id = 0x0D0;
-                current_dlc = 1;
-                current_crc = crc15(current_can_id, current_dlc, data);
-                show_can(0x0D0, "VEHICLE_SPEED", 1, data);
-                print("  Formula:        Speed = Data[0]\n");
-                print("  Calculation:    Speed = ");
-                print_int(speed); println(" km/h");
-                println("");
-                break;
-                
-            case 2: /* Throttle/Brake */
-                data[0] = throttle;
-                data[1] = brake ? 1 : 0;
-                current_can_id = 0x0F0;
-                current_dlc = 2;
-                current_crc = crc15(current_can_id, current_dlc, data);
-                show_can(0x0F0, "THROTTLE_BRAKE", 2, data);
-                println("  Formula:        Throttle = Data[0], Brake = Data[1]");
-                print("  Calculation:    Throttle = ");
-                print_int(throttle); print("%, Brake = ");
-                println(brake ? "ON (1)" : "OFF (0)");
-                println("");
-                break;
+        LED1_OFF();
+        console_poll();
+        SERCOM2_I2C_Tasks();
+        
+        /* SLCAN took over or handed the console back (ESC) */
+        if(SLCAN_IsActive() != slcan_on) {
+            slcan_on = !slcan_on;
+            telemetry_on = false;
+            if(!slcan_on) show_layout();
         }
         
-        println("============================================================");
+        if(tick) {
+            update();
+            I2C_ScanTask();
+            
+            /* Cycle through CAN messages */
+            switch(msg) {
+                case 0: /* Engine RPM */
+                    data[0] = (rpm >> 8) & 0xFF;
+                    data[1] = rpm & 0xFF;
+                    break;
+                case 1: /* Vehicle Speed */
+                    data[0] = speed;
+                    break;
+                case 2: /* Throttle/Brake */
+                    data[0] = throttle;
+                    data[1] = brake ? 1 : 0;
+                    break;
+            }
+            current_can_id = can_msgs[msg].id;
+            current_dlc = can_msgs[msg].dlc;
+            current_crc = crc15(current_can_id, current_dlc, data);
+            LED1_ON();
+#if BUZZER_ENABLED
+            beep(3000, 5);
+#endif
+        }
         
-        /* Update OLED */
-        oled_update_display(rpm, speed, throttle, sw1(), sw2(),
-                           current_can_id, current_dlc, data, current_crc);
+        /* Terminal or telemetry, timed: only the fields that changed go out */
+        uint32_t t_uart = time_us();
+        if(slcan_on) {
+            if(tick) (void)SLCAN_Frame(current_can_id, current_dlc, data, SYSTICK_GetTickCounter());
+        } else if(telemetry_on) {
+            if(tick) telemetry_frame(current_can_id, current_dlc, data, current_crc);
+            if(telemetry_burst) { telemetry_burst = false; telemetry_burst_send(); }
+        } else {
+            if(tick) show_can(msg, data, current_crc);
+            show_status();
+            if(show_stats_on && tick && ++stats_pass >= STATS_INTERVAL / UPDATE_INTERVAL) {
+                stats_pass = 0;
+                show_stats();
+            }
+        }
+        uart_us_last = time_us() - t_uart;
+        if(uart_us_last > uart_us_max) uart_us_max = uart_us_last;
+        
+        if(tick) {
+            /* Panel (re)connected: power-up sequence once the last frame is off the bus.
+               OLED_Init() clears the frame buffer, the update below redraws it all. */
+            if(oled_reinit && !OLED_IsBusy()) {
+                oled_reinit = false;
+                OLED_Init();
+            }
+            
+            /* Update OLED, timed: render + diff + start of the background transfer */
+            if(oled_present) {
+                uint32_t t0 = time_us();
+                oled_update_display(rpm, speed, throttle, sw1(), sw2(),
+                                   current_can_id, current_dlc, data, current_crc);
+                oled_us_last = time_us() - t0;
+                if(oled_us_last > oled_us_max) oled_us_max = oled_us_last;
+                oled_us_sum += oled_us_last;
+                oled_frames++;
+            }
+            
+            msg = (msg + 1) % 3;
+        }
         
-        msg = (msg + 1) % 3;
-        delay_ms(UPDATE_INTERVAL);
+        if(++pass >= UPDATE_INTERVAL / CONSOLE_INTERVAL) pass = 0;
+        delay_ms(CONSOLE_INTERVAL);
     }
     
     return 0;
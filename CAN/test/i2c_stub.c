@@ -0,0 +1,208 @@
+/*
+ * File:   i2c_stub.c
+ * Comments: See i2c_stub.h.
+ */
+
+#include <string.h>
+#include "definitions.h"
+#include "i2c_stub.h"
+#include "ssd1306_model.h"
+
+static SERCOM_I2C_CALLBACK  stubCallback;
+static uintptr_t            stubContext;
+static SERCOM_I2C_ERROR     stubError = SERCOM_I2C_ERROR_NONE;
+static uint32_t             stubNakCountdown;
+
+/* Register file slave: auto-incrementing register pointer, like most sensors and EEPROMs */
+static uint16_t             regAddress = 0xFFFF;
+static uint8_t*             regFile;
+static uint16_t             regSize;
+static uint8_t              regWidth;
+static uint16_t             regPointer;
+uint32_t                    I2C_Stub_RegTransactions;
+static bool                 panelConnected = true;
+static bool                 stubHold;
+static SERCOM_I2C_TRANSACTION stubHeld[SERCOM2_I2C_QUEUE_SIZE];
+uint32_t                    I2C_Stub_Pending;
+uint32_t                    I2C_Stub_Cancels;
+
+void I2C_Stub_PanelConnect(bool connected)
+{
+    panelConnected = connected;
+}
+
+void I2C_Stub_Hold(bool hold)
+{
+    stubHold = hold;
+}
+
+void I2C_Stub_NakAfter(uint32_t n)
+{
+    stubNakCountdown = n;
+}
+
+void I2C_Stub_RegDevice(uint16_t address, uint8_t regs[], uint16_t size, uint8_t width)
+{
+    regAddress = address;
+    regFile = regs;
+    regSize = size;
+    regWidth = width;
+    regPointer = 0;
+    I2C_Stub_RegTransactions = 0;
+}
+
+/* Written bytes set the register pointer, the rest are stored; then reads follow it */
+static void StubRegTransfer(const uint8_t* wrData, uint32_t wrLength, uint8_t* rdData, uint32_t rdLength)
+{
+    uint32_t    i = 0;
+
+    I2C_Stub_RegTransactions++;
+    if (wrLength >= regWidth)
+    {
+        regPointer = (regWidth == 2U) ? (uint16_t)((wrData[0] << 8) | wrData[1]) : wrData[0];
+        i = regWidth;
+    }
+    for (; i < wrLength; i++)
+        regFile[regPointer++ % regSize] = wrData[i];
+    for (i = 0; i < rdLength; i++)
+        rdData[i] = regFile[regPointer++ % regSize];
+}
+
+/* One transfer on the bus: NAK it if due, else let the addressed model take it */
+static void StubTransferRead(uint16_t address, uint8_t* wrData, uint32_t wrLength, uint8_t* rdData, uint32_t rdLength)
+{
+    stubError = SERCOM_I2C_ERROR_NONE;
+    if ((stubNakCountdown != 0U) && (--stubNakCountdown == 0U))
+        stubError = SERCOM_I2C_ERROR_NAK;
+    else if ((address == regAddress) && (regFile != NULL))
+        StubRegTransfer(wrData, wrLength, rdData, rdLength);
+    else if ((address == SSD1306_ADDRESS) && panelConnected)
+    {
+        SSD1306_Transaction(address, wrData, wrLength);
+        memset(rdData, 0xFF, rdLength);             // the panel does not drive SDA on reads
+    }
+    else
+        stubError = SERCOM_I2C_ERROR_NAK;           // nobody at this address
+}
+
+static void StubTransfer(uint16_t address, uint8_t* wrData, uint32_t wrLength)
+{
+    StubTransferRead(address, wrData, wrLength, NULL, 0);
+}
+
+bool SERCOM2_I2C_Write(uint16_t address, uint8_t* wrData, uint32_t wrLength)
+{
+    StubTransfer(address, wrData, wrLength);
+    if (stubCallback != NULL)
+        stubCallback(stubContext);
+    return true;
+}
+
+/* Scatter-gather writes reach the model as the one transaction they are on the bus */
+static void StubTransferVectored(uint16_t address, uint8_t* wrData, size_t wrLength,
+                                 const SERCOM_I2C_SEGMENT* segments, uint32_t count,
+                                 uint8_t* rdData, size_t rdLength)
+{
+    static uint8_t  bus[2048];
+    size_t          n = 0;
+    uint32_t        i;
+
+    if (wrLength != 0U)
+    {
+        memcpy(bus, wrData, wrLength);
+        n = wrLength;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (n + segments[i].size > sizeof(bus))
+        {
+            printf("  i2c_stub: vectored write longer than %u bytes\n", (unsigned)sizeof(bus));
+            return;
+        }
+        memcpy(&bus[n], segments[i].data, segments[i].size);
+        n += segments[i].size;
+    }
+    StubTransferRead(address, bus, (uint32_t)n, rdData, (uint32_t)rdLength);
+}
+
+bool SERCOM2_I2C_WriteVectored(uint16_t address, const SERCOM_I2C_SEGMENT* segments, uint32_t segmentCount)
+{
+    StubTransferVectored(address, NULL, 0, segments, segmentCount, NULL, 0);
+    if (stubCallback != NULL)
+        stubCallback(stubContext);
+    return true;
+}
+
+bool SERCOM2_I2C_TransferSubmit(const SERCOM_I2C_TRANSACTION* transaction)
+{
+    if (stubHold)
+    {
+        if (I2C_Stub_Pending >= SERCOM2_I2C_QUEUE_SIZE)
+            return false;
+        stubHeld[I2C_Stub_Pending++] = *transaction;
+        return true;
+    }
+    StubTransferVectored(transaction->address, transaction->writeBuffer, transaction->writeSize,
+                         transaction->writeSegments, transaction->writeSegmentCount,
+                         transaction->readBuffer, transaction->readSize);
+    if (transaction->callback != NULL)
+        transaction->callback(transaction->context);
+    return true;
+}
+
+bool SERCOM2_I2C_IsBusy(void)
+{
+    return false;
+}
+
+void SERCOM2_I2C_Tasks(void)
+{
+}
+
+uint32_t SERCOM2_I2C_TransferCancel(SERCOM_I2C_CALLBACK callback, uintptr_t context)
+{
+    SERCOM_I2C_TRANSACTION  cancelled[SERCOM2_I2C_QUEUE_SIZE];
+    uint32_t                count = 0, kept = 0, i;
+
+    for (i = 0; i < I2C_Stub_Pending; i++)
+    {
+        if ((stubHeld[i].callback == callback) && (stubHeld[i].context == context))
+            cancelled[count++] = stubHeld[i];
+        else
+            stubHeld[kept++] = stubHeld[i];
+    }
+    I2C_Stub_Pending = kept;
+    I2C_Stub_Cancels += count;
+    for (i = 0; i < count; i++)
+    {
+        stubError = SERCOM_I2C_ERROR_BUS;
+        if (cancelled[i].callback != NULL)
+            cancelled[i].callback(cancelled[i].context);
+    }
+    return count;
+}
+
+/* No SysTick on the host: every poll counts as one microsecond */
+void SERCOM2_I2C_DeadlineStart(SERCOM2_I2C_DEADLINE* deadline, uint32_t us)
+{
+    deadline->last = 0;
+    deadline->left = us;
+}
+
+bool SERCOM2_I2C_DeadlineReached(SERCOM2_I2C_DEADLINE* deadline)
+{
+    if (deadline->left != 0U)
+        deadline->left--;
+    return (deadline->left == 0U);
+}
+
+SERCOM_I2C_ERROR SERCOM2_I2C_ErrorGet(void)
+{
+    return stubError;
+}
+
+void SERCOM2_I2C_CallbackRegister(SERCOM_I2C_CALLBACK callback, uintptr_t contextHandle)
+{
+    stubCallback = callback;
+    stubContext = contextHandle;
+}
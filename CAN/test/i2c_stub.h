@@ -0,0 +1,35 @@
+/*
+ * File:   i2c_stub.h
+ * Comments: Host implementation of the SERCOM2 I2C plib calls used by the OLED
+ *           driver and the I2C device layer. Every transfer is handed to the
+ *           SSD1306 model or the register file slave and completes at once,
+ *           running the registered or the queued transaction's callback the way
+ *           the SERCOM2 ISR would.
+ */
+
+#ifndef I2C_STUB_H
+#define I2C_STUB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Answer the n-th write from now (1 = next) with a NAK: nothing reaches the model */
+void I2C_Stub_NakAfter(uint32_t n);
+
+/* Attach a register file slave at address (the SSD1306 model answers at its own
+   address, all others NAK): width 1 or 2 register address bytes, then data at an auto-incrementing
+   pointer. Transactions it received since attaching are counted. */
+void I2C_Stub_RegDevice(uint16_t address, uint8_t regs[], uint16_t size, uint8_t width);
+extern uint32_t I2C_Stub_RegTransactions;
+
+/* Plug or unplug the SSD1306 model: while unplugged its address is NAKed */
+void I2C_Stub_PanelConnect(bool connected);
+
+/* Hang the bus: queued transactions are accepted but never complete until
+   SERCOM2_I2C_TransferCancel() ends them with a bus error. Pending and cancelled
+   ones are counted. */
+void I2C_Stub_Hold(bool hold);
+extern uint32_t I2C_Stub_Pending;
+extern uint32_t I2C_Stub_Cancels;
+
+#endif /* I2C_STUB_H */
@@ -0,0 +1,24 @@
+/*
+ * File:   cmsis_compiler.h
+ * Comments: Host (gcc, x86-64) stand-in for the CMSIS compiler header, for the
+ *           SERCOM model build. Only what the DFP and the plibs use.
+ */
+
+#ifndef CMSIS_COMPILER_H
+#define CMSIS_COMPILER_H
+
+#define __ASM               __asm__
+#define __INLINE            inline
+#define __STATIC_INLINE     static inline
+#define __STATIC_FORCEINLINE static inline __attribute__((always_inline))
+#define __NO_RETURN         __attribute__((__noreturn__))
+#define __USED              __attribute__((used))
+#define __WEAK              __attribute__((weak))
+#define __PACKED            __attribute__((packed))
+#define __PACKED_STRUCT     struct __attribute__((packed))
+#define __PACKED_UNION      union __attribute__((packed))
+#define __ALIGNED(x)        __attribute__((aligned(x)))
+#define __RESTRICT          __restrict
+#define __COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
+
+#endif /* CMSIS_COMPILER_H */
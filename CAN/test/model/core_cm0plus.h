@@ -0,0 +1,64 @@
+/*
+ * File:   core_cm0plus.h
+ * Comments: Host stand-in for the CMSIS Cortex-M0+ core header, for the SERCOM
+ *           model build (see ../sercom_model.h). SysTick keeps its real address,
+ *           where the model traps the accesses; PRIMASK and the NVIC are model
+ *           functions, so masking interrupts and enabling sources takes effect
+ *           on the emulated interrupt delivery.
+ */
+
+#ifndef CORE_CM0PLUS_H
+#define CORE_CM0PLUS_H
+
+#include <stdint.h>
+#include "cmsis_compiler.h"
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+#define __IM    volatile const
+#define __OM    volatile
+#define __IOM   volatile
+
+typedef struct
+{
+    __IOM uint32_t CTRL;
+    __IOM uint32_t LOAD;
+    __IOM uint32_t VAL;
+    __IM  uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_BASE                (0xE000E000UL + 0x0010UL)
+#define SysTick                     ((SysTick_Type*)SysTick_BASE)
+
+#define SysTick_CTRL_COUNTFLAG_Pos  16U
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << SysTick_CTRL_COUNTFLAG_Pos)
+#define SysTick_CTRL_CLKSOURCE_Pos  2U
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << SysTick_CTRL_CLKSOURCE_Pos)
+#define SysTick_CTRL_TICKINT_Pos    1U
+#define SysTick_CTRL_TICKINT_Msk    (1UL << SysTick_CTRL_TICKINT_Pos)
+#define SysTick_CTRL_ENABLE_Pos     0U
+#define SysTick_CTRL_ENABLE_Msk     (1UL << SysTick_CTRL_ENABLE_Pos)
+#define SysTick_LOAD_RELOAD_Msk     0xFFFFFFUL
+#define SysTick_VAL_CURRENT_Msk     0xFFFFFFUL
+
+#define __NOP()     __asm__ volatile("nop")
+#define __DMB()     __asm__ volatile("" ::: "memory")
+#define __DSB()     __asm__ volatile("" ::: "memory")
+#define __ISB()     __asm__ volatile("" ::: "memory")
+
+void     __enable_irq(void);
+void     __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void     __WFI(void);                           // sleep until an interrupt was taken
+
+void     NVIC_EnableIRQ(IRQn_Type IRQn);
+void     NVIC_DisableIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn);
+void     NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void     NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void     NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+
+#endif /* CORE_CM0PLUS_H */
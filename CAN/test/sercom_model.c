@@ -0,0 +1,1707 @@
+/*
+ * File:   sercom_model.c
+ * Comments: See sercom_model.h. x86-64 Linux only.
+ *
+ *           A register access faults (SIGSEGV) on the protected page; the model
+ *           presents the register's current value in the page, opens it and sets
+ *           the trap flag, the instruction runs and the SIGTRAP right after it
+ *           closes the page again and applies what was read or written. The same
+ *           SIGTRAP enters a pending interrupt by saving the interrupted context
+ *           and resuming at IrqEntry() on the interrupted stack below its red zone;
+ *           the handler returns into an int3 where the saved context is restored.
+ *           Interrupts are also taken where thread code unmasks or enables them
+ *           and while the model runs time forward, through another int3.
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "definitions.h"
+#include "sercom_model.h"
+
+#define NEVER               UINT64_MAX
+#define PAGE_SIZE           4096U
+#define EFLAGS_TF           0x100
+#define EFLAGS_DF           0x400
+
+#define SYSTICK_INDEX       31          // NVIC slot used for the SysTick exception
+#define THREAD_PRIORITY     4           // below the four Cortex-M0+ priority levels
+#define MAX_NESTING         8
+#define FP_SAVE_MAX         16384U      // xsave area of the signal frame
+#define FP_XSTATE_MAGIC     0x46505853U
+
+#define I2C_SDA_PIN         12U         // PA12 = SERCOM2 PAD0, PA13 = PAD1
+#define I2C_SCL_PIN         13U
+#define MAX_I2C_SLAVES      8
+#define LOG_SIZE            4096U
+
+#define MODE_USART          1U
+#define MODE_SPI_MASTER     3U
+#define MODE_I2C_MASTER     5U
+
+/* Interrupt handlers the plibs provide, resolved at link time */
+extern void SysTick_Handler(void) __attribute__((weak));
+extern void SERCOM0_USART_InterruptHandler(void) __attribute__((weak));
+extern void SERCOM1_SPI_InterruptHandler(void) __attribute__((weak));
+extern void SERCOM2_I2C_InterruptHandler(void) __attribute__((weak));
+
+/* Exception return and "take pending interrupts" entry points, see ModelTrap() */
+extern void sercomModelReturnTrap(void) __attribute__((visibility("hidden")));
+extern void sercomModelCheckTrap(void) __attribute__((visibility("hidden")));
+__asm__(".text\n"
+        ".globl sercomModelReturnTrap\n"
+        ".hidden sercomModelReturnTrap\n"
+        "sercomModelReturnTrap:\n"
+        "    int3\n"
+        "    ud2\n"
+        ".globl sercomModelCheckTrap\n"
+        ".hidden sercomModelCheckTrap\n"
+        "sercomModelCheckTrap:\n"
+        "    int3\n"
+        "    ret\n");
+
+typedef enum
+{
+    I2C_NONE,
+    I2C_ADDRESS,        // START or repeated START + address byte
+    I2C_WRITE,          // data byte to the slave
+    I2C_READ,           // data byte from the slave
+    I2C_STOP,
+} I2C_BYTE;
+
+typedef struct
+{
+    uint32_t    ctrla;
+    uint32_t    ctrlb;          // I2C CMD bits are never stored, they read as zero
+    uint16_t    baud;
+    uint8_t     dbgctrl;
+    uint8_t     intenset;
+    uint8_t     intflag;        // latched flags: I2C MB/SB, TXC; DRE and RXC are computed
+    uint16_t    status;         // latched error bits
+    uint32_t    addr;
+    uint64_t    syncUntil;
+
+    /* Shift register: character or I2C byte on the wire until shiftAt */
+    uint64_t    shiftAt;
+    uint16_t    shift;
+    uint16_t    txData;
+    bool        txFull;
+    uint16_t    rx[2];          // receive FIFO, I2C uses rx[0] as DATA
+    uint8_t     rxErr[2];
+    uint8_t     rxCount;
+
+    /* I2C master */
+    uint8_t     busState;
+    I2C_BYTE    byte;
+    bool        reading;
+    uint64_t    busFreeAt;      // another master lets go of the bus after ARBLOST
+} MODEL_SERCOM;
+
+typedef struct
+{
+    uint8_t     address;
+    uint8_t*    regs;
+    uint16_t    size;
+    uint8_t     width;
+    uint16_t    pointer;
+    uint32_t    transactions;
+} MODEL_I2C_SLAVE;
+
+typedef struct
+{
+    int         index;
+    uint8_t     priority;
+    int         inModel;
+    uint64_t    start;
+    gregset_t   gregs;
+    size_t      fpSize;
+    uint8_t     fp[FP_SAVE_MAX] __attribute__((aligned(64)));
+} MODEL_FRAME;
+
+static const uintptr_t  pages[] = { 0x41004000UL, 0x42000000UL, 0x42001000UL, 0xE000E000UL };
+static bool             mapped;
+static uint64_t         now;
+
+static MODEL_SERCOM     sercom[3];
+
+static struct
+{
+    uint32_t    dir[PORT_GROUP_NUMBER];
+    uint32_t    out[PORT_GROUP_NUMBER];
+    uint8_t     pmux[PORT_GROUP_NUMBER][16];
+    uint8_t     pincfg[PORT_GROUP_NUMBER][32];
+    uint32_t    ctrl[PORT_GROUP_NUMBER];
+    bool        scl;            // last SCL level, for counting pulses
+} port;
+
+static struct
+{
+    uint32_t    ctrl;           // without COUNTFLAG
+    uint32_t    load;
+    uint32_t    val;            // while stopped
+    uint64_t    zeroAt;         // counter was zero here, reloads on the next cycle
+    uint64_t    wrapAt;
+    bool        countFlag;
+} systick;
+
+static struct
+{
+    uint32_t    primask;
+    uint32_t    enabled;
+    uint32_t    pending;        // software / edge pending, SERCOM lines are level
+    uint8_t     priority[32];
+} nvic;
+
+static MODEL_FRAME              frames[MAX_NESTING];
+static int                      depth;
+static SERCOM_MODEL_IRQ_STATS   irqStats[32];
+static int                      inModel;    // CMSIS stand-in running, its steps are free
+
+/* Access being single-stepped */
+static struct
+{
+    bool        pending;
+    bool        write;
+    uintptr_t   page;
+    uintptr_t   reg;            // start of the register, 0 = plain memory
+    uint8_t     size;
+    uint32_t    presented;
+} step;
+
+/* I2C bus */
+static MODEL_I2C_SLAVE  slaves[MAX_I2C_SLAVES];
+static int              slaveActive = -1;   // addressed slave between START and STOP
+static uint32_t         slaveByte;          // bytes written in this transaction
+static SERCOM_MODEL_I2C_FAULT faultKind;
+static uint32_t         faultCountdown;
+static uint8_t          sdaHeld;
+static bool             sclStuck;
+
+/* SPI slave and USART peer */
+static SERCOM_MODEL_SPI_SLAVE spiSlave;
+static uint8_t          mosiLog[LOG_SIZE];
+static uint32_t         mosiCount;
+static uint8_t          peerTx[LOG_SIZE];
+static uint32_t         peerTxHead, peerTxCount;
+static uint64_t         peerAt = NEVER;
+static uint32_t         peerBaud;
+static bool             peerParityError;
+static uint8_t          peerRx[LOG_SIZE];
+static uint32_t         peerRxCount;
+
+static void Advance(uint64_t t);
+
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+
+static void Fatal(const char* what)
+{
+    fprintf(stderr, "sercom_model: %s\n", what);
+    abort();
+}
+
+static uint32_t Mode(const MODEL_SERCOM* s)
+{
+    return (s->ctrla & SERCOM_I2CM_CTRLA_MODE_Msk) >> SERCOM_I2CM_CTRLA_MODE_Pos;
+}
+
+static bool Enabled(const MODEL_SERCOM* s)
+{
+    return (s->ctrla & SERCOM_I2CM_CTRLA_ENABLE_Msk) != 0U;
+}
+
+static MODEL_SERCOM* SercomInMode(uint32_t mode)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (Mode(&sercom[i]) == mode)
+            return &sercom[i];
+    }
+    return NULL;
+}
+
+static int Index(IRQn_Type irq)
+{
+    if (irq == SysTick_IRQn)
+        return SYSTICK_INDEX;
+    return ((irq >= 0) && (irq < SYSTICK_INDEX)) ? (int)irq : -1;
+}
+
+static void (*Handler(int index))(void)
+{
+    switch (index)
+    {
+        case SYSTICK_INDEX:     return SysTick_Handler;
+        case SERCOM0_IRQn:      return SERCOM0_USART_InterruptHandler;
+        case SERCOM1_IRQn:      return SERCOM1_SPI_InterruptHandler;
+        case SERCOM2_IRQn:      return SERCOM2_I2C_InterruptHandler;
+        default:                return NULL;
+    }
+}
+
+// *****************************************************************************
+// Section: SERCOM
+// *****************************************************************************
+
+static uint8_t SercomFlags(const MODEL_SERCOM* s)
+{
+    uint8_t flags = s->intflag;
+
+    if ((Mode(s) == MODE_SPI_MASTER) || (Mode(s) == MODE_USART))
+    {
+        if (Enabled(s) && !s->txFull)
+            flags |= SERCOM_SPIM_INTFLAG_DRE_Msk;
+        if (s->rxCount != 0U)
+            flags |= SERCOM_SPIM_INTFLAG_RXC_Msk;
+    }
+    return flags;
+}
+
+static bool SercomLine(const MODEL_SERCOM* s)
+{
+    return (SercomFlags(s) & s->intenset) != 0U;
+}
+
+static void Sync(MODEL_SERCOM* s)
+{
+    s->syncUntil = now + SERCOM_MODEL_SYNC_CYCLES;
+}
+
+static void RxPush(MODEL_SERCOM* s, uint16_t data, uint8_t errors)
+{
+    if (s->rxCount == 2U)
+    {
+        s->status |= SERCOM_SPIM_STATUS_BUFOVF_Msk;
+        return;
+    }
+    s->rx[s->rxCount] = data;
+    s->rxErr[s->rxCount] = errors;
+    s->rxCount++;
+}
+
+static void RxPop(MODEL_SERCOM* s)
+{
+    if (s->rxCount != 0U)
+    {
+        s->rx[0] = s->rx[1];
+        s->rxErr[0] = s->rxErr[1];
+        s->rxCount--;
+    }
+}
+
+// *****************************************************************************
+// Section: I2C master and bus
+// *****************************************************************************
+
+static uint64_t SclCycles(const MODEL_SERCOM* s)
+{
+    uint32_t high = s->baud & 0xFFU;
+    uint32_t low = s->baud >> 8;
+
+    return 10U + high + ((low != 0U) ? low : high);
+}
+
+static int SlaveFind(uint8_t address)
+{
+    for (int i = 0; i < MAX_I2C_SLAVES; i++)
+    {
+        if ((slaves[i].regs != NULL) && (slaves[i].address == address))
+            return i;
+    }
+    return -1;
+}
+
+/* START or repeated START addressed to the slave and acknowledged */
+static void SlaveStart(int i)
+{
+    slaveActive = i;
+    slaveByte = 0;
+    slaves[i].transactions++;
+    if (slaves[i].width == 0U)
+        slaves[i].pointer = 0;
+}
+
+static void SlaveWrite(uint8_t data)
+{
+    MODEL_I2C_SLAVE* sl = &slaves[slaveActive];
+
+    if (slaveByte < sl->width)
+        sl->pointer = (slaveByte == 0U) ? data : (uint16_t)((sl->pointer << 8) | data);
+    else
+        sl->regs[sl->pointer++ % sl->size] = data;
+    slaveByte++;
+}
+
+static uint8_t SlaveRead(void)
+{
+    MODEL_I2C_SLAVE* sl = &slaves[slaveActive];
+
+    return sl->regs[sl->pointer++ % sl->size];
+}
+
+/* Counts the bytes down to the injected fault; true on the faulty one */
+static bool FaultTick(void)
+{
+    return (faultCountdown != 0U) && (--faultCountdown == 0U);
+}
+
+static void I2CSend(MODEL_SERCOM* s, I2C_BYTE byte, uint8_t data, uint64_t start)
+{
+    s->byte = byte;
+    s->shift = data;
+    s->shiftAt = start + ((byte == I2C_ADDRESS) ? 10U : 9U) * SclCycles(s);
+}
+
+static void I2CAddress(MODEL_SERCOM* s, uint8_t address)
+{
+    uint64_t start = now;
+
+    if (!Enabled(s))
+        return;
+
+    s->intflag &= (uint8_t)~(SERCOM_I2CM_INTFLAG_MB_Msk | SERCOM_I2CM_INTFLAG_SB_Msk);
+    s->status &= (uint16_t)~(SERCOM_I2CM_STATUS_RXNACK_Msk | SERCOM_I2CM_STATUS_ARBLOST_Msk |
+                             SERCOM_I2CM_STATUS_BUSERR_Msk);
+    s->addr = address;
+    if (s->busState == 3U)
+    {
+        /* Another master has the bus: the START waits for its STOP */
+        start = s->busFreeAt;
+    }
+    slaveActive = -1;
+    s->busState = 2U;
+    s->reading = (address & 1U) != 0U;
+    I2CSend(s, I2C_ADDRESS, address, start);
+}
+
+static void I2CAck(MODEL_SERCOM* s)
+{
+    s->intflag &= (uint8_t)~SERCOM_I2CM_INTFLAG_SB_Msk;
+    if ((s->ctrlb & SERCOM_I2CM_CTRLB_ACKACT_Msk) == 0U)
+        I2CSend(s, I2C_READ, 0, now);
+}
+
+static void I2CCommand(MODEL_SERCOM* s, uint32_t cmd)
+{
+    s->intflag &= (uint8_t)~(SERCOM_I2CM_INTFLAG_MB_Msk | SERCOM_I2CM_INTFLAG_SB_Msk);
+    if ((s->busState != 2U) || (s->shiftAt != NEVER))
+        return;
+
+    switch (cmd)
+    {
+        case 1U:
+            I2CAddress(s, (uint8_t)s->addr);
+            break;
+        case 2U:
+            if (s->reading)
+                I2CAck(s);
+            break;
+        case 3U:
+            slaveActive = -1;
+            s->byte = I2C_STOP;
+            s->shiftAt = now + SclCycles(s);
+            break;
+        default:
+            break;
+    }
+}
+
+static void I2CByteDone(MODEL_SERCOM* s)
+{
+    I2C_BYTE byte = s->byte;
+    bool fault;
+    bool ack;
+
+    s->shiftAt = NEVER;
+    s->byte = I2C_NONE;
+    if (byte == I2C_STOP)
+    {
+        s->busState = 1U;
+        return;
+    }
+
+    fault = FaultTick();
+    if (((byte == I2C_ADDRESS) && (sdaHeld != 0U)) || (fault && (faultKind == SERCOM_MODEL_I2C_ARBLOST)))
+    {
+        /* SDA low where the master sent a one: the other side wins and keeps the bus */
+        slaveActive = -1;
+        s->intflag |= SERCOM_I2CM_INTFLAG_MB_Msk;
+        s->status |= SERCOM_I2CM_STATUS_ARBLOST_Msk;
+        s->busState = 3U;
+        s->busFreeAt = now + 20U * 9U * SclCycles(s);
+        return;
+    }
+    if (fault && (faultKind == SERCOM_MODEL_I2C_BUSERR))
+    {
+        slaveActive = -1;
+        s->intflag |= SERCOM_I2CM_INTFLAG_MB_Msk;
+        s->status |= SERCOM_I2CM_STATUS_BUSERR_Msk;
+        s->busState = 1U;
+        return;
+    }
+    if (fault && (faultKind == SERCOM_MODEL_I2C_SCL_STUCK))
+    {
+        /* The byte never ends: no flag until the master is disabled */
+        sclStuck = true;
+        return;
+    }
+    ack = !(fault && (faultKind == SERCOM_MODEL_I2C_NAK));
+
+    switch (byte)
+    {
+        case I2C_ADDRESS:
+        {
+            int i = SlaveFind((uint8_t)(s->shift >> 1));
+
+            ack = ack && (i >= 0);
+            if (ack)
+                SlaveStart(i);
+            if (ack && s->reading)
+            {
+                /* The slave sends the first byte right after its ACK */
+                I2CSend(s, I2C_READ, 0, now);
+            }
+            else
+            {
+                s->intflag |= SERCOM_I2CM_INTFLAG_MB_Msk;
+                if (!ack)
+                    s->status |= SERCOM_I2CM_STATUS_RXNACK_Msk;
+            }
+            break;
+        }
+        case I2C_WRITE:
+            ack = ack && (slaveActive >= 0);
+            if (ack)
+                SlaveWrite((uint8_t)s->shift);
+            s->intflag |= SERCOM_I2CM_INTFLAG_MB_Msk;
+            if (!ack)
+                s->status |= SERCOM_I2CM_STATUS_RXNACK_Msk;
+            else
+                s->status &= (uint16_t)~SERCOM_I2CM_STATUS_RXNACK_Msk;
+            break;
+        case I2C_READ:
+            s->rx[0] = (slaveActive >= 0) ? SlaveRead() : 0xFFU;
+            s->intflag |= SERCOM_I2CM_INTFLAG_SB_Msk;
+            break;
+        default:
+            break;
+    }
+}
+
+static void I2CWriteData(MODEL_SERCOM* s, uint8_t data)
+{
+    if (Enabled(s) && (s->busState == 2U) && !s->reading && (s->shiftAt == NEVER))
+    {
+        s->intflag &= (uint8_t)~(SERCOM_I2CM_INTFLAG_MB_Msk | SERCOM_I2CM_INTFLAG_SB_Msk);
+        I2CSend(s, I2C_WRITE, data, now);
+    }
+}
+
+// *****************************************************************************
+// Section: SPI master and USART
+// *****************************************************************************
+
+static uint32_t FrameBits(const MODEL_SERCOM* s)
+{
+    uint32_t chsize = s->ctrlb & SERCOM_USART_INT_CTRLB_CHSIZE_Msk;
+    uint32_t bits;
+
+    bits = (chsize == 0U) ? 8U : ((chsize == 1U) ? 9U : chsize);
+    if (Mode(s) == MODE_SPI_MASTER)
+        return bits;
+    bits += 1U + (((s->ctrlb & SERCOM_USART_INT_CTRLB_SBMODE_Msk) != 0U) ? 2U : 1U);
+    if (((s->ctrla & SERCOM_USART_INT_CTRLA_FORM_Msk) >> SERCOM_USART_INT_CTRLA_FORM_Pos) == 1U)
+        bits++;
+    return bits;
+}
+
+/* USART bit time in 1/65536 cycles: f(BAUD) = f(ref) / 16 * (1 - BAUD / 65536) */
+static uint64_t UsartBitTime(const MODEL_SERCOM* s)
+{
+    return (16ULL << 32) / (65536U - s->baud);
+}
+
+static uint64_t CharCycles(const MODEL_SERCOM* s)
+{
+    if (Mode(s) == MODE_SPI_MASTER)
+        return FrameBits(s) * 2U * ((uint32_t)(s->baud & 0xFFU) + 1U);
+    return (FrameBits(s) * UsartBitTime(s) + 0x8000U) >> 16;
+}
+
+static uint64_t PeerCharCycles(const MODEL_SERCOM* s)
+{
+    if (peerBaud == 0U)
+        return CharCycles(s);
+    return ((uint64_t)FrameBits(s) * CPU_CLOCK_FREQUENCY + peerBaud / 2U) / peerBaud;
+}
+
+static bool TxEnabled(const MODEL_SERCOM* s)
+{
+    return Enabled(s) && ((Mode(s) == MODE_SPI_MASTER) || ((s->ctrlb & SERCOM_USART_INT_CTRLB_TXEN_Msk) != 0U));
+}
+
+static void TxWrite(MODEL_SERCOM* s, uint16_t data)
+{
+    if (!TxEnabled(s))
+        return;
+
+    s->intflag &= (uint8_t)~SERCOM_SPIM_INTFLAG_TXC_Msk;
+    if (s->shiftAt == NEVER)
+    {
+        s->shift = data;
+        s->shiftAt = now + CharCycles(s);
+    }
+    else
+    {
+        s->txData = data;
+        s->txFull = true;
+    }
+}
+
+static void CharDone(MODEL_SERCOM* s)
+{
+    uint16_t mask = (FrameBits(s) == 8U) ? 0xFFU : 0x1FFU;
+
+    if (Mode(s) == MODE_SPI_MASTER)
+    {
+        uint16_t mosi = s->shift & mask;
+        uint16_t miso = (spiSlave != NULL) ? spiSlave(mosi) : mosi;
+
+        if (mosiCount < LOG_SIZE)
+            mosiLog[mosiCount++] = (uint8_t)mosi;
+        if ((s->ctrlb & SERCOM_SPIM_CTRLB_RXEN_Msk) != 0U)
+            RxPush(s, miso & mask, 0);
+    }
+    else if (peerRxCount < LOG_SIZE)
+    {
+        peerRx[peerRxCount++] = (uint8_t)s->shift;
+    }
+
+    if (s->txFull)
+    {
+        s->txFull = false;
+        s->shift = s->txData;
+        s->shiftAt = now + CharCycles(s);
+    }
+    else
+    {
+        s->shiftAt = NEVER;
+        s->intflag |= SERCOM_SPIM_INTFLAG_TXC_Msk;
+    }
+}
+
+/* A character from the USART peer has been received completely */
+static void PeerCharDone(void)
+{
+    MODEL_SERCOM* s = SercomInMode(MODE_USART);
+    uint8_t data = peerTx[peerTxHead];
+
+    peerTxHead = (peerTxHead + 1U) % LOG_SIZE;
+    peerTxCount--;
+    peerAt = NEVER;
+    if (s == NULL)
+    {
+        peerTxCount = 0;
+        return;
+    }
+
+    if (Enabled(s) && ((s->ctrlb & SERCOM_USART_INT_CTRLB_RXEN_Msk) != 0U))
+    {
+        uint8_t errors = 0;
+        double bits = FrameBits(s);
+        double rxBit = (double)UsartBitTime(s) / 65536.0;
+        double peerBit = (double)PeerCharCycles(s) / bits;
+        double sample = (bits - 0.5) * rxBit;
+
+        if (peerParityError &&
+            (((s->ctrla & SERCOM_USART_INT_CTRLA_FORM_Msk) >> SERCOM_USART_INT_CTRLA_FORM_Pos) == 1U))
+        {
+            errors |= SERCOM_USART_INT_STATUS_PERR_Msk;
+        }
+        /* The receiver samples the stop bit in the middle of its own bit time */
+        if ((sample < (bits - 1.0) * peerBit) || (sample > bits * peerBit))
+            errors |= SERCOM_USART_INT_STATUS_FERR_Msk;
+        RxPush(s, data, errors);
+    }
+    peerParityError = false;
+
+    if (peerTxCount != 0U)
+        peerAt = now + PeerCharCycles(s);
+}
+
+// *****************************************************************************
+// Section: SERCOM registers
+// *****************************************************************************
+
+static void SercomEnable(MODEL_SERCOM* s, bool enable)
+{
+    if (enable)
+    {
+        s->busState = 0U;
+        return;
+    }
+
+    s->shiftAt = NEVER;
+    s->byte = I2C_NONE;
+    s->txFull = false;
+    s->busState = 0U;
+    s->intflag &= (uint8_t)~SERCOM_SPIM_INTFLAG_TXC_Msk;
+    if (Mode(s) == MODE_I2C_MASTER)
+    {
+        slaveActive = -1;
+        sclStuck = false;
+    }
+}
+
+static void SercomReset(MODEL_SERCOM* s)
+{
+    if (Mode(s) == MODE_I2C_MASTER)
+    {
+        slaveActive = -1;
+        sclStuck = false;
+    }
+    memset(s, 0, sizeof(*s));
+    s->shiftAt = NEVER;
+    s->busFreeAt = NEVER;
+}
+
+static uint32_t SercomRead(MODEL_SERCOM* s, uint32_t offset)
+{
+    uint32_t value;
+
+    switch (offset)
+    {
+        case 0x00: return s->ctrla;
+        case 0x04: return s->ctrlb;
+        case 0x08: return s->dbgctrl;
+        case 0x0A: return s->baud;
+        case 0x0C:
+        case 0x0D: return s->intenset;
+        case 0x0E: return SercomFlags(s);
+        case 0x10:
+            value = s->status;
+            if (Mode(s) == MODE_I2C_MASTER)
+            {
+                value |= SERCOM_I2CM_STATUS_BUSSTATE(s->busState);
+                if ((s->intflag & (SERCOM_I2CM_INTFLAG_MB_Msk | SERCOM_I2CM_INTFLAG_SB_Msk)) != 0U)
+                    value |= SERCOM_I2CM_STATUS_CLKHOLD_Msk;
+            }
+            else if ((Mode(s) == MODE_USART) && (s->rxCount != 0U))
+            {
+                value |= s->rxErr[0];
+            }
+            if (now < s->syncUntil)
+                value |= SERCOM_I2CM_STATUS_SYNCBUSY_Msk;
+            return value;
+        case 0x14: return s->addr;
+        case 0x18: return s->rx[0];
+        default:   return 0;
+    }
+}
+
+static void SercomReadDone(MODEL_SERCOM* s, uint32_t offset)
+{
+    if (offset != 0x18U)
+        return;
+
+    if (Mode(s) == MODE_I2C_MASTER)
+    {
+        /* Smart mode: reading DATA performs the acknowledge action */
+        if (((s->ctrlb & SERCOM_I2CM_CTRLB_SMEN_Msk) != 0U) &&
+            ((s->intflag & SERCOM_I2CM_INTFLAG_SB_Msk) != 0U))
+        {
+            I2CAck(s);
+        }
+    }
+    else
+    {
+        RxPop(s);
+    }
+}
+
+static void SercomWrite(MODEL_SERCOM* s, uint32_t offset, uint32_t value)
+{
+    switch (offset)
+    {
+        case 0x00:
+            if ((value & SERCOM_I2CM_CTRLA_SWRST_Msk) != 0U)
+            {
+                SercomReset(s);
+            }
+            else
+            {
+                bool was = Enabled(s);
+
+                s->ctrla = value;
+                if (was != Enabled(s))
+                    SercomEnable(s, !was);
+            }
+            Sync(s);
+            break;
+        case 0x04:
+            if (Mode(s) == MODE_I2C_MASTER)
+            {
+                s->ctrlb = value & ~SERCOM_I2CM_CTRLB_CMD_Msk;
+                if ((value & SERCOM_I2CM_CTRLB_CMD_Msk) != 0U)
+                    I2CCommand(s, (value & SERCOM_I2CM_CTRLB_CMD_Msk) >> SERCOM_I2CM_CTRLB_CMD_Pos);
+            }
+            else
+            {
+                s->ctrlb = value;
+            }
+            Sync(s);
+            break;
+        case 0x08:
+            s->dbgctrl = (uint8_t)value;
+            break;
+        case 0x0A:
+            s->baud = (Mode(s) == MODE_SPI_MASTER) ? (uint16_t)(value & 0xFFU) : (uint16_t)value;
+            break;
+        case 0x0C:
+            s->intenset &= (uint8_t)~value;
+            break;
+        case 0x0D:
+            s->intenset |= (uint8_t)value;
+            break;
+        case 0x0E:
+            /* Write-one-to-clear; DRE and RXC follow the buffers */
+            s->intflag &= (uint8_t)~(value & ((Mode(s) == MODE_I2C_MASTER) ? 0x03U : 0x0AU));
+            break;
+        case 0x10:
+            if (Mode(s) == MODE_I2C_MASTER)
+            {
+                s->status &= (uint16_t)~(value & (SERCOM_I2CM_STATUS_BUSERR_Msk | SERCOM_I2CM_STATUS_ARBLOST_Msk |
+                                                  SERCOM_I2CM_STATUS_LOWTOUT_Msk));
+                if ((value & SERCOM_I2CM_STATUS_BUSSTATE_Msk) != 0U)
+                {
+                    s->busState = (uint8_t)((value & SERCOM_I2CM_STATUS_BUSSTATE_Msk) >> SERCOM_I2CM_STATUS_BUSSTATE_Pos);
+                    Sync(s);
+                }
+            }
+            else
+            {
+                s->status &= (uint16_t)~(value & SERCOM_SPIM_STATUS_BUFOVF_Msk);
+                if ((Mode(s) == MODE_USART) && (s->rxCount != 0U))
+                    s->rxErr[0] &= (uint8_t)~value;
+            }
+            break;
+        case 0x14:
+            if (Mode(s) == MODE_I2C_MASTER)
+            {
+                I2CAddress(s, (uint8_t)value);
+                Sync(s);
+            }
+            else
+            {
+                s->addr = value;
+            }
+            break;
+        case 0x18:
+            if (Mode(s) == MODE_I2C_MASTER)
+            {
+                I2CWriteData(s, (uint8_t)value);
+                Sync(s);
+            }
+            else
+            {
+                TxWrite(s, (uint16_t)(value & 0x1FFU));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void SercomEvents(MODEL_SERCOM* s)
+{
+    if (s->shiftAt <= now)
+    {
+        if (Mode(s) == MODE_I2C_MASTER)
+            I2CByteDone(s);
+        else
+            CharDone(s);
+    }
+    if (s->busFreeAt <= now)
+    {
+        s->busFreeAt = NEVER;
+        if (s->busState == 3U)
+            s->busState = 1U;
+    }
+}
+
+// *****************************************************************************
+// Section: PORT
+// *****************************************************************************
+
+static bool PinLevel(uint32_t group, uint32_t pin)
+{
+    uint32_t bit = 1UL << pin;
+    bool i2cPin = (group == 0U) && ((pin == I2C_SDA_PIN) || (pin == I2C_SCL_PIN));
+    bool level;
+
+    if ((port.pincfg[group][pin] & PORT_PINCFG_PMUXEN_Msk) != 0U)
+        level = i2cPin;                         // the SERCOM drives the line, idle high
+    else if ((port.dir[group] & bit) != 0U)
+        level = (port.out[group] & bit) != 0U;
+    else if ((port.pincfg[group][pin] & PORT_PINCFG_PULLEN_Msk) != 0U)
+        level = (port.out[group] & bit) != 0U;
+    else
+        level = i2cPin;                         // external pull-ups on SDA and SCL
+
+    if (i2cPin && (pin == I2C_SDA_PIN) && (sdaHeld != 0U))
+        level = false;
+    if (i2cPin && (pin == I2C_SCL_PIN) && sclStuck)
+        level = false;
+    return level;
+}
+
+static uint32_t PortIn(uint32_t group)
+{
+    uint32_t in = 0;
+
+    for (uint32_t pin = 0; pin < 32U; pin++)
+    {
+        if (PinLevel(group, pin))
+            in |= 1UL << pin;
+    }
+    return in;
+}
+
+/* A slave holding SDA lets go after the clock pulses it was waiting for */
+static void PortChanged(void)
+{
+    bool scl = PinLevel(0, I2C_SCL_PIN);
+
+    if (scl && !port.scl && (sdaHeld != 0U))
+        sdaHeld--;
+    port.scl = scl;
+}
+
+static uint32_t PortRead(uint32_t offset)
+{
+    uint32_t group = offset / sizeof(port_group_registers_t);
+    uint32_t reg = offset % sizeof(port_group_registers_t);
+
+    if (reg >= 0x40U)
+        return port.pincfg[group][reg - 0x40U];
+    if (reg >= 0x30U)
+        return port.pmux[group][reg - 0x30U];
+    switch (reg)
+    {
+        case 0x00: case 0x04: case 0x08: case 0x0C:
+            return port.dir[group];
+        case 0x10: case 0x14: case 0x18: case 0x1C:
+            return port.out[group];
+        case 0x20:
+            return PortIn(group);
+        case 0x24:
+            return port.ctrl[group];
+        default:
+            return 0;
+    }
+}
+
+static void PortWrite(uint32_t offset, uint32_t value)
+{
+    uint32_t group = offset / sizeof(port_group_registers_t);
+    uint32_t reg = offset % sizeof(port_group_registers_t);
+
+    if (reg >= 0x40U)
+        port.pincfg[group][reg - 0x40U] = (uint8_t)value;
+    else if (reg >= 0x30U)
+        port.pmux[group][reg - 0x30U] = (uint8_t)value;
+    else
+    {
+        switch (reg)
+        {
+            case 0x00: port.dir[group] = value; break;
+            case 0x04: port.dir[group] &= ~value; break;
+            case 0x08: port.dir[group] |= value; break;
+            case 0x0C: port.dir[group] ^= value; break;
+            case 0x10: port.out[group] = value; break;
+            case 0x14: port.out[group] &= ~value; break;
+            case 0x18: port.out[group] |= value; break;
+            case 0x1C: port.out[group] ^= value; break;
+            case 0x24: port.ctrl[group] = value; break;
+            default: break;
+        }
+    }
+    PortChanged();
+}
+
+// *****************************************************************************
+// Section: SysTick
+// *****************************************************************************
+
+static bool SysTickRunning(void)
+{
+    return ((systick.ctrl & SysTick_CTRL_ENABLE_Msk) != 0U) && (systick.load != 0U);
+}
+
+static uint32_t SysTickVal(void)
+{
+    uint64_t d;
+
+    if (!SysTickRunning())
+        return systick.val;
+    d = (now - systick.zeroAt) % ((uint64_t)systick.load + 1U);
+    return (d == 0U) ? 0U : (uint32_t)(systick.load + 1U - d);
+}
+
+/* Restart counting down from val at the current cycle */
+static void SysTickSchedule(uint32_t val)
+{
+    uint64_t period = (uint64_t)systick.load + 1U;
+
+    systick.val = val;
+    if (!SysTickRunning())
+    {
+        systick.wrapAt = NEVER;
+        return;
+    }
+    systick.zeroAt = (val == 0U) ? now : (now - (period - val));
+    systick.wrapAt = systick.zeroAt + period * (((now - systick.zeroAt) / period) + 1U);
+}
+
+static uint32_t SysTickRead(uint32_t offset)
+{
+    switch (offset)
+    {
+        case 0x0: return systick.ctrl | (systick.countFlag ? SysTick_CTRL_COUNTFLAG_Msk : 0U);
+        case 0x4: return systick.load;
+        case 0x8: return SysTickVal();
+        default:  return 0;
+    }
+}
+
+static void SysTickWrite(uint32_t offset, uint32_t value)
+{
+    uint32_t val = SysTickVal();
+
+    switch (offset)
+    {
+        case 0x0:
+            systick.ctrl = value & (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_CLKSOURCE_Msk);
+            break;
+        case 0x4:
+            systick.load = value & SysTick_LOAD_RELOAD_Msk;
+            break;
+        case 0x8:
+            val = 0;
+            systick.countFlag = false;
+            break;
+        default:
+            return;
+    }
+    SysTickSchedule(val);
+}
+
+static void SysTickEvent(void)
+{
+    systick.countFlag = true;
+    if ((systick.ctrl & SysTick_CTRL_TICKINT_Msk) != 0U)
+        nvic.pending |= 1UL << SYSTICK_INDEX;
+    systick.wrapAt += (uint64_t)systick.load + 1U;
+}
+
+// *****************************************************************************
+// Section: Register dispatch
+// *****************************************************************************
+
+typedef enum { DEV_MEMORY, DEV_SERCOM, DEV_PORT, DEV_SYSTICK } MODEL_DEVICE;
+
+/* Register holding addr: device, instance, start and size */
+static MODEL_DEVICE Decode(uintptr_t addr, int* instance, uintptr_t* reg, uint8_t* size)
+{
+    static const uint8_t sercomSize[0x1C] =
+    {
+        4, 4, 4, 4, 4, 4, 4, 4, 1, 0, 2, 2, 1, 1, 1, 0, 2, 2, 0, 0, 4, 4, 4, 4, 2, 2, 0, 0
+    };
+    static const uint8_t sercomStart[0x1C] =
+    {
+        0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04, 0x08, 0, 0x0A, 0x0A, 0x0C, 0x0D, 0x0E, 0,
+        0x10, 0x10, 0, 0, 0x14, 0x14, 0x14, 0x14, 0x18, 0x18, 0, 0
+    };
+    uintptr_t portBase = (uintptr_t)PORT_REGS;
+
+    for (int i = 0; i < 3; i++)
+    {
+        uintptr_t base = (uintptr_t)SERCOM0_REGS + (uintptr_t)i * 0x400U;
+
+        if ((addr >= base) && (addr < base + sizeof(sercomSize)) && (sercomSize[addr - base] != 0U))
+        {
+            *instance = i;
+            *reg = base + sercomStart[addr - base];
+            *size = sercomSize[addr - base];
+            return DEV_SERCOM;
+        }
+    }
+    if ((addr >= portBase) && (addr < portBase + sizeof(port_registers_t)))
+    {
+        uintptr_t offset = (addr - portBase) % sizeof(port_group_registers_t);
+
+        *size = (offset >= 0x30U) ? 1U : 4U;
+        *reg = (offset >= 0x30U) ? addr : (addr & ~(uintptr_t)3U);
+        return ((offset < 0x2CU) || ((offset >= 0x30U) && (offset < 0x60U))) ? DEV_PORT : DEV_MEMORY;
+    }
+    if ((addr >= SysTick_BASE) && (addr < SysTick_BASE + sizeof(SysTick_Type)))
+    {
+        *reg = addr & ~(uintptr_t)3U;
+        *size = 4;
+        return DEV_SYSTICK;
+    }
+    return DEV_MEMORY;
+}
+
+static uint32_t RegRead(uintptr_t reg)
+{
+    int i = 0;
+    uintptr_t start;
+    uint8_t size;
+
+    switch (Decode(reg, &i, &start, &size))
+    {
+        case DEV_SERCOM:  return SercomRead(&sercom[i], (uint32_t)(start - (uintptr_t)SERCOM0_REGS - (uintptr_t)i * 0x400U));
+        case DEV_PORT:    return PortRead((uint32_t)(start - (uintptr_t)PORT_REGS));
+        case DEV_SYSTICK: return SysTickRead((uint32_t)(start - SysTick_BASE));
+        default:          return 0;
+    }
+}
+
+static void RegReadDone(uintptr_t reg)
+{
+    int i = 0;
+    uintptr_t start;
+    uint8_t size;
+
+    switch (Decode(reg, &i, &start, &size))
+    {
+        case DEV_SERCOM:
+            SercomReadDone(&sercom[i], (uint32_t)(start - (uintptr_t)SERCOM0_REGS - (uintptr_t)i * 0x400U));
+            break;
+        case DEV_SYSTICK:
+            if (start == SysTick_BASE)
+                systick.countFlag = false;
+            break;
+        default:
+            break;
+    }
+}
+
+static void RegWrite(uintptr_t reg, uint32_t value)
+{
+    int i = 0;
+    uintptr_t start;
+    uint8_t size;
+
+    switch (Decode(reg, &i, &start, &size))
+    {
+        case DEV_SERCOM:
+            SercomWrite(&sercom[i], (uint32_t)(start - (uintptr_t)SERCOM0_REGS - (uintptr_t)i * 0x400U), value);
+            break;
+        case DEV_PORT:
+            PortWrite((uint32_t)(start - (uintptr_t)PORT_REGS), value);
+            break;
+        case DEV_SYSTICK:
+            SysTickWrite((uint32_t)(start - SysTick_BASE), value);
+            break;
+        default:
+            break;
+    }
+}
+
+// *****************************************************************************
+// Section: Time
+// *****************************************************************************
+
+static uint64_t NextEvent(void)
+{
+    uint64_t next = systick.wrapAt;
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (sercom[i].shiftAt < next)
+            next = sercom[i].shiftAt;
+        if (sercom[i].busFreeAt < next)
+            next = sercom[i].busFreeAt;
+    }
+    return (peerAt < next) ? peerAt : next;
+}
+
+static void Advance(uint64_t t)
+{
+    uint64_t next;
+
+    while ((next = NextEvent()) <= t)
+    {
+        if (next > now)
+            now = next;
+        if (systick.wrapAt <= now)
+            SysTickEvent();
+        for (int i = 0; i < 3; i++)
+            SercomEvents(&sercom[i]);
+        if (peerAt <= now)
+            PeerCharDone();
+    }
+    if (t > now)
+        now = t;
+}
+
+// *****************************************************************************
+// Section: NVIC and exceptions
+// *****************************************************************************
+
+static bool Pending(int index)
+{
+    if ((nvic.pending & (1UL << index)) != 0U)
+        return true;
+    if ((index >= SERCOM0_IRQn) && (index <= SERCOM2_IRQn))
+        return SercomLine(&sercom[index - SERCOM0_IRQn]);
+    return false;
+}
+
+static bool IrqEnabled(int index)
+{
+    return (index == SYSTICK_INDEX) || ((nvic.enabled & (1UL << index)) != 0U);
+}
+
+/* Highest priority interrupt that would be taken now, -1 if none */
+static int Takeable(void)
+{
+    uint8_t current = (depth > 0) ? frames[depth - 1].priority : THREAD_PRIORITY;
+    int best = -1;
+
+    if (nvic.primask != 0U)
+        return -1;
+
+    /* SysTick first: equal priorities go to the lowest exception number */
+    if (Pending(SYSTICK_INDEX) && (nvic.priority[SYSTICK_INDEX] < current))
+    {
+        best = SYSTICK_INDEX;
+        current = nvic.priority[SYSTICK_INDEX];
+    }
+    for (int i = 0; i < SYSTICK_INDEX; i++)
+    {
+        if (IrqEnabled(i) && Pending(i) && (nvic.priority[i] < current) &&
+            ((best != SYSTICK_INDEX) || (nvic.priority[i] < nvic.priority[SYSTICK_INDEX])))
+        {
+            best = i;
+            current = nvic.priority[i];
+        }
+    }
+    return best;
+}
+
+static bool AnyPending(void)
+{
+    for (int i = 0; i <= SYSTICK_INDEX; i++)
+    {
+        if (IrqEnabled(i) && Pending(i))
+            return true;
+    }
+    return false;
+}
+
+static void __attribute__((noreturn, used)) IrqEntry(long index)
+{
+    void (*handler)(void) = Handler((int)index);
+
+    if (handler == NULL)
+        Fatal("interrupt without a handler");
+    handler();
+    sercomModelReturnTrap();
+    __builtin_unreachable();
+}
+
+static size_t FpSize(const void* fp)
+{
+    uint32_t sw[2];
+
+    /* struct _fpx_sw_bytes at offset 464 of the fxsave area */
+    memcpy(sw, (const uint8_t*)fp + 464, sizeof(sw));
+    return (sw[0] == FP_XSTATE_MAGIC) ? sw[1] : 512U;
+}
+
+static void Enter(ucontext_t* uc, int index)
+{
+    greg_t* g = uc->uc_mcontext.gregs;
+    MODEL_FRAME* f;
+    uintptr_t sp;
+
+    if (depth == MAX_NESTING)
+        Fatal("interrupts nested too deep");
+    f = &frames[depth++];
+    f->index = index;
+    f->priority = nvic.priority[index];
+    f->start = now;
+    f->inModel = inModel;
+    inModel = 0;
+    memcpy(f->gregs, g, sizeof(f->gregs));
+    f->fpSize = FpSize(uc->uc_mcontext.fpregs);
+    if (f->fpSize > FP_SAVE_MAX)
+        Fatal("FPU state too large");
+    memcpy(f->fp, uc->uc_mcontext.fpregs, f->fpSize);
+
+    nvic.pending &= ~(1UL << index);
+    Advance(now + SERCOM_MODEL_IRQ_ENTRY_CYCLES);
+
+    /* Call IrqEntry(index) on the interrupted stack, below its red zone */
+    sp = (((uintptr_t)g[REG_RSP] - 128U) & ~(uintptr_t)15U) - 8U;
+    *(uint64_t*)sp = 0;
+    g[REG_RSP] = (greg_t)sp;
+    g[REG_RIP] = (greg_t)(uintptr_t)IrqEntry;
+    g[REG_RDI] = index;
+    g[REG_EFL] = (g[REG_EFL] | EFLAGS_TF) & ~(greg_t)EFLAGS_DF;
+}
+
+static void Return(ucontext_t* uc)
+{
+    MODEL_FRAME* f = &frames[--depth];
+    SERCOM_MODEL_IRQ_STATS* st = &irqStats[f->index];
+    uint64_t cycles;
+
+    Advance(now + SERCOM_MODEL_IRQ_EXIT_CYCLES);
+    cycles = now - f->start;
+    st->calls++;
+    st->cycles += cycles;
+    if (cycles > st->cyclesMax)
+        st->cyclesMax = (uint32_t)cycles;
+
+    inModel = f->inModel;
+    memcpy(uc->uc_mcontext.gregs, f->gregs, sizeof(f->gregs));
+    memcpy(uc->uc_mcontext.fpregs, f->fp, f->fpSize);
+}
+
+/* Take pending interrupts at a point where C code may be interrupted */
+static void IrqCheck(void)
+{
+    if (Takeable() >= 0)
+        sercomModelCheckTrap();
+}
+
+// *****************************************************************************
+// Section: Signals
+// *****************************************************************************
+
+static uintptr_t PageOf(uintptr_t addr)
+{
+    for (size_t i = 0; i < sizeof(pages) / sizeof(pages[0]); i++)
+    {
+        if ((addr >= pages[i]) && (addr < pages[i] + PAGE_SIZE))
+            return pages[i];
+    }
+    return 0;
+}
+
+static void ModelSegv(int sig, siginfo_t* si, void* context)
+{
+    ucontext_t* uc = context;
+    uintptr_t addr = (uintptr_t)si->si_addr;
+    uintptr_t page = PageOf(addr);
+    int instance;
+
+    (void)sig;
+    if ((page == 0U) || step.pending)
+    {
+        /* A real crash: let it happen with the default action */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    (void)mprotect((void*)page, PAGE_SIZE, PROT_READ | PROT_WRITE);
+    step.pending = true;
+    step.page = page;
+    step.write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+    if (Decode(addr, &instance, &step.reg, &step.size) == DEV_MEMORY)
+    {
+        step.reg = 0;
+    }
+    else
+    {
+        step.presented = RegRead(step.reg);
+        memcpy((void*)step.reg, &step.presented, step.size);
+    }
+    uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+static void AccessDone(void)
+{
+    uint32_t value = 0;
+
+    if (step.reg != 0U)
+        memcpy(&value, (const void*)step.reg, step.size);
+    (void)mprotect((void*)step.page, PAGE_SIZE, PROT_NONE);
+    step.pending = false;
+
+    if (step.reg != 0U)
+    {
+        /* A read-modify-write instruction may fault as a read: its store shows */
+        if (step.write || (value != step.presented))
+            RegWrite(step.reg, value);
+        else
+            RegReadDone(step.reg);
+    }
+    Advance(now + SERCOM_MODEL_ACCESS_CYCLES);
+}
+
+static void ModelTrap(int sig, siginfo_t* si, void* context)
+{
+    ucontext_t* uc = context;
+    greg_t* g = uc->uc_mcontext.gregs;
+    uintptr_t rip = (uintptr_t)g[REG_RIP];
+    int index;
+
+    (void)sig;
+    (void)si;
+    if (step.pending)
+        AccessDone();
+    else if (rip == (uintptr_t)sercomModelReturnTrap + 1U)
+        Return(uc);
+    else if ((rip != (uintptr_t)sercomModelCheckTrap + 1U) && (depth > 0) && (inModel == 0))
+        Advance(now + 1U);              // one instruction of an interrupt handler
+
+    /* Handlers are single-stepped to count their cycles */
+    if (depth > 0)
+        g[REG_EFL] |= EFLAGS_TF;
+    else
+        g[REG_EFL] &= ~(greg_t)EFLAGS_TF;
+
+    index = Takeable();
+    if (index >= 0)
+        Enter(uc, index);
+}
+
+// *****************************************************************************
+// Section: CMSIS stand-ins
+// *****************************************************************************
+
+/* Single-stepped from a handler they cost nothing: CPSIE / CPSID and NVIC stores
+   are single instructions on the target */
+#define MODEL_BEGIN()   inModel++
+#define MODEL_END()     inModel--
+
+void __enable_irq(void)
+{
+    MODEL_BEGIN();
+    nvic.primask = 0;
+    IrqCheck();
+    MODEL_END();
+}
+
+void __disable_irq(void)
+{
+    nvic.primask = 1;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return nvic.primask;
+}
+
+void __WFI(void)
+{
+    uint64_t next;
+
+    MODEL_BEGIN();
+    while (!AnyPending() && ((next = NextEvent()) != NEVER))
+        Advance(next);
+    IrqCheck();
+    MODEL_END();
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    MODEL_BEGIN();
+    if (index >= 0)
+    {
+        nvic.enabled |= 1UL << index;
+        IrqCheck();
+    }
+    MODEL_END();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    if (index >= 0)
+        nvic.enabled &= ~(1UL << index);
+}
+
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    return ((index >= 0) && IrqEnabled(index)) ? 1U : 0U;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    MODEL_BEGIN();
+    if (index >= 0)
+    {
+        nvic.pending |= 1UL << index;
+        IrqCheck();
+    }
+    MODEL_END();
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    if (index >= 0)
+        nvic.pending &= ~(1UL << index);
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+    bool pending;
+
+    MODEL_BEGIN();
+    pending = (index >= 0) && Pending(index);
+    MODEL_END();
+    return pending ? 1U : 0U;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    int index = Index(IRQn);
+
+    MODEL_BEGIN();
+    if (index >= 0)
+    {
+        nvic.priority[index] = (uint8_t)(priority & ((1U << __NVIC_PRIO_BITS) - 1U));
+        IrqCheck();
+    }
+    MODEL_END();
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    int index = Index(IRQn);
+
+    return (index >= 0) ? nvic.priority[index] : 0U;
+}
+
+// *****************************************************************************
+// Section: Model interface
+// *****************************************************************************
+
+void SERCOM_Model_Init(void)
+{
+    struct sigaction sa;
+
+    if (depth != 0)
+        Fatal("SERCOM_Model_Init() from an interrupt handler");
+
+    if (!mapped)
+    {
+        for (size_t i = 0; i < sizeof(pages) / sizeof(pages[0]); i++)
+        {
+            void* p = mmap((void*)pages[i], PAGE_SIZE, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+            if (p != (void*)pages[i])
+                Fatal("cannot map the peripheral pages");
+        }
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_flags = SA_SIGINFO;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_sigaction = ModelSegv;
+        sigaction(SIGSEGV, &sa, NULL);
+        sa.sa_sigaction = ModelTrap;
+        sigaction(SIGTRAP, &sa, NULL);
+        mapped = true;
+    }
+
+    now = 0;
+    for (int i = 0; i < 3; i++)
+        SercomReset(&sercom[i]);
+    memset(&port, 0, sizeof(port));
+    port.scl = true;
+    memset(&systick, 0, sizeof(systick));
+    systick.wrapAt = NEVER;
+    memset(&nvic, 0, sizeof(nvic));
+    SERCOM_Model_IrqStatsClear();
+
+    memset(slaves, 0, sizeof(slaves));
+    slaveActive = -1;
+    faultCountdown = 0;
+    sdaHeld = 0;
+    sclStuck = false;
+
+    spiSlave = NULL;
+    mosiCount = 0;
+    peerTxHead = 0;
+    peerTxCount = 0;
+    peerAt = NEVER;
+    peerBaud = 0;
+    peerParityError = false;
+    peerRxCount = 0;
+}
+
+uint64_t SERCOM_Model_Cycles(void)
+{
+    return now;
+}
+
+void SERCOM_Model_Run(uint32_t cycles)
+{
+    uint64_t target = now + cycles;
+
+    IrqCheck();
+    while (now < target)
+    {
+        uint64_t next = NextEvent();
+
+        Advance((next < target) ? next : target);
+        IrqCheck();
+    }
+}
+
+bool SERCOM_Model_RunWhile(bool (*busy)(void), uint32_t maxCycles)
+{
+    uint64_t deadline = now + maxCycles;
+
+    IrqCheck();
+    while (busy())
+    {
+        uint64_t next = NextEvent();
+
+        if (now >= deadline)
+            return false;
+        if (next > deadline)
+            next = deadline;
+        if (next < now + SERCOM_MODEL_POLL_CYCLES)
+            next = now + SERCOM_MODEL_POLL_CYCLES;
+        Advance(next);
+        IrqCheck();
+    }
+    return true;
+}
+
+void SERCOM_Model_IrqStatsGet(IRQn_Type irq, SERCOM_MODEL_IRQ_STATS* stats)
+{
+    int index = Index(irq);
+
+    if (index >= 0)
+        *stats = irqStats[index];
+    else
+        memset(stats, 0, sizeof(*stats));
+}
+
+void SERCOM_Model_IrqStatsClear(void)
+{
+    memset(irqStats, 0, sizeof(irqStats));
+}
+
+void SERCOM_Model_I2CSlave(uint8_t address, uint8_t regs[], uint16_t size, uint8_t width)
+{
+    int i = SlaveFind(address);
+
+    if (i < 0)
+        i = SlaveFind(0);
+    for (int j = 0; (i < 0) && (j < MAX_I2C_SLAVES); j++)
+    {
+        if (slaves[j].regs == NULL)
+            i = j;
+    }
+    if (i < 0)
+        Fatal("too many I2C slaves");
+
+    slaves[i].address = address;
+    slaves[i].regs = regs;
+    slaves[i].size = size;
+    slaves[i].width = width;
+    slaves[i].pointer = 0;
+    slaves[i].transactions = 0;
+}
+
+void SERCOM_Model_I2CSlaveRemove(uint8_t address)
+{
+    int i = SlaveFind(address);
+
+    if (i >= 0)
+    {
+        if (slaveActive == i)
+            slaveActive = -1;
+        memset(&slaves[i], 0, sizeof(slaves[i]));
+    }
+}
+
+uint32_t SERCOM_Model_I2CTransactions(uint8_t address)
+{
+    int i = SlaveFind(address);
+
+    return (i >= 0) ? slaves[i].transactions : 0U;
+}
+
+void SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_FAULT fault, uint32_t byte)
+{
+    faultKind = fault;
+    faultCountdown = byte;
+}
+
+void SERCOM_Model_I2CHoldSda(uint8_t clocks)
+{
+    sdaHeld = clocks;
+}
+
+void SERCOM_Model_SPISlave(SERCOM_MODEL_SPI_SLAVE slave)
+{
+    spiSlave = slave;
+}
+
+uint32_t SERCOM_Model_SPIMosi(uint8_t data[], uint32_t max)
+{
+    uint32_t n = (mosiCount < max) ? mosiCount : max;
+
+    memcpy(data, mosiLog, n);
+    memmove(mosiLog, mosiLog + n, mosiCount - n);
+    mosiCount -= n;
+    return n;
+}
+
+void SERCOM_Model_USARTSend(const uint8_t data[], uint32_t count)
+{
+    MODEL_SERCOM* s = SercomInMode(MODE_USART);
+
+    for (uint32_t i = 0; (i < count) && (peerTxCount < LOG_SIZE); i++)
+    {
+        peerTx[(peerTxHead + peerTxCount) % LOG_SIZE] = data[i];
+        peerTxCount++;
+    }
+    if ((peerAt == NEVER) && (peerTxCount != 0U) && (s != NULL))
+        peerAt = now + PeerCharCycles(s);
+}
+
+void SERCOM_Model_USARTPeerBaud(uint32_t baud)
+{
+    peerBaud = baud;
+}
+
+void SERCOM_Model_USARTParityError(void)
+{
+    peerParityError = true;
+}
+
+uint32_t SERCOM_Model_USARTReceived(uint8_t data[], uint32_t max)
+{
+    uint32_t n = (peerRxCount < max) ? peerRxCount : max;
+
+    memcpy(data, peerRx, n);
+    memmove(peerRx, peerRx + n, peerRxCount - n);
+    peerRxCount -= n;
+    return n;
+}
@@ -0,0 +1,91 @@
+/*
+ * File:   sercom_model.h
+ * Comments: Cycle-approximate host model of SERCOM0~2, PORT, SysTick and the NVIC
+ *           for running the generated plibs unchanged on Linux (x86-64).
+ *
+ *           The peripheral pages of the DFP memory map (PORT, SERCOM0~5, SysTick)
+ *           are mapped at their real addresses without access rights, so every
+ *           SERCOMn_REGS / PORT_REGS / SysTick access traps into the model, which
+ *           applies the register side effects (write-1-to-clear flags, DATA FIFOs,
+ *           INTENSET/INTENCLR, I2C commands) and advances a virtual core clock.
+ *           Bus traffic is scheduled from the BAUD registers. A SERCOM interrupt
+ *           line is INTFLAG & INTENSET; when it is enabled in the NVIC and PRIMASK
+ *           allows, SERCOMn_*_InterruptHandler() runs right after the register
+ *           access that raised it, preempting the code under test like an IRQ.
+ *
+ *           Timing: CPU_CLOCK_FREQUENCY core cycles per second, the SERCOM clocks
+ *           run from the same clock. Thread code costs only its register accesses
+ *           (SERCOM_MODEL_ACCESS_CYCLES each); interrupt handlers are single-stepped
+ *           and cost one cycle per host instruction plus the exception entry and
+ *           return. Busy-wait loops on RAM flags never see time pass: wait with
+ *           SERCOM_Model_Run() / SERCOM_Model_RunWhile() instead.
+ *
+ *           Each bus serves whichever SERCOM runs in its mode: the I2C slaves
+ *           below answer the I2C master, the SPI slave the SPI master, the USART
+ *           peer both lines of the USART.
+ */
+
+#ifndef SERCOM_MODEL_H
+#define SERCOM_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "device.h"
+
+#define SERCOM_MODEL_ACCESS_CYCLES      3     // peripheral load/store through the APB bridge
+#define SERCOM_MODEL_SYNC_CYCLES        6     // SYNCBUSY after a synchronized write
+#define SERCOM_MODEL_IRQ_ENTRY_CYCLES   15    // Cortex-M0+ exception entry
+#define SERCOM_MODEL_IRQ_EXIT_CYCLES    10    // exception return
+#define SERCOM_MODEL_POLL_CYCLES        8     // one turn of a SERCOM_Model_RunWhile() poll
+
+// Map the registers (first call) and reset every peripheral, the NVIC and the clock
+void     SERCOM_Model_Init(void);
+uint64_t SERCOM_Model_Cycles(void);             // core cycles since SERCOM_Model_Init()
+
+// Let time pass in thread mode (WFI), taking interrupts as they come
+void     SERCOM_Model_Run(uint32_t cycles);
+// Run while busy() returns true; false if it still did after maxCycles
+bool     SERCOM_Model_RunWhile(bool (*busy)(void), uint32_t maxCycles);
+
+// Exception counters kept by the model, entry to return, nested ones included
+typedef struct
+{
+    uint32_t    calls;
+    uint64_t    cycles;
+    uint32_t    cyclesMax;
+} SERCOM_MODEL_IRQ_STATS;
+void     SERCOM_Model_IrqStatsGet(IRQn_Type irq, SERCOM_MODEL_IRQ_STATS* stats);
+void     SERCOM_Model_IrqStatsClear(void);
+
+// I2C: register file slaves like the ones of i2c_stub.c, width 1 or 2 register
+// address bytes before the data; width 0 streams every transaction into regs[]
+// from the start. Unknown addresses are NAKed.
+void     SERCOM_Model_I2CSlave(uint8_t address, uint8_t regs[], uint16_t size, uint8_t width);
+void     SERCOM_Model_I2CSlaveRemove(uint8_t address);
+uint32_t SERCOM_Model_I2CTransactions(uint8_t address);  // START...STOP / repeated START seen
+
+typedef enum
+{
+    SERCOM_MODEL_I2C_NAK,           // the byte is not acknowledged
+    SERCOM_MODEL_I2C_ARBLOST,       // another master wins the byte and keeps the bus a while
+    SERCOM_MODEL_I2C_BUSERR,        // misplaced START/STOP during the byte
+    SERCOM_MODEL_I2C_SCL_STUCK,     // a slave stretches SCL until the master is disabled
+} SERCOM_MODEL_I2C_FAULT;
+
+// Fault on the n-th byte (address or data) from now, 1 = the next one
+void     SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_FAULT fault, uint32_t byte);
+// A slave lost in the middle of a read holds SDA low until it sees this many SCL pulses
+void     SERCOM_Model_I2CHoldSda(uint8_t clocks);
+
+// SPI: the slave answers every character shifted out; NULL wires MISO to MOSI
+typedef uint16_t (*SERCOM_MODEL_SPI_SLAVE)(uint16_t mosi);
+void     SERCOM_Model_SPISlave(SERCOM_MODEL_SPI_SLAVE slave);
+uint32_t SERCOM_Model_SPIMosi(uint8_t data[], uint32_t max);    // take what went out on MOSI
+
+// USART: the peer sends the queued characters back to back at its own baud rate
+void     SERCOM_Model_USARTSend(const uint8_t data[], uint32_t count);
+void     SERCOM_Model_USARTPeerBaud(uint32_t baud);              // 0 = exactly the receiver's rate
+void     SERCOM_Model_USARTParityError(void);                    // the next character has bad parity
+uint32_t SERCOM_Model_USARTReceived(uint8_t data[], uint32_t max);  // take what went out on TX
+
+#endif /* SERCOM_MODEL_H */
@@ -0,0 +1,257 @@
+/*
+ * File:   ssd1306_model.c
+ * Comments: Host-side SSD1306 model, see ssd1306_model.h. Segment and COM remap
+ *           (0xA0/0xA1, 0xC0/0xC8) only flip the glass and are not modelled: the
+ *           rendered image is the panel in its intended orientation.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_model.h"
+
+SSD1306_MODEL ssd1306;
+
+/* Multi-byte command being collected */
+static uint8_t  cmdBuf[8];
+static uint8_t  cmdLen, cmdNeed;
+
+void SSD1306_Reset(void)
+{
+    memset(&ssd1306, 0, sizeof(ssd1306));
+    ssd1306.mode = 2;
+    ssd1306.colEnd = SSD1306_COLUMNS - 1;
+    ssd1306.pageEnd = SSD1306_PAGES - 1;
+    ssd1306.scrollRows = SSD1306_ROWS;
+    ssd1306.contrast = 0x7F;
+    cmdLen = 0;
+    cmdNeed = 0;
+}
+
+void SSD1306_CountersClear(void)
+{
+    ssd1306.transactions = 0;
+    ssd1306.bytes = 0;
+    ssd1306.commandBytes = 0;
+    ssd1306.dataBytes = 0;
+}
+
+/* Argument bytes following a command byte */
+static uint8_t ArgCount(uint8_t c)
+{
+    switch (c)
+    {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22: case 0xA3:
+            return 2;
+        case 0x29: case 0x2A:
+            return 5;
+        case 0x26: case 0x27:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+/* Datasheet, 0xA3: the display start line must be below the scroll area's row count */
+static void CheckStartLine(void)
+{
+    if (ssd1306.startLine >= ssd1306.scrollRows)
+        ssd1306.badStartLines++;
+}
+
+static void ExecCommand(const uint8_t* c)
+{
+    switch (c[0])
+    {
+        case 0x20: ssd1306.mode = c[1] & 3; break;
+        case 0x21:
+            ssd1306.colStart = c[1] & 0x7F;
+            ssd1306.colEnd = c[2] & 0x7F;
+            ssd1306.col = ssd1306.colStart;
+            break;
+        case 0x22:
+            ssd1306.pageStart = c[1] & 7;
+            ssd1306.pageEnd = c[2] & 7;
+            ssd1306.page = ssd1306.pageStart;
+            break;
+        case 0x26: case 0x27: case 0x29: case 0x2A: break;
+        case 0x2E: ssd1306.scrolling = false; break;
+        case 0x2F: ssd1306.scrolling = true; break;
+        case 0x81: ssd1306.contrast = c[1]; break;
+        case 0xA3:
+            ssd1306.scrollTop = c[1] & 0x3F;
+            ssd1306.scrollRows = c[2] & 0x7F;
+            CheckStartLine();
+            break;
+        case 0xA4: ssd1306.entireOn = false; break;
+        case 0xA5: ssd1306.entireOn = true; break;
+        case 0xA6: ssd1306.inverse = false; break;
+        case 0xA7: ssd1306.inverse = true; break;
+        case 0xAE: ssd1306.displayOn = false; break;
+        case 0xAF: ssd1306.displayOn = true; break;
+        case 0xD3: ssd1306.offset = c[1] & 0x3F; break;
+        case 0x8D: case 0xA8: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        case 0xA0: case 0xA1: case 0xC0: case 0xC8: case 0xE3:
+            break;
+        default:
+            if (c[0] <= 0x0F)
+            {
+                if (ssd1306.mode == 2) ssd1306.col = (uint8_t)((ssd1306.col & 0xF0) | c[0]);
+            }
+            else if (c[0] <= 0x1F)
+            {
+                if (ssd1306.mode == 2) ssd1306.col = (uint8_t)((ssd1306.col & 0x0F) | ((c[0] & 0x07) << 4));
+            }
+            else if ((c[0] >= 0x40) && (c[0] <= 0x7F))
+            {
+                ssd1306.startLine = c[0] & 0x3F;
+                CheckStartLine();
+            }
+            else if ((c[0] >= 0xB0) && (c[0] <= 0xB7))
+            {
+                if (ssd1306.mode == 2) ssd1306.page = c[0] & 7;
+            }
+            else
+                ssd1306.unknownCommands++;
+            break;
+    }
+}
+
+static void CommandByte(uint8_t b)
+{
+    ssd1306.commandBytes++;
+    if (cmdLen == 0)
+        cmdNeed = ArgCount(b);
+    cmdBuf[cmdLen++] = b;
+    if (cmdLen > cmdNeed)
+    {
+        ExecCommand(cmdBuf);
+        cmdLen = 0;
+    }
+}
+
+static void DataByte(uint8_t b)
+{
+    ssd1306.dataBytes++;
+    ssd1306.gddram[ssd1306.page][ssd1306.col] = b;
+
+    switch (ssd1306.mode)
+    {
+        case 0:
+            if (ssd1306.col++ >= ssd1306.colEnd)
+            {
+                ssd1306.col = ssd1306.colStart;
+                if (ssd1306.page++ >= ssd1306.pageEnd)
+                    ssd1306.page = ssd1306.pageStart;
+            }
+            break;
+        case 1:
+            if (ssd1306.page++ >= ssd1306.pageEnd)
+            {
+                ssd1306.page = ssd1306.pageStart;
+                if (ssd1306.col++ >= ssd1306.colEnd)
+                    ssd1306.col = ssd1306.colStart;
+            }
+            break;
+        default:
+            ssd1306.col = (uint8_t)((ssd1306.col + 1) & 0x7F);
+            break;
+    }
+}
+
+void SSD1306_Transaction(uint16_t address, const uint8_t* data, uint32_t length)
+{
+    uint32_t    i = 0;
+    uint8_t     control;
+
+    if (address != SSD1306_ADDRESS)
+        return;
+    ssd1306.transactions++;
+    ssd1306.bytes += length;
+
+    /* Control byte: Co (bit 7) = 1 means one byte follows and then another control byte */
+    while (i < length)
+    {
+        control = data[i++];
+        if (control & 0x80)
+        {
+            if (i < length)
+            {
+                if (control & 0x40) DataByte(data[i]);
+                else                CommandByte(data[i]);
+                i++;
+            }
+        }
+        else
+        {
+            for (; i < length; i++)
+            {
+                if (control & 0x40) DataByte(data[i]);
+                else                CommandByte(data[i]);
+            }
+        }
+    }
+    cmdLen = 0;     // a STOP ends any unfinished command
+}
+
+bool SSD1306_Pixel(uint8_t x, uint8_t y)
+{
+    uint8_t row = (uint8_t)((y + ssd1306.offset) & 0x3F);
+    bool    on;
+
+    if (!ssd1306.displayOn)
+        return false;
+    if (ssd1306.entireOn)
+        return true;
+
+    /* Start line rotates the rows inside the vertical scroll area, counted from its
+       top row; rows above it stay */
+    if ((row >= ssd1306.scrollTop) && (row < ssd1306.scrollTop + ssd1306.scrollRows))
+        row = (uint8_t)(ssd1306.scrollTop + ((row - ssd1306.scrollTop + ssd1306.startLine) % ssd1306.scrollRows));
+    on = ((ssd1306.gddram[row >> 3][x] >> (row & 7)) & 1) != 0;
+    return on != ssd1306.inverse;
+}
+
+bool SSD1306_WritePGM(const char* path)
+{
+    FILE*   f = fopen(path, "wb");
+    uint8_t x, y;
+
+    if (f == NULL)
+        return false;
+    fprintf(f, "P5\n%d %d\n255\n", SSD1306_COLUMNS, SSD1306_ROWS);
+    for (y = 0; y < SSD1306_ROWS; y++)
+        for (x = 0; x < SSD1306_COLUMNS; x++)
+            fputc(SSD1306_Pixel(x, y) ? 255 : 0, f);
+    fclose(f);
+    return true;
+}
+
+int SSD1306_ComparePGM(const char* path)
+{
+    FILE*   f = fopen(path, "rb");
+    int     w, h, max, diff = 0, c;
+    uint8_t x, y;
+
+    if (f == NULL)
+        return -1;
+    if ((fscanf(f, "P5 %d %d %d", &w, &h, &max) != 3) || (w != SSD1306_COLUMNS) || (h != SSD1306_ROWS))
+    {
+        fclose(f);
+        return -1;
+    }
+    fgetc(f);
+    for (y = 0; y < SSD1306_ROWS; y++)
+    {
+        for (x = 0; x < SSD1306_COLUMNS; x++)
+        {
+            c = fgetc(f);
+            if ((c == EOF) || ((c != 0) != SSD1306_Pixel(x, y)))
+                diff++;
+        }
+    }
+    fclose(f);
+    return diff;
+}
@@ -0,0 +1,55 @@
+/*
+ * File:   ssd1306_model.h
+ * Comments: Host-side software model of the SSD1306 controller. Consumes the I2C
+ *           write transactions the OLED driver sends (control byte + payload),
+ *           decodes commands and GDDRAM data the way the chip does and renders
+ *           the panel as the viewer sees it.
+ */
+
+#ifndef SSD1306_MODEL_H
+#define SSD1306_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSD1306_ADDRESS     0x3C
+#define SSD1306_PAGES       8
+#define SSD1306_COLUMNS     128
+#define SSD1306_ROWS        64
+
+typedef struct
+{
+    uint8_t     gddram[SSD1306_PAGES][SSD1306_COLUMNS];
+
+    uint8_t     mode;           // 0x20: 0 horizontal, 1 vertical, 2 page
+    uint8_t     col, page;      // GDDRAM pointer
+    uint8_t     colStart, colEnd, pageStart, pageEnd;
+    uint8_t     startLine;      // 0x40~0x7F, from the top of the scroll area
+    uint8_t     offset;         // 0xD3
+    uint8_t     scrollTop, scrollRows;  // 0xA3
+    uint8_t     contrast;
+    bool        displayOn, inverse, entireOn, scrolling;
+
+    /* Traffic counters, cleared by SSD1306_CountersClear() */
+    uint32_t    transactions;
+    uint32_t    bytes;          // payload bytes including control bytes, excluding address
+    uint32_t    commandBytes;
+    uint32_t    dataBytes;
+    uint32_t    unknownCommands;
+    uint32_t    badStartLines;  // start line set to or left at >= the scroll area rows
+} SSD1306_MODEL;
+
+extern SSD1306_MODEL ssd1306;
+
+void SSD1306_Reset(void);
+void SSD1306_CountersClear(void);
+void SSD1306_Transaction(uint16_t address, const uint8_t* data, uint32_t length);
+
+/* Panel as seen by the viewer (start line, scroll area, offset, inverse, on/off applied) */
+bool SSD1306_Pixel(uint8_t x, uint8_t y);
+bool SSD1306_WritePGM(const char* path);
+/* Compare against a PGM written by SSD1306_WritePGM; returns the number of differing pixels,
+   or -1 if the file cannot be read */
+int  SSD1306_ComparePGM(const char* path);
+
+#endif /* SSD1306_MODEL_H */
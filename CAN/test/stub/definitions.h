@@ -0,0 +1,22 @@
+/*
+ * File:   definitions.h (host stub)
+ * Comments: Host replacement for config/default/definitions.h. Pulls in only the
+ *           plib interfaces the OLED driver uses; i2c_stub.c implements them on
+ *           top of the SSD1306 model.
+ */
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "peripheral/sercom/i2c_master/plib_sercom2_i2c_master.h"
+
+/* Single threaded on the host: the stub runs callbacks synchronously */
+#define SERCOM2_IRQn                9
+#define NVIC_DisableIRQ(irq)        ((void)(irq))
+#define NVIC_EnableIRQ(irq)         ((void)(irq))
+
+#endif /* DEFINITIONS_H */
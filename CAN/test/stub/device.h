@@ -0,0 +1,10 @@
+/*
+ * File:   device.h (host stub)
+ * Comments: Stands in for the DFP device header in host builds. The driver code
+ *           under test only needs the plib interface types, not the registers.
+ */
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#endif /* DEVICE_H */
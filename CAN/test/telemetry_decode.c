@@ -0,0 +1,101 @@
+/*
+ * File:   telemetry_decode.c
+ * Comments: Host decoder for the binary telemetry stream of CAN/src/TELEMETRY.c.
+ *           Reads the raw UART bytes from a file or stdin and prints one CSV
+ *           line per record; the summary on stderr counts bad frames (text
+ *           before the stream started, corrupted bytes), sequence gaps (records
+ *           the board dropped) and the record rate from the timestamps.
+ *
+ *             stty -F /dev/ttyACM0 115200 raw
+ *             ./build/telemetry_decode /dev/ttyACM0 > frames.csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TELEMETRY.h"
+
+/* The frame's CAN CRC-15 again (crc15() of main.c), to flag records whose
+   crc15 does not match their ID, DLC and data */
+static uint16_t Crc15Bits(uint16_t crc, uint32_t value, int bits)
+{
+    while (bits-- > 0) {
+        int n = (int)((value >> bits) & 1U) ^ ((crc >> 14) & 1);
+
+        crc = (uint16_t)((crc << 1) & 0x7FFF);
+        if (n)
+            crc ^= 0x4599;
+    }
+    return crc;
+}
+
+static uint16_t Crc15(const TELEM_CAN_RECORD* r)
+{
+    uint16_t    crc = Crc15Bits(Crc15Bits(0, r->id, 11), r->dlc, 4);
+    int         i;
+
+    for (i = 0; i < r->dlc; i++)
+        crc = Crc15Bits(crc, r->data[i], 8);
+    return crc;
+}
+
+int main(int argc, char** argv)
+{
+    FILE*           in = stdin;
+    uint8_t         frame[256];
+    size_t          len = 0;
+    int             c;
+    TELEM_CAN_RECORD r;
+    unsigned long   records = 0, bad = 0, lost = 0;
+    uint32_t        first = 0, last = 0;
+    uint8_t         seq = 0;
+    int             i;
+
+    if ((argc > 1) && ((in = fopen(argv[1], "rb")) == NULL)) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    printf("seq,time_us,id,dlc,data,crc15,crc15_ok,rpm,speed,throttle,brake,manual,sw1,sw2\n");
+    while ((c = fgetc(in)) != EOF) {
+        if (c != 0) {
+            if (len < sizeof(frame))
+                frame[len] = (uint8_t)c;
+            len++;
+            continue;
+        }
+        if (len == 0)
+            continue;
+        if ((len > sizeof(frame)) || !TELEM_Decode(frame, len, &r)) {
+            bad++;
+            len = 0;
+            continue;
+        }
+        len = 0;
+
+        if (records == 0)
+            first = r.time;
+        else
+            lost += (uint8_t)(r.seq - seq - 1U);
+        seq = r.seq;
+        last = r.time;
+        records++;
+
+        printf("%u,%lu,0x%03X,%u,", r.seq, (unsigned long)r.time, r.id, r.dlc);
+        for (i = 0; i < r.dlc; i++)
+            printf("%s%02X", (i == 0) ? "" : " ", r.data[i]);
+        printf(",0x%04X,%d,%u,%u,%u,%d,%d,%d,%d\n", r.crc15, Crc15(&r) == r.crc15,
+               r.rpm, r.speed, r.throttle,
+               (r.flags & TELEM_FLAG_BRAKE) != 0, (r.flags & TELEM_FLAG_MANUAL) != 0,
+               (r.flags & TELEM_FLAG_SW1) != 0, (r.flags & TELEM_FLAG_SW2) != 0);
+    }
+
+    fprintf(stderr, "%lu records, %lu bad frames, %lu lost", records, bad, lost);
+    if ((records > 1) && (last != first))
+        fprintf(stderr, ", %.1f records/s",
+                (double)(records - 1) * 1e6 / (double)(uint32_t)(last - first));
+    fprintf(stderr, "\n");
+    if (in != stdin)
+        fclose(in);
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * File:   test_format.c
+ * Comments: Host tests for CAN/src/FORMAT.c. Every formatter is checked against
+ *           snprintf() on edge values and a few million random ones; the
+ *           timing at the end only compares the two on the host, the saving
+ *           on the board (no divide instruction) is larger.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "FORMAT.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+/* Reports the first few mismatches with the value, then only counts them */
+static int          mismatches;
+
+static void Same(const char* what, long long v, const char* got, size_t len, const char* expect)
+{
+    if ((strcmp(got, expect) == 0) && (len == strlen(expect)))
+        return;
+    if (mismatches++ < 5)
+        printf("  FAIL %s(%lld): \"%s\" (%u), expected \"%s\"\n",
+               what, v, got, (unsigned)len, expect);
+    failures++;
+}
+
+static uint32_t Random32(void)
+{
+    return ((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 5) ^ (uint32_t)rand();
+}
+
+static void Check(uint32_t u)
+{
+    int32_t     s = (int32_t)u;
+    char        got[FMT_BUFFER_SIZE], expect[32];
+    uint32_t    r;
+    size_t      len;
+
+    if ((FMT_Div10(u, &r) != u / 10U) || (r != u % 10U)) {
+        if (mismatches++ < 5)
+            printf("  FAIL FMT_Div10(%u)\n", u);
+        failures++;
+    }
+
+    len = FMT_UInt(got, u);
+    snprintf(expect, sizeof(expect), "%u", u);
+    Same("FMT_UInt", u, got, len, expect);
+
+    len = FMT_Int(got, s);
+    snprintf(expect, sizeof(expect), "%d", s);
+    Same("FMT_Int", s, got, len, expect);
+
+    len = FMT_IntW(got, s, 8);
+    snprintf(expect, sizeof(expect), "%8d", s);
+    Same("FMT_IntW", s, got, len, expect);
+
+    len = FMT_UIntZ(got, u, 6);
+    snprintf(expect, sizeof(expect), "%06u", u);
+    Same("FMT_UIntZ", u, got, len, expect);
+
+    len = FMT_Hex(got, u, 8);
+    snprintf(expect, sizeof(expect), "%08X", u);
+    Same("FMT_Hex", u, got, len, expect);
+
+    len = FMT_Fixed(got, s, 2);
+    snprintf(expect, sizeof(expect), "%s%lld.%02lld", (s < 0) ? "-" : "",
+             llabs((long long)s) / 100, llabs((long long)s) % 100);
+    Same("FMT_Fixed", s, got, len, expect);
+}
+
+static void TestValues(void)
+{
+    static const uint32_t edges[] = {
+        0, 1, 9, 10, 11, 99, 100, 101, 999, 1000, 9999, 10000, 65535, 65536,
+        99999, 100000, 999999, 1000000, 9999999, 10000000, 99999999, 100000000,
+        999999999, 1000000000, 0x7FFFFFFFU, 0x80000000U, 0x80000001U,
+        4294967286U, 4294967289U, 4294967290U, 4294967294U, 4294967295U
+    };
+    uint32_t    i, v;
+
+    printf("values against snprintf\n");
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+        Check(edges[i]);
+        Check(0U - edges[i]);
+    }
+    for (v = 0; v < 200000U; v++)
+        Check(v);
+    /* Around every multiple of 10 the quotient estimate is closest to wrong */
+    for (v = 10; v < 0x55555550U; v = v * 3U + 10U) {
+        Check(v - 1U);
+        Check(v);
+        Check(v + 1U);
+    }
+    srand(24);
+    for (i = 0; i < 500000U; i++)
+        Check(Random32());
+}
+
+static void TestShapes(void)
+{
+    char        buf[FMT_BUFFER_SIZE];
+    char*       p = buf;
+
+    printf("padding, fixed point, chaining\n");
+    CHECK((FMT_IntW(buf, 850, 5) == 5U) && (strcmp(buf, "  850") == 0));
+    CHECK((FMT_IntW(buf, -7, 3) == 3U) && (strcmp(buf, " -7") == 0));
+    CHECK((FMT_IntW(buf, 123456, 3) == 6U) && (strcmp(buf, "123456") == 0));
+    CHECK(FMT_IntW(buf, 1, 200) == FMT_BUFFER_SIZE - 1U);
+    CHECK((FMT_UIntZ(buf, 7, 3) == 3U) && (strcmp(buf, "007") == 0));
+    CHECK((FMT_UIntZ(buf, 0, 0) == 1U) && (strcmp(buf, "0") == 0));
+
+    CHECK((FMT_Fixed(buf, 1234, 2) == 5U) && (strcmp(buf, "12.34") == 0));
+    CHECK((FMT_Fixed(buf, -5, 2) == 5U) && (strcmp(buf, "-0.05") == 0));
+    CHECK((FMT_Fixed(buf, 0, 3) == 5U) && (strcmp(buf, "0.000") == 0));
+    CHECK((FMT_Fixed(buf, 42, 0) == 2U) && (strcmp(buf, "42") == 0));
+    CHECK((FMT_Fixed(buf, INT32_MIN, 9) == 12U) && (strcmp(buf, "-2.147483648") == 0));
+
+    CHECK((FMT_Hex(buf, 0x0C0, 3) == 3U) && (strcmp(buf, "0C0") == 0));
+    CHECK((FMT_Hex(buf, 0xABCD, 2) == 2U) && (strcmp(buf, "CD") == 0));
+    CHECK((FMT_Hex(buf, 0xABCD, 0) == 0U) && (buf[0] == '\0'));
+
+    p += FMT_Str(p, "(");
+    p += FMT_Int(p, 8);
+    p += FMT_Str(p, " x 256) + ");
+    p += FMT_Int(p, 152);
+    CHECK((strcmp(buf, "(8 x 256) + 152") == 0) && ((size_t)(p - buf) == strlen(buf)));
+}
+
+/* Host time per value, FORMAT against snprintf, for the RPM field's "%5d" */
+static void Timing(void)
+{
+    char            buf[FMT_BUFFER_SIZE];
+    volatile size_t sink = 0;
+    clock_t         t0;
+    double          fmt, libc;
+    uint32_t        i;
+    const uint32_t  n = 2000000U;
+
+    printf("timing\n");
+    t0 = clock();
+    for (i = 0; i < n; i++)
+        sink += FMT_IntW(buf, (int32_t)(i % 6001U), 5);
+    fmt = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    t0 = clock();
+    for (i = 0; i < n; i++)
+        sink += (size_t)snprintf(buf, sizeof(buf), "%5d", (int)(i % 6001U));
+    libc = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    printf("  %%5d: FMT_IntW %.1f ns, snprintf %.1f ns per value\n",
+           fmt * 1e9 / n, libc * 1e9 / n);
+    (void)sink;
+}
+
+int main(void)
+{
+    printf("Format host tests\n");
+    TestValues();
+    TestShapes();
+    Timing();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
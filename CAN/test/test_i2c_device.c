@@ -0,0 +1,249 @@
+/*
+ * File:   test_i2c_device.c
+ * Comments: Host tests for CAN/src/I2C_DEVICE.c against the register file slave
+ *           of i2c_stub.c: shadow cache hits, skipped writes, bursts, 16-bit
+ *           register addresses, NAK handling and a hung transfer, counted in bus
+ *           transactions.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "I2C_DEVICE.h"
+#include "ssd1306_model.h"
+#include "i2c_stub.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+/* MCP23008-like IO expander: IODIR..OLAT, configuration registers 0x00~0x05 cached */
+#define EXP_ADDRESS     0x20
+#define EXP_IODIR       0x00
+#define EXP_IOCON       0x05
+#define EXP_GPIO        0x09
+
+static void TestCache(void)
+{
+    uint8_t         regs[11];
+    uint8_t         shadow[6];
+    I2C_DEVICE      exp = I2C_DEVICE_INIT(EXP_ADDRESS, I2C_DEV_REG8, EXP_IODIR, shadow);
+    uint8_t         v = 0;
+
+    printf("shadow cache\n");
+    memset(regs, 0, sizeof(regs));
+    regs[EXP_IODIR] = 0xFF;
+    I2C_Stub_RegDevice(EXP_ADDRESS, regs, sizeof(regs), 1);
+
+    CHECK(I2C_DevReadReg(&exp, EXP_IODIR, &v) && (v == 0xFF));
+    CHECK(I2C_Stub_RegTransactions == 1U);
+    CHECK(I2C_DevReadReg(&exp, EXP_IODIR, &v) && (v == 0xFF));
+    CHECK(I2C_Stub_RegTransactions == 1U);                  // served from the shadow
+
+    /* RMW of a cached register: no read, one write; the same RMW again: nothing */
+    CHECK(I2C_DevUpdateReg(&exp, EXP_IODIR, 0x0F, 0x00));
+    CHECK(regs[EXP_IODIR] == 0xF0);
+    CHECK(I2C_Stub_RegTransactions == 2U);
+    CHECK(I2C_DevUpdateReg(&exp, EXP_IODIR, 0x0F, 0x00));
+    CHECK(I2C_Stub_RegTransactions == 2U);
+
+    /* First RMW of a cached register not read yet: one read, one write */
+    CHECK(I2C_DevUpdateReg(&exp, EXP_IOCON, 0x20, 0x20));
+    CHECK(regs[EXP_IOCON] == 0x20);
+    CHECK(I2C_Stub_RegTransactions == 4U);
+
+    /* Data registers are not shadowed: every read goes to the bus */
+    regs[EXP_GPIO] = 0x5A;
+    CHECK(I2C_DevReadReg(&exp, EXP_GPIO, &v) && (v == 0x5A));
+    regs[EXP_GPIO] = 0xA5;
+    CHECK(I2C_DevReadReg(&exp, EXP_GPIO, &v) && (v == 0xA5));
+    CHECK(I2C_Stub_RegTransactions == 6U);
+
+    /* A burst over the whole device fills the rest of the shadow */
+    {
+        uint8_t all[11];
+
+        regs[0x01] = 0x11;
+        CHECK(I2C_DevReadBurst(&exp, 0x00, all, sizeof(all)));
+        CHECK(memcmp(all, regs, sizeof(regs)) == 0);
+        CHECK(exp.cacheValid == 0x3FU);
+        CHECK(I2C_DevReadReg(&exp, 0x01, &v) && (v == 0x11));
+        CHECK(I2C_Stub_RegTransactions == 7U);
+    }
+
+    I2C_DevInvalidate(&exp);
+    CHECK(I2C_DevReadReg(&exp, EXP_IODIR, &v) && (v == 0xF0));
+    CHECK(I2C_Stub_RegTransactions == 8U);
+    CHECK(exp.transfers == 8U);
+    CHECK(exp.errors == 0U);
+    printf("  %u transactions, %u saved by the shadow\n",
+           (unsigned)exp.transfers, (unsigned)exp.cacheHits);
+}
+
+static void TestEeprom(void)
+{
+    static uint8_t  mem[4096];
+    I2C_DEVICE      eeprom = I2C_DEVICE_INIT_NOCACHE(0x50, I2C_DEV_REG16);
+    const uint8_t   page[] = "CAN LOG";
+    uint8_t         back[sizeof(page)];
+
+    printf("EEPROM, 16-bit register address\n");
+    memset(mem, 0xFF, sizeof(mem));
+    I2C_Stub_RegDevice(0x50, mem, sizeof(mem), 2);
+    CHECK(I2C_DevWriteBurst(&eeprom, 0x0123, page, sizeof(page)));
+    CHECK(memcmp(&mem[0x0123], page, sizeof(page)) == 0);
+    CHECK(mem[0x0122] == 0xFF);
+    CHECK(I2C_DevReadBurst(&eeprom, 0x0123, back, sizeof(back)));
+    CHECK(memcmp(back, page, sizeof(page)) == 0);
+    CHECK(I2C_Stub_RegTransactions == 2U);
+    CHECK(I2C_DevProbe(&eeprom));
+}
+
+static void TestNak(void)
+{
+    uint8_t         regs[11];
+    uint8_t         shadow[6];
+    I2C_DEVICE      exp = I2C_DEVICE_INIT(EXP_ADDRESS, I2C_DEV_REG8, EXP_IODIR, shadow);
+    I2C_DEVICE      absent = I2C_DEVICE_INIT_NOCACHE(0x27, I2C_DEV_REG8);
+    uint32_t        oled;
+    uint8_t         v;
+
+    printf("NAK\n");
+    memset(regs, 0, sizeof(regs));
+    I2C_Stub_RegDevice(EXP_ADDRESS, regs, sizeof(regs), 1);
+    CHECK(I2C_DevWriteReg(&exp, EXP_IODIR, 0x3C));
+    I2C_Stub_NakAfter(1);
+    CHECK(!I2C_DevWriteReg(&exp, EXP_IODIR, 0x0F));
+    CHECK(exp.errors == 1U);
+    CHECK((exp.cacheValid & 1U) == 0U);                     // unknown now: read it again
+    CHECK(I2C_DevReadReg(&exp, EXP_IODIR, &v) && (v == 0x3C));
+
+    /* Nobody at 0x27: NAKed, nothing reaches the SSD1306 model */
+    oled = ssd1306.transactions;
+    CHECK(!I2C_DevWriteReg(&absent, 0x00, 0x00));
+    CHECK(!I2C_DevProbe(&absent));
+    CHECK(absent.errors == 2U);
+    CHECK(ssd1306.transactions == oled);
+}
+
+/* A transfer that never completes: the call gives up only after taking it off the
+   queue, so nothing is left pointing at the caller's buffers. Other users' queued
+   transactions stay, and end through their own callback when cancelled. */
+static int              otherDone;
+static SERCOM_I2C_ERROR otherError;
+
+static void OtherEventHandler(uintptr_t context)
+{
+    otherError = SERCOM2_I2C_ErrorGet();
+    otherDone++;
+}
+
+static void TestHang(void)
+{
+    uint8_t                 regs[11];
+    I2C_DEVICE              exp = I2C_DEVICE_INIT_NOCACHE(EXP_ADDRESS, I2C_DEV_REG8);
+    uint8_t                 rd[4];
+    SERCOM_I2C_TRANSACTION  other;
+
+    printf("hung transfer\n");
+    I2C_Stub_RegDevice(EXP_ADDRESS, regs, sizeof(regs), 1);
+    I2C_Stub_Hold(true);
+    memset(&other, 0, sizeof(other));
+    other.address = 0x50;
+    other.callback = OtherEventHandler;
+    other.context = 7;
+    CHECK(SERCOM2_I2C_TransferSubmit(&other));
+    CHECK(!I2C_DevReadBurst(&exp, 0x00, rd, sizeof(rd)));
+    CHECK(I2C_Stub_Cancels == 1U);
+    CHECK(exp.errors == 1U);
+    CHECK(I2C_Stub_Pending == 1U);                          // only ours was taken off
+    CHECK(otherDone == 0);
+    CHECK(SERCOM2_I2C_TransferCancel(OtherEventHandler, 7) == 1U);
+    CHECK((otherDone == 1) && (otherError == SERCOM_I2C_ERROR_BUS));
+    CHECK(I2C_Stub_Pending == 0U);
+    I2C_Stub_Hold(false);
+    CHECK(I2C_DevReadBurst(&exp, 0x00, rd, sizeof(rd)));
+}
+
+static uint8_t  eventAddress[8];
+static bool     eventPresent[8];
+static int      events;
+
+static void PresenceChanged(uint8_t address, bool present)
+{
+    if (events < 8)
+    {
+        eventAddress[events] = address;
+        eventPresent[events] = present;
+    }
+    events++;
+}
+
+/* One full sweep of 0x08~0x77 in main loop ticks */
+static void Sweep(void)
+{
+    uint32_t    sweeps = I2C_ScanSweeps();
+    int         ticks = 0;
+
+    while ((I2C_ScanSweeps() == sweeps) && (ticks < 100))
+    {
+        I2C_ScanTask();
+        ticks++;
+    }
+    CHECK(ticks == (I2C_SCAN_LAST - I2C_SCAN_FIRST + I2C_SCAN_PROBES_PER_TICK) / I2C_SCAN_PROBES_PER_TICK);
+}
+
+static void TestScan(void)
+{
+    uint8_t     regs[11];
+
+    printf("bus scan, hot-plug\n");
+    I2C_Stub_RegDevice(EXP_ADDRESS, regs, sizeof(regs), 1);
+    I2C_Stub_PanelConnect(true);
+    events = 0;
+    I2C_ScanStart(PresenceChanged);
+    Sweep();
+    CHECK(events == 3);
+    CHECK((eventAddress[0] == EXP_ADDRESS) && eventPresent[0]);
+    CHECK((eventAddress[1] == SSD1306_ADDRESS) && eventPresent[1]);
+    CHECK((eventAddress[2] == 0x50) && !eventPresent[2]);  // the EEPROM probed earlier is gone
+    CHECK(I2C_IsPresent(SSD1306_ADDRESS) && I2C_IsPresent(EXP_ADDRESS) && !I2C_IsPresent(0x50));
+
+    Sweep();
+    CHECK(events == 3);                                     // nothing changed
+
+    I2C_Stub_PanelConnect(false);
+    Sweep();
+    CHECK(events == 4);
+    CHECK((eventAddress[3] == SSD1306_ADDRESS) && !eventPresent[3]);
+    CHECK(!I2C_IsPresent(SSD1306_ADDRESS));
+
+    I2C_Stub_PanelConnect(true);
+    Sweep();
+    CHECK(events == 5);
+    CHECK((eventAddress[4] == SSD1306_ADDRESS) && eventPresent[4]);
+
+    I2C_ScanStop();
+    I2C_ScanTask();
+    CHECK(events == 5);
+}
+
+int main(void)
+{
+    printf("I2C device layer host tests\n");
+    SSD1306_Reset();
+    TestCache();
+    TestEeprom();
+    TestNak();
+    TestHang();
+    TestScan();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+/*
+ * File:   test_oled.c
+ * Comments: Host tests for CAN/src/OLED128x64.c. The driver talks to the SSD1306
+ *           model through i2c_stub.c; screens are checked against golden PGM images
+ *           and the I2C traffic of typical dashboard updates is reported.
+ *
+ *           test_oled [golden dir] [--update]
+ *           --update rewrites the golden images instead of comparing.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "OLED128x64.h"
+#include "ssd1306_model.h"
+#include "i2c_stub.h"
+
+static const char*  goldenDir = "golden";
+static bool         updateGolden;
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+static void CheckGolden(const char* name)
+{
+    char    path[256];
+    int     diff;
+
+    snprintf(path, sizeof(path), "%s/%s.pgm", goldenDir, name);
+    if (updateGolden)
+    {
+        CHECK(SSD1306_WritePGM(path));
+        printf("  wrote %s\n", path);
+        return;
+    }
+    diff = SSD1306_ComparePGM(path);
+    if (diff != 0)
+    {
+        snprintf(path, sizeof(path), "%s.actual.pgm", name);
+        SSD1306_WritePGM(path);
+        printf("  FAIL %s: %d pixels differ from golden (actual in %s)\n", name, diff, path);
+        failures++;
+    }
+}
+
+/* Panel rows equal the frame buffer, i.e. everything drawn really reached GDDRAM */
+static bool PanelMatchesFrameBuffer(void)
+{
+    return memcmp(ssd1306.gddram, OLED_FrameBuffer, sizeof(ssd1306.gddram)) == 0;
+}
+
+static void Report(const char* what)
+{
+    printf("  %-28s %4u transactions %5u bytes\n", what,
+           (unsigned)ssd1306.transactions, (unsigned)ssd1306.bytes);
+}
+
+/* Same layout as oled_update_display() in main.c */
+static void DrawDashboard(uint16_t rpm, uint8_t speed, uint8_t thr, bool acc, bool brk)
+{
+    char    buf[24];
+
+    OLED_FillRect(0, 0, 16, 8, WHITE);
+    OLED_PutStr(16, 0, (const uint8_t*)"CAN BUS MONITOR", OLED_FONT_6X8 | OLED_TEXT_INVERSE);
+    OLED_FillRect(106, 0, 22, 8, WHITE);
+    OLED_Put6x8Str(0, 1, (const uint8_t*)"---------------------");
+
+    OLED_Put6x8Str(0, 2, (const uint8_t*)"RPM:");
+    snprintf(buf, sizeof(buf), "%5u", rpm);
+    OLED_PutStr(30, 2, (const uint8_t*)buf, OLED_FONT_SEG7);
+
+    OLED_Put6x8Str(0, 4, (const uint8_t*)"SPD:");
+    snprintf(buf, sizeof(buf), "%3u", speed);
+    OLED_Put6x8Str(24, 4, (const uint8_t*)buf);
+    OLED_Put6x8Str(48, 4, (const uint8_t*)"km/h");
+    OLED_Put6x8Str(78, 4, (const uint8_t*)"T:");
+    snprintf(buf, sizeof(buf), "%3u%%", thr);
+    OLED_Put6x8Str(90, 4, (const uint8_t*)buf);
+
+    OLED_Put6x8Str(0, 5, (const uint8_t*)"ACC:");
+    OLED_Put6x8Str(24, 5, acc ? (const uint8_t*)"[*]" : (const uint8_t*)"[ ]");
+    OLED_Put6x8Str(54, 5, (const uint8_t*)"BRK:");
+    OLED_Put6x8Str(78, 5, brk ? (const uint8_t*)"[*]" : (const uint8_t*)"[ ]");
+
+    OLED_Put6x8Str(0, 6, (const uint8_t*)"0C0:08 98");
+    OLED_Put6x8Str(54, 6, (const uint8_t*)"CRC:");
+    OLED_Put6x8Str(78, 6, (const uint8_t*)"1A2B");
+
+    OLED_FillRect(0, 56, 128, 8, BLACK);
+    OLED_DrawBar(0, 57, 128, 6, thr, 100);
+}
+
+static void TestInit(void)
+{
+    printf("init\n");
+    SSD1306_Reset();
+    OLED_Init();
+    CHECK(ssd1306.displayOn);
+    CHECK(ssd1306.mode == OLED_ADDRESSING_MODE);
+    CHECK(ssd1306.unknownCommands == 0U);
+    Report("init sequence");
+
+    SSD1306_CountersClear();
+    OLED_Flush();
+    CHECK(PanelMatchesFrameBuffer());
+    Report("first full clear");
+}
+
+static void TestSplash(void)
+{
+    printf("splash\n");
+    OLED_CLS();
+    OLED_Put8x16Str(8, 1, (const uint8_t*)"NCUExMICROCHIP");
+    OLED_Put8x16Str(8, 3, (const uint8_t*)"CAN Simulation");
+    OLED_Put6x8Str(22, 6, (const uint8_t*)"PIC32CM3204GV");
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("splash");
+    CHECK(PanelMatchesFrameBuffer());
+    CheckGolden("splash");
+}
+
+static void TestDashboard(void)
+{
+    OLED_STATS  stats;
+
+    printf("dashboard\n");
+    OLED_CLS();
+    DrawDashboard(2200, 80, 45, true, false);
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("dashboard, first frame");
+    CHECK(PanelMatchesFrameBuffer());
+    CheckGolden("dashboard");
+
+    DrawDashboard(2200, 80, 45, true, false);
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("dashboard, unchanged");
+    CHECK(ssd1306.transactions == 0U);
+
+    OLED_CLS();
+    DrawDashboard(2200, 80, 45, true, false);
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("dashboard, CLS + same frame");
+    CHECK(ssd1306.transactions == 0U);
+
+    DrawDashboard(2250, 80, 45, true, false);
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("dashboard, one RPM digit");
+    CHECK(ssd1306.dataBytes <= 16U);
+    CHECK(PanelMatchesFrameBuffer());
+
+    DrawDashboard(3125, 95, 70, false, true);
+    SSD1306_CountersClear();
+    OLED_StatsClear();
+    OLED_Flush();
+    Report("dashboard, typical change");
+    CHECK(PanelMatchesFrameBuffer());
+    OLED_StatsGet(&stats);
+    CHECK(stats.transactions == ssd1306.transactions);
+    CHECK(stats.bytes == ssd1306.bytes);
+    CHECK(stats.swaps == 1U);
+    CHECK((stats.naks == 0U) && (stats.timeouts == 0U));
+    CheckGolden("dashboard_update");
+}
+
+static void TestGraphics(void)
+{
+    static const uint8_t arrow[] = { 0x18, 0x18, 0x18, 0xFF, 0x7E, 0x3C, 0x18 };
+
+    printf("graphics\n");
+    OLED_CLS();
+    OLED_DrawRect(0, 0, 128, 64, WHITE);
+    OLED_DrawLine(2, 2, 125, 61, WHITE);
+    OLED_DrawLine(2, 61, 125, 2, WHITE);
+    OLED_DrawArc(64, 32, 24, 0xFF, WHITE);
+    OLED_DrawArc(64, 32, 16, 0x0F, WHITE);
+    OLED_FillRect(8, 20, 20, 13, INVERSE);
+    OLED_DrawBitmap(100, 29, 7, 8, arrow, WHITE);
+    OLED_PutStr(36, 3, (const uint8_t*)"6x16", OLED_FONT_6X16);
+    SSD1306_CountersClear();
+    OLED_Flush();
+    Report("graphics screen");
+    CHECK(PanelMatchesFrameBuffer());
+    CheckGolden("graphics");
+}
+
+static void TestLog(void)
+{
+    char    line[24];
+    uint8_t i;
+
+    printf("scrolling log\n");
+    OLED_CLS();
+    OLED_PutStr(0, 0, (const uint8_t*)" CAN FRAME LOG       ", OLED_FONT_6X8 | OLED_TEXT_INVERSE);
+    OLED_Flush();
+    OLED_LogInit(2);
+    OLED_Flush();
+    for (i = 0; i < 9; i++)
+    {
+        snprintf(line, sizeof(line), "%02u 0C0 8 08 98 %02X", i, (unsigned)(i * 17U));
+        OLED_LogLine((const uint8_t*)line);
+        SSD1306_CountersClear();
+        OLED_Flush();
+    }
+    Report("one log line");
+    CHECK(ssd1306.dataBytes <= OLED_COLUMNS);
+    CHECK(ssd1306.startLine == 24U);     // pages 2~7 after 9 lines: oldest in page 5, on top
+    CHECK(ssd1306.badStartLines == 0U);
+    CheckGolden("log");
+    OLED_LogStop();
+    CHECK(ssd1306.startLine == 0U);
+}
+
+static void TestNakRecovery(void)
+{
+    OLED_STATS  stats;
+
+    printf("NAK recovery\n");
+    OLED_CLS();
+    DrawDashboard(1234, 56, 78, false, false);
+    OLED_StatsClear();
+    I2C_Stub_NakAfter(2);
+    CHECK(OLED_SwapBuffers());
+    CHECK(!PanelMatchesFrameBuffer());
+    OLED_StatsGet(&stats);
+    CHECK(stats.naks == 1U);
+    CHECK(stats.transactions == 2U);
+    I2C_Stub_NakAfter(0);
+    OLED_Flush();
+    CHECK(PanelMatchesFrameBuffer());
+    CHECK(!OLED_IsDirty());
+}
+
+/* Refresh that never completes: the wait takes it off the queue instead of leaving
+   it there with the refresh engine reset, and the frame goes out once the bus is back */
+static void TestHang(void)
+{
+    OLED_STATS  stats;
+    uint32_t    cancels = I2C_Stub_Cancels;
+
+    printf("hung refresh\n");
+    OLED_CLS();
+    DrawDashboard(4321, 65, 12, true, false);
+    OLED_StatsClear();
+    I2C_Stub_Hold(true);
+    CHECK(OLED_SwapBuffers());
+    CHECK(OLED_IsBusy() && (I2C_Stub_Pending == 1U));
+    OLED_Flush();                                           // gives up twice
+    CHECK(!OLED_IsBusy());
+    CHECK(I2C_Stub_Pending == 0U);
+    CHECK(I2C_Stub_Cancels == cancels + 2U);
+    OLED_StatsGet(&stats);
+    CHECK(stats.timeouts == 2U);
+    I2C_Stub_Hold(false);
+    OLED_Flush();
+    CHECK(PanelMatchesFrameBuffer());
+    CHECK(!OLED_IsDirty());
+}
+
+int main(int argc, char* argv[])
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--update") == 0)
+            updateGolden = true;
+        else
+            goldenDir = argv[i];
+    }
+
+    printf("OLED host tests, addressing mode 0x%02X\n", OLED_ADDRESSING_MODE);
+    TestInit();
+    TestSplash();
+    TestDashboard();
+    TestGraphics();
+    TestLog();
+    TestNakRecovery();
+    TestHang();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
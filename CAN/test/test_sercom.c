@@ -0,0 +1,756 @@
+/*
+ * File:   test_sercom.c
+ * Comments: Host tests for the SERCOM plibs (I2C master on SERCOM2, SPI master on
+ *           SERCOM1, USART on SERCOM0) running unchanged on the register model of
+ *           sercom_model.c: transfers, queueing, injected bus errors, recovery,
+ *           receive errors, the baud generator and the interrupt handler
+ *           cycle counts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "sercom_model.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+#define EXP_ADDRESS     0x20            // register file slave, 8-bit register address
+#define EEP_ADDRESS     0x50            // 16-bit register address
+#define NO_ADDRESS      0x33
+
+#define MS(n)           ((uint32_t)(n) * (CPU_CLOCK_FREQUENCY / 1000U))
+
+/* SERCOM2 I2C handler before it stopped waiting on SYNCBUSY/BUSSTATE and recovering
+   the bus, same sequences on this model: a clean write + write-read (average and
+   worst call), and the worst call of a lost arbitration with a transfer queued behind */
+#define I2C_ISR_BEFORE_AVG      104U
+#define I2C_ISR_BEFORE_MAX      238U
+#define I2C_ISR_BEFORE_ERR_MAX  10212U
+
+/* No handler call may come near a millisecond path: 64us at 8 MHz */
+#define I2C_ISR_BOUND           512U
+#define USART_CHAR_CYCLES   (CPU_CLOCK_FREQUENCY / 11520U)   // one 8N1 frame at 115200 baud
+
+static uint8_t      expRegs[32];
+static uint8_t      eepRegs[256];
+static uint32_t     callbacks;
+static SERCOM_I2C_ERROR callbackError[8];
+
+/* Polled like the main loop does: the service starts parked transfers and recovers */
+static bool I2CBusy(void)
+{
+    SERCOM2_I2C_Tasks();
+    return SERCOM2_I2C_IsBusy();
+}
+
+static bool I2CQueueBusy(void)
+{
+    SERCOM2_I2C_Tasks();
+    return SERCOM2_I2C_IsBusy() || (SERCOM2_I2C_QueueCountGet() != 0U);
+}
+
+static bool SPIBusy(void)
+{
+    return SERCOM1_SPI_IsBusy();
+}
+
+static void I2CDone(uintptr_t context)
+{
+    if (callbacks < 8U)
+        callbackError[callbacks] = SERCOM2_I2C_ErrorGet();
+    callbacks++;
+}
+
+/* Board bring-up as SYS_Initialize() does it, on a fresh model */
+static void Setup(void)
+{
+    SERCOM_Model_Init();
+    PORT_Initialize();
+    SYSTICK_TimerInitialize();
+    SERCOM0_USART_Initialize();
+    SERCOM1_SPI_Initialize();
+    SERCOM2_I2C_Initialize();
+    NVIC_Initialize();
+    SYSTICK_TimerStart();
+
+    memset(expRegs, 0, sizeof(expRegs));
+    memset(eepRegs, 0, sizeof(eepRegs));
+    SERCOM_Model_I2CSlave(EXP_ADDRESS, expRegs, sizeof(expRegs), 1);
+    SERCOM_Model_I2CSlave(EEP_ADDRESS, eepRegs, sizeof(eepRegs), 2);
+    SERCOM2_I2C_CallbackRegister(I2CDone, 0);
+    SERCOM2_I2C_StatisticsClear();
+    callbacks = 0;
+}
+
+static bool I2CWait(void)
+{
+    return SERCOM_Model_RunWhile(I2CBusy, MS(50));
+}
+
+// *****************************************************************************
+// Section: I2C
+// *****************************************************************************
+
+static void TestI2CTransfers(void)
+{
+    uint8_t wr[4] = { 0x04, 0x11, 0x22, 0x33 };
+    uint8_t ptr[2] = { 0x01, 0x80 };
+    uint8_t rd[3];
+
+    printf("i2c transfers\n");
+    Setup();
+
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NONE);
+    CHECK((expRegs[4] == 0x11) && (expRegs[5] == 0x22) && (expRegs[6] == 0x33));
+    CHECK(callbacks == 1U);
+
+    memset(rd, 0, sizeof(rd));
+    CHECK(SERCOM2_I2C_WriteRead(EXP_ADDRESS, wr, 1, rd, sizeof(rd)));
+    CHECK(I2CWait());
+    CHECK((rd[0] == 0x11) && (rd[1] == 0x22) && (rd[2] == 0x33));
+    CHECK(SERCOM_Model_I2CTransactions(EXP_ADDRESS) == 3U);   // write, write + Sr read
+
+    /* 16-bit register address */
+    eepRegs[0x80] = 0xA5;
+    eepRegs[0x81] = 0x5A;
+    CHECK(SERCOM2_I2C_WriteRead(EEP_ADDRESS, ptr, sizeof(ptr), rd, 2));
+    CHECK(I2CWait());
+    CHECK((rd[0] == 0xA5) && (rd[1] == 0x5A));
+
+    /* Plain read continues where the register pointer is */
+    CHECK(SERCOM2_I2C_Read(EEP_ADDRESS, rd, 1));
+    CHECK(I2CWait());
+    CHECK(rd[0] == eepRegs[0x82]);
+    CHECK(callbacks == 4U);
+}
+
+static void TestI2CQueue(void)
+{
+    static uint8_t reg[3] = { 0x00, 0x08, 0x10 };
+    static uint8_t val[2] = { 0x0A, 0x77 };
+    static uint8_t rd[2];
+    SERCOM_I2C_TRANSACTION t;
+    SERCOM_I2C_STATISTICS stats;
+    uint32_t transactions;
+
+    printf("i2c queue\n");
+    Setup();
+    expRegs[0x10] = 0x42;
+
+    memset(&t, 0, sizeof(t));
+    t.address = EXP_ADDRESS;
+    t.callback = I2CDone;
+    t.writeBuffer = val;
+    t.writeSize = sizeof(val);
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    t.writeBuffer = &reg[2];
+    t.writeSize = 1;
+    t.readBuffer = rd;
+    t.readSize = 1;
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    t.address = NO_ADDRESS;
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    t.address = EXP_ADDRESS;
+    t.writeBuffer = &reg[1];
+    t.readBuffer = &rd[1];
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+
+    CHECK(SERCOM_Model_RunWhile(I2CQueueBusy, MS(50)));
+    CHECK(callbacks == 4U);
+    CHECK(expRegs[0x0A] == 0x77);
+    CHECK(rd[0] == 0x42);
+    CHECK(rd[1] == 0x00);
+    CHECK(callbackError[0] == SERCOM_I2C_ERROR_NONE);
+    CHECK(callbackError[2] == SERCOM_I2C_ERROR_NAK);
+    CHECK(callbackError[3] == SERCOM_I2C_ERROR_NONE);
+
+    /* Empty transaction: the address alone (a probe), ACKed or NAKed, no data byte */
+    transactions = SERCOM_Model_I2CTransactions(EXP_ADDRESS);
+    SERCOM2_I2C_StatisticsClear();
+    memset(&t, 0, sizeof(t));
+    t.address = EXP_ADDRESS;
+    t.callback = I2CDone;
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    t.address = NO_ADDRESS;
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    CHECK(SERCOM_Model_RunWhile(I2CQueueBusy, MS(50)));
+    CHECK(callbacks == 6U);
+    CHECK(callbackError[4] == SERCOM_I2C_ERROR_NONE);
+    CHECK(callbackError[5] == SERCOM_I2C_ERROR_NAK);
+    CHECK(SERCOM_Model_I2CTransactions(EXP_ADDRESS) == transactions + 1U);
+    SERCOM2_I2C_StatisticsGet(&stats);
+    CHECK(stats.bytes == 2U);
+}
+
+/* Cancel takes one user's transactions off the queue, the one on the bus included,
+   and ends each with a bus error; the other user's transfer still runs */
+static void TestI2CCancel(void)
+{
+    static uint8_t val[2] = { 0x0B, 0x5C };
+    static uint8_t mine[2] = { 0x0C, 0x99 };
+    SERCOM_I2C_TRANSACTION t;
+
+    printf("i2c cancel\n");
+    Setup();
+
+    memset(&t, 0, sizeof(t));
+    t.address = EXP_ADDRESS;
+    t.callback = I2CDone;
+    t.context = 1;
+    t.writeBuffer = mine;
+    t.writeSize = sizeof(mine);
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));                  // on the bus right away
+    t.context = 2;
+    t.writeBuffer = val;
+    t.writeSize = sizeof(val);
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    t.context = 1;
+    t.writeBuffer = mine;
+    t.writeSize = sizeof(mine);
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+
+    CHECK(SERCOM2_I2C_TransferCancel(I2CDone, 1) == 2U);
+    CHECK(callbacks == 2U);
+    CHECK((callbackError[0] == SERCOM_I2C_ERROR_BUS) && (callbackError[1] == SERCOM_I2C_ERROR_BUS));
+    CHECK(SERCOM2_I2C_QueueCountGet() == 1U);
+
+    CHECK(SERCOM_Model_RunWhile(I2CQueueBusy, MS(50)));
+    CHECK(callbacks == 3U);
+    CHECK(callbackError[2] == SERCOM_I2C_ERROR_NONE);
+    CHECK(expRegs[0x0B] == 0x5C);
+    CHECK(expRegs[0x0C] == 0x00);
+    CHECK(SERCOM2_I2C_TransferCancel(I2CDone, 1) == 0U);
+}
+
+static void TestI2CSpeed(void)
+{
+    SERCOM_I2C_TRANSFER_SETUP setup = { .clkSpeed = SERCOM_I2C_SPEED_FAST };
+    uint8_t wr[9] = { 0 };
+    uint64_t start;
+    uint64_t standard;
+    uint64_t fast;
+
+    printf("i2c bus speed\n");
+    Setup();
+
+    start = SERCOM_Model_Cycles();
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    standard = SERCOM_Model_Cycles() - start;
+
+    CHECK(SERCOM2_I2C_TransferSetup(&setup, 0));
+    start = SERCOM_Model_Cycles();
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    fast = SERCOM_Model_Cycles() - start;
+
+    /* 10 bytes = 91 SCL periods: 910 us at 100 kHz, 228 us at 400 kHz, ISRs included */
+    printf("  10 bytes: %llu cycles at 100 kHz, %llu at 400 kHz\n",
+           (unsigned long long)standard, (unsigned long long)fast);
+    CHECK((standard > MS(1) * 9U / 10U) && (standard < MS(1) * 12U / 10U));
+    CHECK(fast * 3U < standard);
+}
+
+static void TestI2CErrors(void)
+{
+    SERCOM_I2C_STATISTICS stats;
+    uint8_t wr[3] = { 0x00, 0x01, 0x02 };
+
+    printf("i2c injected errors\n");
+    Setup();
+
+    CHECK(SERCOM2_I2C_Write(NO_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NAK);
+
+    SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_NAK, 3);           // second data byte
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NAK);
+    CHECK(expRegs[0] == 0x00);
+
+    SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_ARBLOST, 2);
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_BUS);
+
+    /* The other master still has the bus: the next transfer waits or recovers */
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NONE);
+    CHECK(expRegs[0] == 0x01);
+
+    SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_BUSERR, 1);
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_BUS);
+
+    SERCOM2_I2C_StatisticsGet(&stats);
+    CHECK(stats.naks == 2U);
+    CHECK(stats.busErrors == 2U);
+    CHECK(stats.transfers == 5U);
+}
+
+static void TestI2CRecovery(void)
+{
+    SERCOM_I2C_STATISTICS stats;
+    uint8_t wr[3] = { 0x02, 0x5A, 0xA5 };
+
+    printf("i2c hang recovery\n");
+    Setup();
+
+    /* SCL held low mid-byte: no interrupt ever comes, the watchdog ends the transfer */
+    SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_SCL_STUCK, 2);
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_BUS);
+    CHECK(callbacks == 1U);
+    SERCOM2_I2C_StatisticsGet(&stats);
+    CHECK(stats.timeouts == 1U);
+    CHECK(stats.recoveries == 1U);
+
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NONE);
+    CHECK((expRegs[2] == 0x5A) && (expRegs[3] == 0xA5));
+
+    /* A slave holding SDA is clocked free before the next START */
+    SERCOM_Model_I2CHoldSda(5);
+    CHECK(!PORT_PinRead(PORT_PIN_PA12));
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, wr, sizeof(wr)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_ErrorGet() == SERCOM_I2C_ERROR_NONE);
+    CHECK(PORT_PinRead(PORT_PIN_PA12));
+    SERCOM2_I2C_StatisticsGet(&stats);
+    CHECK(stats.recoveries == 2U);
+}
+
+// *****************************************************************************
+// Section: SPI
+// *****************************************************************************
+
+static uint16_t SpiInvert(uint16_t mosi)
+{
+    return (uint16_t)(~mosi & 0xFFU);
+}
+
+static void TestSPI(void)
+{
+    uint8_t tx[6] = { 0x9F, 0x01, 0x02, 0x03, 0x04, 0x05 };
+    uint8_t rx[6];
+    uint8_t mosi[8];
+
+    printf("spi\n");
+    Setup();
+
+    memset(rx, 0, sizeof(rx));
+    CHECK(SERCOM1_SPI_WriteRead(tx, sizeof(tx), rx, sizeof(rx)));
+    CHECK(SERCOM_Model_RunWhile(SPIBusy, MS(10)));
+    CHECK(memcmp(rx, tx, sizeof(tx)) == 0);                   // loopback
+    CHECK(SERCOM_Model_SPIMosi(mosi, sizeof(mosi)) == sizeof(tx));
+
+    SERCOM_Model_SPISlave(SpiInvert);
+    CHECK(SERCOM1_SPI_WriteRead(tx, 2, rx, 4));               // dummy bytes after tx
+    CHECK(SERCOM_Model_RunWhile(SPIBusy, MS(10)));
+    CHECK((rx[0] == 0x60) && (rx[1] == 0xFE) && (rx[2] == 0x00) && (rx[3] == 0x00));
+    CHECK(SERCOM_Model_SPIMosi(mosi, sizeof(mosi)) == 4U);
+    CHECK((mosi[2] == 0xFF) && (mosi[3] == 0xFF));
+
+    /* Nobody reads DATA: the third character overflows the two-deep FIFO */
+    NVIC_DisableIRQ(SERCOM1_IRQn);
+    SERCOM1_REGS->SPIM.SERCOM_DATA = 1;
+    SERCOM1_REGS->SPIM.SERCOM_DATA = 2;
+    SERCOM_Model_Run(1000);
+    SERCOM1_REGS->SPIM.SERCOM_DATA = 3;
+    SERCOM_Model_Run(1000);
+    CHECK((SERCOM1_REGS->SPIM.SERCOM_STATUS & SERCOM_SPIM_STATUS_BUFOVF_Msk) != 0U);
+    CHECK((uint8_t)SERCOM1_REGS->SPIM.SERCOM_DATA == 0xFE);
+    CHECK((uint8_t)SERCOM1_REGS->SPIM.SERCOM_DATA == 0xFD);
+    CHECK((SERCOM1_REGS->SPIM.SERCOM_INTFLAG & SERCOM_SPIM_INTFLAG_RXC_Msk) == 0U);
+    SERCOM1_REGS->SPIM.SERCOM_STATUS = SERCOM_SPIM_STATUS_BUFOVF_Msk;
+    CHECK((SERCOM1_REGS->SPIM.SERCOM_STATUS & SERCOM_SPIM_STATUS_BUFOVF_Msk) == 0U);
+}
+
+// *****************************************************************************
+// Section: USART
+// *****************************************************************************
+
+static bool USARTSending(void)
+{
+    return !SERCOM0_USART_TransmitComplete();
+}
+
+static void TestUSART(void)
+{
+    USART_SERIAL_SETUP setup = { 115200, USART_PARITY_EVEN, USART_DATA_8_BIT, USART_STOP_0_BIT };
+    SERCOM_USART_RING_BUFFER_STATISTICS stats;
+    const uint8_t hello[] = "hello";
+    uint8_t buf[8];
+    uint64_t start;
+
+    printf("usart\n");
+    Setup();
+    SERCOM0_USART_StatisticsClear();
+
+    /* Write() only fills the ring and is back well within one character time */
+    start = SERCOM_Model_Cycles();
+    CHECK(SERCOM0_USART_Write(hello, 5) == 5U);
+    CHECK(SERCOM_Model_Cycles() - start < USART_CHAR_CYCLES);
+    CHECK(!SERCOM0_USART_TransmitComplete());
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(2)));
+    CHECK(SERCOM_Model_USARTReceived(buf, sizeof(buf)) == 5U);
+    CHECK(memcmp(buf, hello, 5) == 0);
+    CHECK(SERCOM0_USART_WriteCountGet() == 0U);
+
+    /* Reception runs in the background, Read() takes what is there */
+    SERCOM_Model_USARTSend(hello, 3);
+    CHECK(SERCOM0_USART_Read(buf, sizeof(buf)) == 0U);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_ReadCountGet() == 3U);
+    memset(buf, 0, sizeof(buf));
+    CHECK(SERCOM0_USART_Read(buf, 2) == 2U);
+    CHECK(SERCOM0_USART_Read(&buf[2], sizeof(buf) - 2U) == 1U);
+    CHECK(memcmp(buf, hello, 3) == 0);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_NONE);
+
+    /* The interrupt keeps the two-deep FIFO empty: no overrun on a burst */
+    SERCOM_Model_USARTSend(hello, 5);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_NONE);
+    CHECK(SERCOM0_USART_Read(buf, sizeof(buf)) == 5U);
+
+    /* Overrun: four characters while the interrupt is held off, the first two survive */
+    NVIC_DisableIRQ(SERCOM0_IRQn);
+    SERCOM_Model_USARTSend(hello, 4);
+    SERCOM_Model_Run(MS(1));
+    NVIC_EnableIRQ(SERCOM0_IRQn);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_OVERRUN);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_NONE);
+    CHECK(SERCOM0_USART_Read(buf, sizeof(buf)) == 2U);
+
+    /* Parity error on the next character, which is discarded */
+    CHECK(SERCOM0_USART_SerialSetup(&setup, 0));
+    SERCOM_Model_USARTParityError();
+    SERCOM_Model_USARTSend(hello, 1);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_Read(buf, 1) == 0U);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_PARITY);
+
+    /* Peer 5 % slow: the stop bit is sampled in the last data bit */
+    SERCOM_Model_USARTPeerBaud(109400);
+    SERCOM_Model_USARTSend(hello, 1);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_Read(buf, 1) == 0U);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_FRAMING);
+
+    /* 2 % is within the tolerance */
+    SERCOM_Model_USARTPeerBaud(117500);
+    SERCOM_Model_USARTSend(hello, 2);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_Read(buf, 2) == 2U);
+    CHECK((buf[0] == 'h') && (buf[1] == 'e'));
+
+    SERCOM0_USART_StatisticsGet(&stats);
+    CHECK(stats.txBytes == 5U);
+    CHECK(stats.rxBytes == 12U);
+    CHECK(stats.rxErrors == 3U);
+    CHECK(stats.rxDropped == 0U);
+
+    /* The rings only hold 8-bit characters */
+    setup.dataWidth = USART_DATA_9_BIT;
+    CHECK(!SERCOM0_USART_SerialSetup(&setup, 0));
+}
+
+static uint32_t rxCalls, rxTaken;
+static uint8_t  rxData[64];
+static bool     rxDrain = true;
+
+static void RxCallback(SERCOM_USART_EVENT event, uintptr_t context)
+{
+    uint8_t c;
+
+    if ((event != SERCOM_USART_EVENT_READ_THRESHOLD_REACHED) || (context != 1U))
+        return;
+    rxCalls++;
+    while (rxDrain && (SERCOM0_USART_Read(&c, 1) != 0U))
+        rxData[rxTaken++ % sizeof(rxData)] = c;
+}
+
+static void TestUSARTRing(void)
+{
+    SERCOM_USART_RING_BUFFER_STATISTICS stats;
+    uint8_t out[300];
+    uint8_t in[320];
+    uint64_t start;
+    size_t n;
+
+    printf("usart ring buffers\n");
+    Setup();
+    SERCOM0_USART_StatisticsClear();
+    for (n = 0; n < sizeof(out); n++)
+        out[n] = (uint8_t)(n * 7U + 1U);
+    CHECK(SERCOM0_USART_WriteBufferSizeGet() == SERCOM0_USART_WRITE_BUFFER_SIZE - 1U);
+    CHECK(SERCOM0_USART_ReadBufferSizeGet() == SERCOM0_USART_READ_BUFFER_SIZE - 1U);
+
+    /* Non-blocking: the ring takes what fits, the rest is refused at once */
+    start = SERCOM_Model_Cycles();
+    n = SERCOM0_USART_Write(out, sizeof(out));
+    CHECK(SERCOM_Model_Cycles() - start < USART_CHAR_CYCLES);
+    CHECK((n >= SERCOM0_USART_WriteBufferSizeGet()) && (n < sizeof(out)));
+    CHECK(SERCOM0_USART_WriteFreeBufferCountGet() <= 2U);
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(40)));
+    CHECK(SERCOM_Model_USARTReceived(in, sizeof(in)) == n);
+    CHECK(memcmp(in, out, n) == 0);
+    SERCOM0_USART_StatisticsGet(&stats);
+    CHECK(stats.txBytes == n);
+    CHECK(stats.txDropped == sizeof(out) - n);
+    CHECK(stats.txBlocked == 0U);
+    CHECK(stats.txHighWater == SERCOM0_USART_WriteBufferSizeGet());
+
+    /* Blocking: waits for room, nothing is lost */
+    SERCOM0_USART_StatisticsClear();
+    SERCOM0_USART_WriteBlockingSet(true);
+    CHECK(SERCOM0_USART_Write(out, sizeof(out)) == sizeof(out));
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(40)));
+    CHECK(SERCOM_Model_USARTReceived(in, sizeof(in)) == sizeof(out));
+    CHECK(memcmp(in, out, sizeof(out)) == 0);
+
+    /* Interrupts masked: the writer feeds the transmitter itself */
+    __disable_irq();
+    CHECK(SERCOM0_USART_Write(out, sizeof(out)) == sizeof(out));
+    __enable_irq();
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(40)));
+    CHECK(SERCOM_Model_USARTReceived(in, sizeof(in)) == sizeof(out));
+    CHECK(memcmp(in, out, sizeof(out)) == 0);
+    SERCOM0_USART_WriteBlockingSet(false);
+
+    SERCOM0_USART_StatisticsGet(&stats);
+    CHECK(stats.txBytes == 2U * sizeof(out));
+    CHECK(stats.txDropped == 0U);
+    CHECK(stats.txBlocked == 2U);
+
+    /* Read ring: what does not fit is dropped and counted */
+    SERCOM_Model_USARTSend(out, 40);
+    SERCOM_Model_Run(MS(5));
+    CHECK(SERCOM0_USART_ReadCountGet() == SERCOM0_USART_ReadBufferSizeGet());
+    CHECK(SERCOM0_USART_ReadFreeBufferCountGet() == 0U);
+    n = SERCOM0_USART_Read(in, sizeof(in));
+    CHECK(n == SERCOM0_USART_ReadBufferSizeGet());
+    CHECK(memcmp(in, out, n) == 0);
+    SERCOM0_USART_StatisticsGet(&stats);
+    CHECK(stats.rxBytes == n);
+    CHECK(stats.rxDropped == 40U - n);
+    CHECK(stats.rxHighWater == n);
+    CHECK(stats.rxErrors == 0U);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_NONE);
+
+    /* Read callback: draining the ring in the interrupt, nothing is dropped */
+    SERCOM0_USART_StatisticsClear();
+    rxCalls = 0;
+    rxTaken = 0;
+    SERCOM0_USART_ReadCallbackRegister(RxCallback, 1);
+    CHECK(!SERCOM0_USART_ReadNotificationEnable(true, true));
+    SERCOM_Model_USARTSend(out, 40);
+    SERCOM_Model_Run(MS(5));
+    CHECK((rxCalls == 40U) && (rxTaken == 40U));
+    CHECK(memcmp(rxData, out, 40) == 0);
+    SERCOM0_USART_StatisticsGet(&stats);
+    CHECK((stats.rxBytes == 40U) && (stats.rxDropped == 0U) && (stats.rxHighWater == 1U));
+
+    /* Not persistent, threshold 4, callback leaves the data: called once */
+    rxCalls = 0;
+    rxTaken = 0;
+    rxDrain = false;
+    SERCOM0_USART_ReadThresholdSet(4);
+    CHECK(SERCOM0_USART_ReadNotificationEnable(true, false));
+    SERCOM_Model_USARTSend(out, 10);
+    SERCOM_Model_Run(MS(2));
+    CHECK((rxCalls == 1U) && (rxTaken == 0U));
+    CHECK(SERCOM0_USART_Read(in, sizeof(in)) == 10U);
+    (void)SERCOM0_USART_ReadNotificationEnable(false, false);
+    SERCOM0_USART_ReadCallbackRegister(NULL, 0);
+    rxDrain = true;
+}
+
+/* No BAUD value is closer to the rate than the one BaudCalculate() picks */
+static bool BaudNearest(uint32_t rate, uint32_t clk, const USART_BAUD_SETTING* s)
+{
+    double      best = (double)clk / 16.0 * (1.0 - s->baudValue / 65536.0) - rate;
+    uint32_t    b;
+
+    for (b = 0; b < 65536U; b++) {
+        double  error = (double)clk / 16.0 * (1.0 - b / 65536.0) - rate;
+
+        if ((error * error) < (best * best) * (1.0 - 1e-12))
+            return false;
+    }
+    return true;
+}
+
+static void TestUSARTBaud(void)
+{
+    static const uint32_t rates[] = { 300, 1200, 9600, 19200, 38400, 57600, 115200, 230400,
+                                      250000, 460800, 500000, 921600, 1000000, 1500000, 2000000 };
+    USART_SERIAL_SETUP setup = { 500000, USART_PARITY_NONE, USART_DATA_8_BIT, USART_STOP_1_BIT };
+    USART_BAUD_SETTING s;
+    const uint8_t hello[] = "hello";
+    uint8_t buf[8];
+    uint32_t i;
+
+    printf("usart baud generator\n");
+    Setup();
+
+    /* The 8 MHz OSC8M: the value Initialize() loads, 500 kbaud at most */
+    CHECK(SERCOM0_USART_BaudCalculate(115200, 0, &s));
+    CHECK((s.baudValue == 50437U) && (s.baudRate == 115196U) && (s.errorPpm == -32));
+    SERCOM0_USART_BaudSettingGet(&s);
+    CHECK((s.baudValue == 50437U) && (s.baudRate == 115196U) && (s.errorPpm == -32));
+    CHECK(SERCOM0_USART_BaudCalculate(500000, 0, &s) && (s.baudValue == 0U) && (s.errorPpm == 0));
+    CHECK(!SERCOM0_USART_BaudCalculate(1000000, 0, &s));
+    CHECK(!SERCOM0_USART_BaudCalculate(0, 0, &s));
+
+    /* The 48 MHz DFLL of lab3: 1 and 2 Mbaud within 20 ppm, 3 Mbaud exact */
+    CHECK(SERCOM0_USART_BaudCalculate(1000000, 48000000, &s));
+    CHECK((s.baudValue == 43691U) && (s.errorPpm >= -20) && (s.errorPpm <= 20));
+    CHECK(SERCOM0_USART_BaudCalculate(2000000, 48000000, &s));
+    CHECK((s.baudValue == 21845U) && (s.errorPpm >= -20) && (s.errorPpm <= 20));
+    CHECK(SERCOM0_USART_BaudCalculate(3000000, 48000000, &s) && (s.baudValue == 0U) && (s.errorPpm == 0));
+    CHECK(!SERCOM0_USART_BaudCalculate(3100000, 48000000, &s));
+
+    /* Always the lowest error the generator can give, at most half a step of f / 2^20 */
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        CHECK(SERCOM0_USART_BaudCalculate(rates[i], 48000000, &s));
+        CHECK(BaudNearest(rates[i], 48000000, &s));
+        CHECK(abs(s.errorPpm) <= (int32_t)(22888000U / rates[i]) + 1);
+        if (SERCOM0_USART_BaudCalculate(rates[i], 8000000, &s)) {
+            CHECK(BaudNearest(rates[i], 8000000, &s));
+            CHECK(abs(s.errorPpm) <= (int32_t)(3815000U / rates[i]) + 1);
+        }
+    }
+    for (i = 1000000; i <= 2000000U; i += 1000000) {
+        (void)SERCOM0_USART_BaudCalculate(i, 48000000, &s);
+        printf("  48 MHz, %u baud: BAUD %u, %d ppm\n", i, s.baudValue, s.errorPpm);
+    }
+
+    /* 500 kbaud on the model, both ways */
+    CHECK(SERCOM0_USART_SerialSetup(&setup, 0));
+    SERCOM0_USART_BaudSettingGet(&s);
+    CHECK((s.baudValue == 0U) && (s.baudRate == 500000U) && (s.errorPpm == 0));
+    CHECK(SERCOM0_USART_Write(hello, 5) == 5U);
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(1)));
+    CHECK(SERCOM_Model_USARTReceived(buf, sizeof(buf)) == 5U);
+    CHECK(memcmp(buf, hello, 5) == 0);
+    SERCOM_Model_USARTSend(hello, 5);
+    SERCOM_Model_Run(MS(1));
+    CHECK(SERCOM0_USART_Read(buf, sizeof(buf)) == 5U);
+    CHECK(memcmp(buf, hello, 5) == 0);
+    CHECK(SERCOM0_USART_ErrorGet() == USART_ERROR_NONE);
+
+    /* Too fast, or too coarse: 50 baud is a 7 % step. The USART keeps its rate. */
+    setup.baudRate = 1000000;
+    CHECK(!SERCOM0_USART_SerialSetup(&setup, 0));
+    setup.baudRate = 50;
+    CHECK(!SERCOM0_USART_SerialSetup(&setup, 0));
+    setup.baudRate = 300;
+    CHECK(SERCOM0_USART_BaudCalculate(300, 0, &s) && (s.errorPpm < -USART_BAUD_ERROR_MAX_PPM / 4));
+    CHECK(SERCOM0_USART_SerialSetup(&setup, 0));
+    SERCOM0_USART_BaudSettingGet(&s);
+    CHECK((s.baudRate == 298U) && (s.errorPpm == -8178));
+}
+
+// *****************************************************************************
+// Section: Interrupt handler cycles
+// *****************************************************************************
+
+static void Benchmark(void)
+{
+    SERCOM_I2C_STATISTICS stats;
+    SERCOM_MODEL_IRQ_STATS i2c;
+    SERCOM_MODEL_IRQ_STATS i2cErr;
+    SERCOM_MODEL_IRQ_STATS spi;
+    SERCOM_MODEL_IRQ_STATS usart;
+    SERCOM_I2C_TRANSACTION t;
+    uint8_t buf[16];
+
+    printf("interrupt handler cycles\n");
+    Setup();
+    memset(buf, 0, sizeof(buf));
+
+    SERCOM_Model_IrqStatsClear();
+    SERCOM2_I2C_StatisticsClear();
+    CHECK(SERCOM2_I2C_Write(EXP_ADDRESS, buf, sizeof(buf)));
+    CHECK(I2CWait());
+    CHECK(SERCOM2_I2C_WriteRead(EXP_ADDRESS, buf, 1, buf, sizeof(buf) - 1U));
+    CHECK(I2CWait());
+    SERCOM_Model_IrqStatsGet(SERCOM2_IRQn, &i2c);
+    SERCOM2_I2C_StatisticsGet(&stats);
+
+    /* The next transfer is started from the handler while the other master has the bus */
+    SERCOM_Model_IrqStatsClear();
+    memset(&t, 0, sizeof(t));
+    t.address = EXP_ADDRESS;
+    t.writeBuffer = buf;
+    t.writeSize = 3;
+    SERCOM_Model_I2CFault(SERCOM_MODEL_I2C_ARBLOST, 2);
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    CHECK(SERCOM2_I2C_TransferSubmit(&t));
+    CHECK(SERCOM_Model_RunWhile(I2CQueueBusy, MS(50)));
+    SERCOM_Model_IrqStatsGet(SERCOM2_IRQn, &i2cErr);
+
+    CHECK(SERCOM1_SPI_WriteRead(buf, sizeof(buf), buf, sizeof(buf)));
+    CHECK(SERCOM_Model_RunWhile(SPIBusy, MS(10)));
+    SERCOM_Model_IrqStatsGet(SERCOM1_IRQn, &spi);
+
+    CHECK(SERCOM0_USART_Write(buf, sizeof(buf)) == sizeof(buf));
+    CHECK(SERCOM_Model_RunWhile(USARTSending, MS(5)));
+    SERCOM_Model_IrqStatsGet(SERCOM0_IRQn, &usart);
+
+    /* The plib measures on SysTick inside the handler, the model adds entry and exit */
+    CHECK(stats.isrCalls == i2c.calls);
+    CHECK(stats.isrCycles < i2c.cycles);
+    CHECK((i2c.cycles - stats.isrCycles) / i2c.calls < 100U);
+    CHECK(i2c.cyclesMax < I2C_ISR_BOUND);
+    CHECK(i2cErr.cyclesMax < I2C_ISR_BOUND);
+    printf("  SERCOM2 I2C: %u calls, %llu cycles (%llu per call, max %u), plib measured %u\n",
+           i2c.calls, (unsigned long long)i2c.cycles, (unsigned long long)(i2c.cycles / i2c.calls),
+           i2c.cyclesMax, stats.isrCycles);
+    printf("    before: %u per call, max %u (the plib's own profile adds about 25 per call)\n",
+           I2C_ISR_BEFORE_AVG, I2C_ISR_BEFORE_MAX);
+    printf("    arbitration lost, transfer queued: max %u, before %u\n",
+           i2cErr.cyclesMax, I2C_ISR_BEFORE_ERR_MAX);
+    printf("  SERCOM1 SPI: %u calls, %llu cycles (%llu per call, max %u)\n",
+           spi.calls, (unsigned long long)spi.cycles, (unsigned long long)(spi.cycles / spi.calls),
+           spi.cyclesMax);
+    printf("  SERCOM0 USART: %u calls, %llu cycles (%llu per call, max %u)\n",
+           usart.calls, (unsigned long long)usart.cycles, (unsigned long long)(usart.cycles / usart.calls),
+           usart.cyclesMax);
+}
+
+int main(void)
+{
+    TestI2CTransfers();
+    TestI2CQueue();
+    TestI2CCancel();
+    TestI2CSpeed();
+    TestI2CErrors();
+    TestI2CRecovery();
+    TestSPI();
+    TestUSART();
+    TestUSARTRing();
+    TestUSARTBaud();
+    Benchmark();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+ * File:   test_slcan.c
+ * Comments: Host tests for CAN/src/SLCAN.c: the command sequences slcand and
+ *           python-can send, frames out with and without timestamps, frames
+ *           from the host, refused commands, and the hand-over between console
+ *           keys and the SLCAN interface.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SLCAN.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+/* The write ring */
+static char         out[256];
+static size_t       outLen, outRoom = sizeof(out);
+
+static size_t OutWrite(const void* buffer, size_t size)
+{
+    memcpy(&out[outLen], buffer, size);
+    outLen += size;
+    out[outLen] = '\0';
+    return size;
+}
+
+static size_t OutRoom(void)
+{
+    return outRoom;
+}
+
+/* Console keys handed back by SLCAN */
+static char         keys[16];
+static size_t       keyLen;
+
+static void Key(uint8_t c)
+{
+    if (keyLen < sizeof(keys) - 1U)
+        keys[keyLen++] = (char)c;
+    keys[keyLen] = '\0';
+}
+
+/* Feeds text as received bytes */
+static void Send(const char* text)
+{
+    outLen = 0;
+    out[0] = '\0';
+    for (; *text != '\0'; text++)
+        SLCAN_Input((uint8_t)*text);
+}
+
+static void TestHandOver(void)
+{
+    printf("console keys and hand-over\n");
+    SLCAN_Init(OutWrite, OutRoom, Key);
+
+    /* Console keys and the empty lines tools send to flush stay with the console */
+    keyLen = 0;
+    Send("sb\r\r\r");
+    CHECK(strcmp(keys, "sb\r\r\r") == 0);
+    CHECK(outLen == 0U);
+    CHECK(!SLCAN_IsActive());
+
+    /* Upper case (caps lock) is console keys too, only opening commands are held */
+    keyLen = 0;
+    Send("SCBRT\rQ\r");
+    CHECK(strcmp(keys, "SCBRT\rQ\r") == 0);
+    CHECK((outLen == 0U) && !SLCAN_IsActive());
+
+    /* A lone 's' may be the start of sxxyy: held until the line goes quiet */
+    keyLen = 0;
+    Send("s0");
+    CHECK(keyLen == 0U);
+    SLCAN_Idle();
+    CHECK(strcmp(keys, "s0") == 0);
+    keyLen = 0;
+    Send("S9\r");                                       // not a bit rate
+    CHECK((strcmp(keys, "S9\r") == 0) && (outLen == 0U));
+
+    /* slcand -o -c -s6: close (a console key yet), bit rate, open */
+    keyLen = 0;
+    Send("C\rS6\rO\r");
+    CHECK(strcmp(keys, "C\r") == 0);
+    CHECK(strcmp(out, "\r\r") == 0);
+    CHECK(SLCAN_IsActive() && SLCAN_IsOpen());
+
+    /* Active: every byte is SLCAN, held or not, ESC hands the console back */
+    keyLen = 0;
+    Send("s\rC\r");
+    CHECK((keyLen == 0U) && (strcmp(out, "\a\r") == 0));
+    SLCAN_Idle();
+    CHECK(keyLen == 0U);
+    Send("\033");
+    CHECK(!SLCAN_IsActive() && !SLCAN_IsOpen());
+    Send("r");
+    CHECK(strcmp(keys, "r") == 0);
+}
+
+static void TestCommands(void)
+{
+    SLCAN_STATS s;
+
+    printf("commands\n");
+    SLCAN_Init(OutWrite, OutRoom, Key);
+
+    /* python-can: version, serial number, then open */
+    Send("V\r");
+    CHECK(strcmp(out, "V1013\r") == 0);
+    Send("N\r");
+    CHECK(strcmp(out, "N0001\r") == 0);
+    Send("F\r");
+    CHECK(strcmp(out, "\a") == 0);                      // closed
+    Send("S9\r");
+    CHECK(strcmp(out, "\a") == 0);
+    Send("s031C\rM00000000\rmFFFFFFFF\rX1\rZ1\r");
+    CHECK(strcmp(out, "\r\r\r\r\r") == 0);
+    Send("O\r");
+    CHECK(strcmp(out, "\r") == 0);
+    Send("O\r");
+    CHECK(strcmp(out, "\a") == 0);                      // already open
+    Send("S6\r");
+    CHECK(strcmp(out, "\a") == 0);                      // only while closed
+    Send("F\r");
+    CHECK(strcmp(out, "F00\r") == 0);
+
+    /* Frames from the host, CRLF line ends accepted */
+    Send("t1232AABB\r\n");
+    CHECK(strcmp(out, "z\r") == 0);
+    Send("T1FFFFFFF80102030405060708\r");
+    CHECK(strcmp(out, "Z\r") == 0);
+    Send("r7FF0\rR000000012\r");
+    CHECK(strcmp(out, "z\rZ\r") == 0);
+    Send("t8002AABB\r");                                // 11-bit ID out of range
+    CHECK(strcmp(out, "\a") == 0);
+    Send("t1239AABB\r");                                // DLC 9
+    CHECK(strcmp(out, "\a") == 0);
+    Send("t1232AAB\r");                                 // short payload
+    CHECK(strcmp(out, "\a") == 0);
+    Send("t1232AAGG\r");
+    CHECK(strcmp(out, "\a") == 0);
+    Send("t12345678901234567890123456789012345\r");     // longer than any command
+    CHECK(strcmp(out, "\a") == 0);
+
+    /* Listen-only: nothing may be sent */
+    Send("C\rL\rt1231AA\r");
+    CHECK(strcmp(out, "\r\r\a") == 0);
+
+    SLCAN_StatsGet(&s);
+    CHECK(s.received == 4U);
+    CHECK(s.errors == 10U);
+    SLCAN_StatsClear();
+    SLCAN_StatsGet(&s);
+    CHECK((s.received == 0U) && (s.commands == 0U));
+}
+
+static void TestFrames(void)
+{
+    static const uint8_t rpm[2] = { 0x08, 0x98 };
+    static const uint8_t ext[8] = { 1, 2, 3, 4, 5, 6, 7, 0xFF };
+    SLCAN_STATS s;
+
+    printf("frames out\n");
+    SLCAN_Init(OutWrite, OutRoom, Key);
+
+    /* Closed: nothing goes out */
+    outLen = 0;
+    CHECK(!SLCAN_Frame(0x0C0, 2, rpm, 1234));
+    CHECK(outLen == 0U);
+
+    Send("O\r");
+    outLen = 0;
+    CHECK(SLCAN_Frame(0x0C0, 2, rpm, 1234));
+    CHECK(strcmp(out, "t0C020898\r") == 0);
+    outLen = 0;
+    CHECK(SLCAN_Frame(0x18FF1234, 8, ext, 0));
+    CHECK(strcmp(out, "T18FF1234801020304050607FF\r") == 0);
+    outLen = 0;
+    CHECK(SLCAN_Frame(0x0D0, 0, NULL, 0));
+    CHECK(strcmp(out, "t0D00\r") == 0);
+
+    /* Timestamps: milliseconds modulo 60000, four hex digits */
+    Send("C\rZ1\rO\r");
+    outLen = 0;
+    CHECK(SLCAN_Frame(0x0C0, 2, rpm, 61234));
+    CHECK(strcmp(out, "t0C02089804D2\r") == 0);
+
+    /* No room for the whole frame: dropped, never cut */
+    outLen = 0;
+    outRoom = 13;
+    CHECK(!SLCAN_Frame(0x0C0, 2, rpm, 0));
+    CHECK(outLen == 0U);
+    outRoom = sizeof(out);
+
+    SLCAN_StatsGet(&s);
+    CHECK((s.frames == 4U) && (s.dropped == 1U));
+
+    /* Line rate: the simulation's 2-byte frame with a timestamp is 14 bytes */
+    printf("  2-byte frame: 14 bytes, %u frames/s at 115200\n", 11520U / 14U);
+}
+
+int main(void)
+{
+    printf("SLCAN host tests\n");
+    TestHandOver();
+    TestCommands();
+    TestFrames();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*
+ * File:   test_telemetry.c
+ * Comments: Host tests for CAN/src/TELEMETRY.c: the CRC and COBS against known
+ *           vectors, record round trips, corrupted frames, and a stream with
+ *           text in front and a dropped record, split on 0x00 the way the
+ *           decoder does it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TELEMETRY.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+static bool CobsIs(const uint8_t* in, size_t len, const uint8_t* expect, size_t expectLen)
+{
+    uint8_t     out[16], back[16];
+    size_t      n = TELEM_CobsEncode(in, len, out);
+
+    return (n == expectLen) && (memcmp(out, expect, n) == 0)
+        && (TELEM_CobsDecode(out, n, back, sizeof(back)) == len)
+        && (memcmp(back, in, len) == 0);
+}
+
+static void TestCodecs(void)
+{
+    static const uint8_t z1[] = { 0x00 }, e1[] = { 0x01, 0x01 };
+    static const uint8_t z2[] = { 0x00, 0x00 }, e2[] = { 0x01, 0x01, 0x01 };
+    static const uint8_t m[] = { 0x11, 0x22, 0x00, 0x33 }, em[] = { 0x03, 0x11, 0x22, 0x02, 0x33 };
+    static const uint8_t t[] = { 0x11, 0x00, 0x00, 0x00 }, et[] = { 0x02, 0x11, 0x01, 0x01, 0x01 };
+    uint8_t     in[600], out[610], back[600];
+    size_t      len, n, i;
+
+    printf("CRC-16 and COBS\n");
+    CHECK(TELEM_Crc16((const uint8_t*)"123456789", 9) == 0x29B1U);
+    CHECK(TELEM_Crc16(NULL, 0) == 0xFFFFU);
+
+    CHECK(CobsIs(z1, sizeof(z1), e1, sizeof(e1)));
+    CHECK(CobsIs(z2, sizeof(z2), e2, sizeof(e2)));
+    CHECK(CobsIs(m, sizeof(m), em, sizeof(em)));
+    CHECK(CobsIs(t, sizeof(t), et, sizeof(et)));
+
+    /* Runs around the 254-byte block length, zeros at random places */
+    srand(22);
+    for (len = 250; len <= sizeof(in); len += (len < 260) ? 1U : 113U) {
+        for (i = 0; i < len; i++)
+            in[i] = (len < 260) ? (uint8_t)(1U + i % 255U) : (uint8_t)(rand() % 8);
+        n = TELEM_CobsEncode(in, len, out);
+        CHECK(n <= len + 1U + len / 254U);
+        CHECK(memchr(out, 0, n) == NULL);
+        CHECK(TELEM_CobsDecode(out, n, back, sizeof(back)) == len);
+        CHECK(memcmp(back, in, len) == 0);
+        CHECK(TELEM_CobsDecode(out, n, back, len - 1U) == 0U);      // too small
+    }
+
+    /* Malformed: a zero inside, a code running past the end */
+    CHECK(TELEM_CobsDecode((const uint8_t*)"\x03\x11\x00", 3, back, sizeof(back)) == 0U);
+    CHECK(TELEM_CobsDecode((const uint8_t*)"\x05\x11\x22", 3, back, sizeof(back)) == 0U);
+}
+
+static void Fill(TELEM_CAN_RECORD* r, uint8_t dlc)
+{
+    uint8_t i;
+
+    memset(r, 0, sizeof(*r));
+    r->time = 0x00012300U;
+    r->id = 0x0C0;
+    r->dlc = dlc;
+    for (i = 0; i < dlc; i++)
+        r->data[i] = (uint8_t)(i * 0x40U);          // zeros in the payload
+    r->crc15 = 0x1A00;
+    r->rpm = 2200;
+    r->speed = 80;
+    r->throttle = 0;
+    r->flags = TELEM_FLAG_MANUAL | TELEM_FLAG_SW1;
+}
+
+static void TestRecords(void)
+{
+    TELEM_CAN_RECORD r, d;
+    uint8_t     frame[TELEM_FRAME_MAX], bad[TELEM_FRAME_MAX];
+    size_t      len, i;
+    uint8_t     dlc, x;
+    int         accepted = 0;
+
+    printf("record round trip\n");
+    for (dlc = 0; dlc <= 8U; dlc++) {
+        Fill(&r, dlc);
+        r.seq = (uint8_t)(0xF8U + dlc);
+        len = TELEM_Encode(&r, frame);
+        CHECK(len == TELEM_RECORD_MIN + dlc + 2U);
+        CHECK(len <= TELEM_FRAME_MAX);
+        CHECK((frame[len - 1U] == 0U) && (memchr(frame, 0, len - 1U) == NULL));
+
+        memset(&d, 0xA5, sizeof(d));
+        CHECK(TELEM_Decode(frame, len - 1U, &d));
+        CHECK((d.seq == r.seq) && (d.time == r.time) && (d.id == r.id) && (d.dlc == dlc));
+        CHECK(memcmp(d.data, r.data, dlc) == 0);
+        CHECK((d.crc15 == r.crc15) && (d.rpm == r.rpm) && (d.speed == r.speed));
+        CHECK((d.throttle == r.throttle) && (d.flags == r.flags));
+    }
+
+    /* Every byte of a frame changed to every other non-zero value: the CRC or
+       the length check rejects it */
+    printf("corrupted frames\n");
+    Fill(&r, 2);
+    len = TELEM_Encode(&r, frame) - 1U;
+    for (i = 0; i < len; i++) {
+        for (x = 1; x != 0U; x++) {
+            memcpy(bad, frame, len);
+            bad[i] ^= x;
+            if ((bad[i] != 0U) && TELEM_Decode(bad, len, &d))
+                accepted++;
+        }
+    }
+    CHECK(accepted == 0);
+    CHECK(!TELEM_Decode(frame, len - 1U, &d));
+    CHECK(!TELEM_Decode((const uint8_t*)"hello\r\n", 7, &d));
+}
+
+/* The write ring */
+static uint8_t      ring[256];
+static size_t       ringLen, ringRoom;
+
+static size_t RingWrite(const void* buffer, size_t size)
+{
+    memcpy(&ring[ringLen], buffer, size);
+    ringLen += size;
+    ringRoom -= size;
+    return size;
+}
+
+static size_t RingRoom(void)
+{
+    return ringRoom;
+}
+
+static void TestStream(void)
+{
+    TELEM_CAN_RECORD r, d[4];
+    TELEM_STATS s;
+    size_t      i, start = 0;
+    int         good = 0, bad = 0;
+
+    printf("stream\n");
+    TELEM_Init(RingWrite, RingRoom);
+    ringLen = 0;
+    ringRoom = sizeof(ring);
+    (void)RingWrite("CAN FRAMES: 0x0C0", 17);       // console text before the switch
+
+    TELEM_Start();
+    Fill(&r, 2);
+    CHECK(TELEM_SendCan(&r, false));
+    ringRoom = TELEM_RECORD_MIN + 2U + 1U;           // one byte short
+    CHECK(!TELEM_SendCan(&r, false));
+    ringRoom = 100;
+    Fill(&r, 1);
+    CHECK(TELEM_SendCan(&r, false));
+
+    TELEM_StatsGet(&s);
+    CHECK((s.records == 2U) && (s.dropped == 1U));
+    CHECK(s.bytes == 1U + (TELEM_RECORD_MIN + 4U) + (TELEM_RECORD_MIN + 3U));
+    CHECK(ringLen == 17U + s.bytes);
+
+    for (i = 0; i < ringLen; i++) {
+        if (ring[i] != 0U)
+            continue;
+        if (i > start) {
+            if ((good < 4) && TELEM_Decode(&ring[start], i - start, &d[good]))
+                good++;
+            else
+                bad++;
+        }
+        start = i + 1U;
+    }
+    CHECK((good == 2) && (bad == 1));
+    CHECK((d[0].seq == 0U) && (d[1].seq == 2U));     // the gap shows the drop
+    CHECK((d[0].dlc == 2U) && (d[1].dlc == 1U));
+
+    /* Line rate: a 2-byte frame is 22 bytes, 10 bits each */
+    printf("  2-byte frame: %u bytes, %u records/s at 115200, %u at 460800\n",
+           TELEM_RECORD_MIN + 4U, 11520U / (TELEM_RECORD_MIN + 4U),
+           46080U / (TELEM_RECORD_MIN + 4U));
+    CHECK(46080U / (TELEM_RECORD_MIN + 4U) >= 2000U);
+}
+
+int main(void)
+{
+    printf("Telemetry host tests\n");
+    TestCodecs();
+    TestRecords();
+    TestStream();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/*
+ * File:   test_terminal.c
+ * Comments: Host tests for CAN/src/TERMINAL.c. The output runs through a small
+ *           VT100 interpreter (the sequences TERMINAL.c emits) into a character
+ *           grid, so every test checks what the screen shows as well as how
+ *           many bytes it took to get there.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TERMINAL.h"
+
+static int          failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+#define ROWS    40
+#define COLS    80
+
+static char         screen[ROWS][COLS];
+static int          curRow, curCol;         // 0-based
+static char         esc[16];
+static int          escLen = -1;            // -1: not in a sequence
+static size_t       wire;
+
+static void ScreenErase(int row, int col)
+{
+    for (; row < ROWS; row++, col = 0)
+        memset(&screen[row][col], ' ', (size_t)(COLS - col));
+}
+
+static void EscapeRun(char final)
+{
+    int     a = 0, b = 0;
+
+    esc[escLen] = '\0';
+    if (final == 'H') {
+        if (sscanf(esc, "%d;%d", &a, &b) != 2)
+            a = b = 1;
+        curRow = a - 1;
+        curCol = b - 1;
+    } else if (final == 'G') {
+        curCol = atoi(esc) - 1;
+    } else if ((final == 'J') && (strcmp(esc, "2") == 0)) {
+        ScreenErase(0, 0);
+    } else if (final == 'J') {
+        ScreenErase(curRow, curCol);
+    }
+    /* ?25l: cursor off, nothing to show */
+}
+
+static size_t TermOut(const void* buffer, size_t size)
+{
+    const char* p = buffer;
+    size_t      i;
+
+    wire += size;
+    for (i = 0; i < size; i++) {
+        char c = p[i];
+
+        if (escLen >= 0) {
+            if ((escLen == 0) && (c == '['))
+                continue;
+            if (((c >= '0') && (c <= '9')) || (c == ';') || (c == '?')) {
+                if (escLen < (int)sizeof(esc) - 1)
+                    esc[escLen++] = c;
+            } else {
+                EscapeRun(c);
+                escLen = -1;
+            }
+        } else if (c == '\033') {
+            escLen = 0;
+        } else if (c == '\r') {
+            curCol = 0;
+        } else if (c == '\n') {
+            curRow++;
+        } else if ((curRow < ROWS) && (curCol < COLS)) {
+            screen[curRow][curCol++] = c;
+        }
+    }
+    return size;
+}
+
+/* The screen text at row/col (1-based), len characters */
+static bool Shows(int row, int col, const char* text)
+{
+    return memcmp(&screen[row - 1][col - 1], text, strlen(text)) == 0;
+}
+
+TERM_FIELD_DEFINE(rpmField, 5, 19, 6);
+TERM_FIELD_DEFINE(brakeField, 8, 19, 8);
+TERM_FIELD_DEFINE(idField, 12, 5, 5);
+TERM_FIELD_DEFINE(dataField, 12, 12, 10);
+
+static void Reset(void)
+{
+    memset(screen, '#', sizeof(screen));
+    curRow = curCol = 0;
+    escLen = -1;
+    wire = 0;
+    TERM_Init(TermOut);
+}
+
+static void TestLayout(void)
+{
+    printf("layout and fields\n");
+    Reset();
+
+    TERM_Clear();
+    CHECK(Shows(1, 1, "        "));
+    TERM_Text(5, 3, "Engine RPM:");
+    TERM_FieldInt(&rpmField, 850);
+    TERM_FieldText(&brakeField, "Released");
+    CHECK(Shows(5, 3, "Engine RPM:     850   "));
+    CHECK(Shows(8, 19, "Released"));
+
+    /* Same values: nothing on the wire */
+    wire = 0;
+    TERM_FieldInt(&rpmField, 850);
+    TERM_FieldText(&brakeField, "Released");
+    CHECK(wire == 0U);
+
+    /* One digit: cursor move and one character */
+    TERM_FieldInt(&rpmField, 870);
+    CHECK(Shows(5, 19, "870   "));
+    CHECK(wire == strlen("\033[5;20H") + 1U);
+
+    /* Shorter text is padded over the old one */
+    TERM_FieldText(&brakeField, "ENGAGED");
+    CHECK(Shows(8, 19, "ENGAGED "));
+    TERM_FieldInt(&rpmField, 1000);
+    TERM_FieldInt(&rpmField, 95);
+    CHECK(Shows(5, 19, "95    "));
+
+    /* Negative values, truncation at the width */
+    TERM_FieldInt(&rpmField, -42);
+    CHECK(Shows(5, 19, "-42   "));
+    screen[7][26] = '#';
+    TERM_FieldText(&brakeField, "RELEASED-TOO-LONG");
+    CHECK(Shows(8, 19, "RELEASED#"));
+}
+
+static void TestCursor(void)
+{
+    printf("cursor moves\n");
+    Reset();
+    TERM_Clear();
+
+    /* Adjacent fields on one row: the second needs no cursor move */
+    TERM_FieldHex(&idField, 0x0C0, 3);
+    wire = 0;
+    TERM_Text(12, 10, "  ");
+    CHECK(wire == 2U);
+    TERM_FieldText(&dataField, "0x03 0x52");
+    CHECK(wire == 2U + 10U);
+    CHECK(Shows(12, 5, "0x0C0  0x03 0x52 "));
+
+    /* Same row, other column: ESC [ col G */
+    wire = 0;
+    TERM_FieldHex(&idField, 0x0D0, 3);
+    CHECK(wire == strlen("\033[8G") + 1U);
+    CHECK(Shows(12, 5, "0x0D0"));
+
+    /* TERM_Clear() redraws every field in full on its next set */
+    TERM_Clear();
+    CHECK(Shows(12, 5, "     "));
+    wire = 0;
+    TERM_FieldHex(&idField, 0x0D0, 3);
+    CHECK(Shows(12, 5, "0x0D0"));
+    CHECK(wire == strlen("\033[12;5H") + 5U);
+
+    /* Erase below the fields, the cursor is left there for plain output */
+    TERM_Text(20, 1, "stats");
+    TERM_ClearFrom(13);
+    CHECK(Shows(20, 1, "     "));
+    CHECK((curRow == 12) && (curCol == 0));
+    TermOut("\r\nmore stats", 12);
+    wire = 0;
+    TERM_FieldHex(&idField, 0x0F0, 3);           // unknown cursor: full move
+    CHECK(Shows(12, 5, "0x0F0"));
+    CHECK(Shows(14, 1, "more stats"));
+    CHECK(wire == strlen("\033[12;8H") + 1U);
+}
+
+/* A status screen like main.c's: a typical frame changes RPM, speed, throttle,
+   one CAN row and one formula line */
+static void TestFrameBudget(void)
+{
+    TERM_FIELD_DEFINE(rpm, 14, 19, 6);
+    TERM_FIELD_DEFINE(speed, 15, 19, 3);
+    TERM_FIELD_DEFINE(throttle, 16, 19, 3);
+    TERM_FIELD_DEFINE(mark0, 26, 3, 1);
+    TERM_FIELD_DEFINE(mark1, 27, 3, 1);
+    TERM_FIELD_DEFINE(data0, 26, 34, 10);
+    TERM_FIELD_DEFINE(crc0, 26, 47, 6);
+    TERM_FIELD_DEFINE(calc0, 30, 46, 24);
+    uint32_t    bytes;
+
+    printf("frame budget\n");
+    Reset();
+    TERM_Clear();
+    TERM_FieldInt(&rpm, 2150);
+    TERM_FieldInt(&speed, 72);
+    TERM_FieldInt(&throttle, 41);
+    TERM_FieldText(&mark0, " ");
+    TERM_FieldText(&mark1, "*");
+    TERM_FieldText(&data0, "0x08 0x66");
+    TERM_FieldHex(&crc0, 0x1A2B, 4);
+    TERM_FieldText(&calc0, "(8 x 256) + 102 = 2150");
+
+    bytes = TERM_BytesGet();
+    TERM_FieldInt(&rpm, 2200);
+    TERM_FieldInt(&speed, 74);
+    TERM_FieldInt(&throttle, 44);
+    TERM_FieldText(&mark0, "*");
+    TERM_FieldText(&mark1, " ");
+    TERM_FieldText(&data0, "0x08 0x98");
+    TERM_FieldHex(&crc0, 0x2C41, 4);
+    TERM_FieldText(&calc0, "(8 x 256) + 152 = 2200");
+    bytes = TERM_BytesGet() - bytes;
+    printf("  typical frame: %u bytes\n", bytes);
+    CHECK(bytes < 100U);
+    CHECK(Shows(26, 3, "*"));
+    CHECK(Shows(27, 3, " "));
+    CHECK(Shows(30, 46, "(8 x 256) + 152 = 2200"));
+}
+
+int main(void)
+{
+    printf("Terminal host tests\n");
+    TestLayout();
+    TestCursor();
+    TestFrameBudget();
+
+    printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+    return (failures == 0) ? 0 : 1;
+}
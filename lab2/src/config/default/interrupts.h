@@ -60,6 +60,7 @@ void Reset_Handler (void);
 void NonMaskableInt_Handler (void);
 void HardFault_Handler (void);
 void SysTick_Handler (void);
+void SERCOM0_USART_InterruptHandler (void);
 
 
 
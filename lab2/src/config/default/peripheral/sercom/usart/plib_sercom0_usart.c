@@ -47,8 +47,10 @@
 // Section: Included Files
 // *****************************************************************************
 // *****************************************************************************
+#include <string.h>
 #include "interrupts.h"
 #include "plib_sercom0_usart.h"
+#include "peripheral/nvic/plib_nvic.h"
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Data
@@ -57,6 +59,22 @@
 /* SERCOM0 USART baud value for 115200 Hz baud rate */
 #define SERCOM0_USART_INT_BAUD_VALUE            (63019UL)
 
+#define SERCOM0_USART_INT_BAUD_RATE             (115200UL)
+
+#define SERCOM0_USART_RX_ERROR_MASK             (SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk)
+
+static volatile SERCOM_USART_RING_BUFFER_OBJECT sercom0USARTObj;
+
+static volatile SERCOM_USART_RING_BUFFER_STATISTICS sercom0USARTStats;
+
+static volatile bool sercom0USARTWriteBlocking;
+
+/* The rate asked for, the BAUD register holds the nearest the clock gives */
+static uint32_t sercom0USARTBaudRate;
+
+/* One slot of each ring stays free to tell a full ring from an empty one */
+static uint8_t SERCOM0_USART_WriteBuffer[SERCOM0_USART_WRITE_BUFFER_SIZE];
+static uint8_t SERCOM0_USART_ReadBuffer[SERCOM0_USART_READ_BUFFER_SIZE];
 
 
 // *****************************************************************************
@@ -65,25 +83,9 @@
 // *****************************************************************************
 // *****************************************************************************
 
-static void SERCOM0_USART_ErrorClear( void )
+static size_t SERCOM0_USART_RingCount( uint32_t inIndex, uint32_t outIndex, uint32_t bufferSize )
 {
-    uint8_t  u8dummyData = 0U;
-    USART_ERROR errorStatus = (USART_ERROR) (SERCOM0_REGS->USART_INT.SERCOM_STATUS & (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk ));
-
-    if(errorStatus != USART_ERROR_NONE)
-    {
-        /* Clear all errors */
-        SERCOM0_REGS->USART_INT.SERCOM_STATUS = (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk);
-
-        /* Flush existing error bytes from the RX FIFO */
-        while((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & (uint8_t)SERCOM_USART_INT_INTFLAG_RXC_Msk) == (uint8_t)SERCOM_USART_INT_INTFLAG_RXC_Msk)
-        {
-            u8dummyData = (uint8_t)SERCOM0_REGS->USART_INT.SERCOM_DATA;
-        }
-    }
-
-    /* Ignore the warning */
-    (void)u8dummyData;
+    return (inIndex >= outIndex) ? (size_t)(inIndex - outIndex) : (size_t)(bufferSize - outIndex + inIndex);
 }
 
 void SERCOM0_USART_Initialize( void )
@@ -117,6 +119,21 @@ void SERCOM0_USART_Initialize( void )
         /* Do nothing */
     }
 
+    /* Initialize instance object */
+    sercom0USARTObj.wrCallback = NULL;
+    sercom0USARTObj.wrInIndex = 0U;
+    sercom0USARTObj.wrOutIndex = 0U;
+    sercom0USARTObj.wrBufferSize = SERCOM0_USART_WRITE_BUFFER_SIZE;
+    sercom0USARTObj.isWrNotificationEnabled = false;
+    sercom0USARTObj.rdCallback = NULL;
+    sercom0USARTObj.rdInIndex = 0U;
+    sercom0USARTObj.rdOutIndex = 0U;
+    sercom0USARTObj.rdBufferSize = SERCOM0_USART_READ_BUFFER_SIZE;
+    sercom0USARTObj.isRdNotificationEnabled = false;
+    sercom0USARTObj.rdThreshold = 1U;
+    sercom0USARTObj.errorStatus = USART_ERROR_NONE;
+    sercom0USARTWriteBlocking = false;
+    sercom0USARTBaudRate = SERCOM0_USART_INT_BAUD_RATE;
 
     /* Enable the UART after the configurations */
     SERCOM0_REGS->USART_INT.SERCOM_CTRLA |= SERCOM_USART_INT_CTRLA_ENABLE_Msk;
@@ -126,33 +143,69 @@ void SERCOM0_USART_Initialize( void )
     {
         /* Do nothing */
     }
+
+    /* Receive in the background; DRE is enabled by Write() while the write ring has data */
+    SERCOM0_REGS->USART_INT.SERCOM_INTENSET = (uint8_t)SERCOM_USART_INT_INTENSET_RXC_Msk;
+}
+
+uint32_t SERCOM0_USART_FrequencyGet( void )
+{
+    return 48000000UL;
+}
+
+static void SERCOM0_USART_BaudError( USART_BAUD_SETTING * setting, uint32_t baudRate, uint32_t clkFrequency )
+{
+    /* 2^20 times the rate the BAUD value gives, against 2^20 times the one asked for */
+    uint64_t actual = (uint64_t)clkFrequency * (65536U - (uint32_t)setting->baudValue);
+    int64_t difference = (int64_t)actual - ((int64_t)baudRate << 20);
+
+    setting->baudRate = (uint32_t)((actual + (1UL << 19)) >> 20);
+    setting->errorPpm = (int32_t)((difference * 1000000) / ((int64_t)baudRate << 20));
 }
 
+bool SERCOM0_USART_BaudCalculate( uint32_t baudRate, uint32_t clkFrequency, USART_BAUD_SETTING * setting )
+{
+    bool status = false;
+    uint32_t steps;
 
+    if(clkFrequency == 0U)
+    {
+        clkFrequency = SERCOM0_USART_FrequencyGet();
+    }
 
+    if((setting != NULL) && (baudRate != 0U))
+    {
+        /* 65536 - BAUD, rounded: the rate is linear in BAUD, the nearest step has the lowest error */
+        steps = (uint32_t)((((uint64_t)baudRate << 20) + (clkFrequency / 2U)) / clkFrequency);
 
+        if((steps != 0U) && (steps <= 65536U))
+        {
+            setting->baudValue = (uint16_t)(65536U - steps);
+            SERCOM0_USART_BaudError(setting, baudRate, clkFrequency);
+            status = true;
+        }
+    }
 
-uint32_t SERCOM0_USART_FrequencyGet( void )
+    return status;
+}
+
+void SERCOM0_USART_BaudSettingGet( USART_BAUD_SETTING * setting )
 {
-    return 48000000UL;
+    setting->baudValue = SERCOM0_REGS->USART_INT.SERCOM_BAUD;
+    SERCOM0_USART_BaudError(setting, sercom0USARTBaudRate, SERCOM0_USART_FrequencyGet());
 }
 
 bool SERCOM0_USART_SerialSetup( USART_SERIAL_SETUP * serialSetup, uint32_t clkFrequency )
 {
     bool setupStatus       = false;
-    uint32_t baudValue     = 0U;
+    USART_BAUD_SETTING baudSetting;
 
-    if((serialSetup != NULL) && (serialSetup->baudRate != 0U))
+    /* The rings hold 8-bit characters, 9-bit frames are not supported. A rate the
+       clock cannot make within USART_BAUD_ERROR_MAX_PPM leaves the USART as it is. */
+    if((serialSetup != NULL) && (serialSetup->dataWidth != USART_DATA_9_BIT) &&
+       SERCOM0_USART_BaudCalculate(serialSetup->baudRate, clkFrequency, &baudSetting) &&
+       (baudSetting.errorPpm <= USART_BAUD_ERROR_MAX_PPM) && (baudSetting.errorPpm >= -USART_BAUD_ERROR_MAX_PPM))
     {
-        if(clkFrequency == 0U)
-        {
-            clkFrequency = SERCOM0_USART_FrequencyGet();
-        }
-
-        if(clkFrequency >= (16U * serialSetup->baudRate))
-        {
-            baudValue = 65536U - (uint32_t)(((uint64_t)65536U * 16U * serialSetup->baudRate) / clkFrequency);
-        }
         /* Disable the USART before configurations */
         SERCOM0_REGS->USART_INT.SERCOM_CTRLA &= ~SERCOM_USART_INT_CTRLA_ENABLE_Msk;
 
@@ -163,19 +216,20 @@ bool SERCOM0_USART_SerialSetup( USART_SERIAL_SETUP * serialSetup, uint32_t clkFr
         }
 
         /* Configure Baud Rate */
-		SERCOM0_REGS->USART_INT.SERCOM_BAUD = (uint16_t)SERCOM_USART_INT_BAUD_BAUD(baudValue);
+		SERCOM0_REGS->USART_INT.SERCOM_BAUD = (uint16_t)SERCOM_USART_INT_BAUD_BAUD(baudSetting.baudValue);
+        sercom0USARTBaudRate = serialSetup->baudRate;
 
         /* Configure Parity Options */
         if(serialSetup->parity == USART_PARITY_NONE)
         {
-            SERCOM0_REGS->USART_INT.SERCOM_CTRLA = 
+            SERCOM0_REGS->USART_INT.SERCOM_CTRLA =
             (SERCOM0_REGS->USART_INT.SERCOM_CTRLA & ~SERCOM_USART_INT_CTRLA_FORM_Msk) | SERCOM_USART_INT_CTRLA_FORM(0x0);
 
             SERCOM0_REGS->USART_INT.SERCOM_CTRLB = (SERCOM0_REGS->USART_INT.SERCOM_CTRLB & ~(SERCOM_USART_INT_CTRLB_CHSIZE_Msk | SERCOM_USART_INT_CTRLB_SBMODE_Msk)) | ((uint32_t) serialSetup->dataWidth | (uint32_t) serialSetup->stopBits);
         }
         else
         {
-            SERCOM0_REGS->USART_INT.SERCOM_CTRLA = 
+            SERCOM0_REGS->USART_INT.SERCOM_CTRLA =
             (SERCOM0_REGS->USART_INT.SERCOM_CTRLA & ~SERCOM_USART_INT_CTRLA_FORM_Msk) | SERCOM_USART_INT_CTRLA_FORM(0x1UL);
 
             SERCOM0_REGS->USART_INT.SERCOM_CTRLB = (SERCOM0_REGS->USART_INT.SERCOM_CTRLB & ~(SERCOM_USART_INT_CTRLB_CHSIZE_Msk | SERCOM_USART_INT_CTRLB_SBMODE_Msk | SERCOM_USART_INT_CTRLB_PMODE_Msk)) | (uint32_t) serialSetup->dataWidth | (uint32_t) serialSetup->stopBits | (uint32_t) serialSetup->parity ;
@@ -204,12 +258,13 @@ bool SERCOM0_USART_SerialSetup( USART_SERIAL_SETUP * serialSetup, uint32_t clkFr
 
 USART_ERROR SERCOM0_USART_ErrorGet( void )
 {
-    USART_ERROR errorStatus = (USART_ERROR) (SERCOM0_REGS->USART_INT.SERCOM_STATUS & (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk ));
+    USART_ERROR errorStatus;
 
-    if(errorStatus != USART_ERROR_NONE)
-    {
-        SERCOM0_USART_ErrorClear();
-    }
+    /* The receive interrupt accumulates the errors, read and clear them in one go */
+    SERCOM0_REGS->USART_INT.SERCOM_INTENCLR = (uint8_t)SERCOM_USART_INT_INTENCLR_RXC_Msk;
+    errorStatus = sercom0USARTObj.errorStatus;
+    sercom0USARTObj.errorStatus = USART_ERROR_NONE;
+    SERCOM0_REGS->USART_INT.SERCOM_INTENSET = (uint8_t)SERCOM_USART_INT_INTENSET_RXC_Msk;
 
     return errorStatus;
 }
@@ -265,74 +320,151 @@ void SERCOM0_USART_TransmitterDisable( void )
     }
 }
 
-bool SERCOM0_USART_Write( void *buffer, const size_t size )
+/* Move the oldest byte of the write ring to DATA, or stop the DRE interrupt once
+   the ring has run dry. Only called with DRE set. */
+static void SERCOM0_USART_ISR_TX_Handler( void )
+{
+    uint32_t wrOutIndex = sercom0USARTObj.wrOutIndex;
+
+    if(wrOutIndex != sercom0USARTObj.wrInIndex)
+    {
+        SERCOM0_REGS->USART_INT.SERCOM_DATA = SERCOM0_USART_WriteBuffer[wrOutIndex];
+
+        wrOutIndex++;
+        if(wrOutIndex >= sercom0USARTObj.wrBufferSize)
+        {
+            wrOutIndex = 0U;
+        }
+        sercom0USARTObj.wrOutIndex = wrOutIndex;
+    }
+    else
+    {
+        /* Nothing to transmit. Disable the data register empty interrupt. */
+        SERCOM0_REGS->USART_INT.SERCOM_INTENCLR = (uint8_t)SERCOM_USART_INT_INTENCLR_DRE_Msk;
+    }
+}
+
+/* Blocking write on a full ring: feed the transmitter by hand. This also works
+   with interrupts masked or from a handler the DRE interrupt cannot preempt. */
+static void SERCOM0_USART_WritePoll( void )
 {
-    bool writeStatus      = false;
-    uint8_t *pu8Data      = (uint8_t*)buffer;
-    uint16_t *pu16Data    = (uint16_t*)buffer;
-    uint32_t u32Index     = 0U;
+    bool interruptState = NVIC_INT_Disable();
 
-    if(buffer != NULL)
+    if((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk) == (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk)
     {
-        /* Blocks while buffer is being transferred */
-        while(u32Index < size)
+        SERCOM0_USART_ISR_TX_Handler();
+    }
+
+    NVIC_INT_Restore(interruptState);
+}
+
+size_t SERCOM0_USART_Write( const void *buffer, const size_t size )
+{
+    const uint8_t* pu8Data = (const uint8_t*)buffer;
+    size_t nBytesWritten   = 0U;
+    bool blocked           = false;
+    uint32_t wrInIndex;
+    uint32_t wrOutIndex;
+    size_t nBytes;
+    size_t pending;
+
+    if(buffer == NULL)
+    {
+        return 0U;
+    }
+
+    while(nBytesWritten < size)
+    {
+        wrInIndex = sercom0USARTObj.wrInIndex;
+        wrOutIndex = sercom0USARTObj.wrOutIndex;
+
+        /* Contiguous free space from wrInIndex, keeping the slot before wrOutIndex empty */
+        if(wrOutIndex > wrInIndex)
         {
-            /* Check if USART is ready for new data */
-            while((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk) == 0U)
-            {
-                /* Do nothing */
-            }
+            nBytes = (size_t)(wrOutIndex - wrInIndex - 1U);
+        }
+        else
+        {
+            nBytes = (size_t)(sercom0USARTObj.wrBufferSize - wrInIndex - ((wrOutIndex == 0U) ? 1U : 0U));
+        }
 
-            /* Write data to USART module */
-            if (((SERCOM0_REGS->USART_INT.SERCOM_CTRLB & SERCOM_USART_INT_CTRLB_CHSIZE_Msk) >> SERCOM_USART_INT_CTRLB_CHSIZE_Pos) != 0x01U)
+        if(nBytes == 0U)
+        {
+            if(!sercom0USARTWriteBlocking)
             {
-                /* 8-bit mode */
-                SERCOM0_REGS->USART_INT.SERCOM_DATA = pu8Data[u32Index];
+                break;
             }
-            else
+
+            if(!blocked)
             {
-                /* 9-bit mode */
-                SERCOM0_REGS->USART_INT.SERCOM_DATA = pu16Data[u32Index];
+                sercom0USARTStats.txBlocked++;
+                blocked = true;
             }
 
-            /* Increment index */
-            u32Index++;
+            SERCOM0_USART_WritePoll();
+            continue;
         }
-        writeStatus = true;
-    }
 
-    return writeStatus;
-}
+        if(nBytes > (size - nBytesWritten))
+        {
+            nBytes = size - nBytesWritten;
+        }
 
+        (void)memcpy(&SERCOM0_USART_WriteBuffer[wrInIndex], &pu8Data[nBytesWritten], nBytes);
+        nBytesWritten += nBytes;
 
-bool SERCOM0_USART_TransmitterIsReady( void )
-{
-    bool transmitterStatus = false;
+        wrInIndex += (uint32_t)nBytes;
+        if(wrInIndex >= sercom0USARTObj.wrBufferSize)
+        {
+            wrInIndex = 0U;
+        }
 
-    if ((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_DRE_Msk) == SERCOM_USART_INT_INTFLAG_DRE_Msk)
-    {
-        transmitterStatus = true;
+        /* The data must be in the ring before the interrupt can see the new index */
+        __DMB();
+        sercom0USARTObj.wrInIndex = wrInIndex;
+
+        pending = SERCOM0_USART_RingCount(wrInIndex, sercom0USARTObj.wrOutIndex, sercom0USARTObj.wrBufferSize);
+        if(pending > sercom0USARTStats.txHighWater)
+        {
+            sercom0USARTStats.txHighWater = (uint32_t)pending;
+        }
+
+        /* Hand over to the interrupt */
+        SERCOM0_REGS->USART_INT.SERCOM_INTENSET = (uint8_t)SERCOM_USART_INT_INTENSET_DRE_Msk;
     }
 
-    return transmitterStatus;
+    sercom0USARTStats.txBytes += (uint32_t)nBytesWritten;
+    sercom0USARTStats.txDropped += (uint32_t)(size - nBytesWritten);
+
+    return nBytesWritten;
 }
 
-void SERCOM0_USART_WriteByte( int data )
+void SERCOM0_USART_WriteBlockingSet( bool blocking )
 {
-    /* Check if USART is ready for new data */
-    while((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_DRE_Msk) == 0U)
-    {
-        /* Do nothing */
-    }
+    sercom0USARTWriteBlocking = blocking;
+}
 
-    SERCOM0_REGS->USART_INT.SERCOM_DATA = (uint16_t)data;
+size_t SERCOM0_USART_WriteCountGet( void )
+{
+    return SERCOM0_USART_RingCount(sercom0USARTObj.wrInIndex, sercom0USARTObj.wrOutIndex, sercom0USARTObj.wrBufferSize);
+}
+
+size_t SERCOM0_USART_WriteFreeBufferCountGet( void )
+{
+    return (SERCOM0_USART_WriteBufferSizeGet() - SERCOM0_USART_WriteCountGet());
+}
+
+size_t SERCOM0_USART_WriteBufferSizeGet( void )
+{
+    return (size_t)(sercom0USARTObj.wrBufferSize - 1U);
 }
 
 bool SERCOM0_USART_TransmitComplete( void )
 {
     bool transmitComplete = false;
 
-    if ((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_TXC_Msk) == SERCOM_USART_INT_INTFLAG_TXC_Msk)
+    /* Writing DATA clears TXC, so TXC with an empty ring means the last stop bit is out */
+    if ((SERCOM0_USART_WriteCountGet() == 0U) && ((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_TXC_Msk) == SERCOM_USART_INT_INTFLAG_TXC_Msk))
     {
         transmitComplete = true;
     }
@@ -362,77 +494,202 @@ void SERCOM0_USART_ReceiverDisable( void )
     }
 }
 
-bool SERCOM0_USART_Read( void *buffer, const size_t size )
+static void SERCOM0_USART_ISR_RX_Handler( void )
 {
-    bool readStatus         = false;
-    uint8_t* pu8Data        = (uint8_t*)buffer;
-    uint16_t *pu16Data      = (uint16_t*)buffer;
-    uint32_t u32Index       = 0U;
-    USART_ERROR errorStatus = USART_ERROR_NONE;
+    uint16_t errorStatus = SERCOM0_REGS->USART_INT.SERCOM_STATUS & (uint16_t)SERCOM0_USART_RX_ERROR_MASK;
+    uint8_t rdData;
+    uint32_t rdInIndex;
+    size_t pending;
 
-    if(buffer != NULL)
+    /* The error bits belong to the character at the head of the FIFO, clear them before it is popped */
+    if(errorStatus != 0U)
     {
+        SERCOM0_REGS->USART_INT.SERCOM_STATUS = errorStatus;
+    }
 
-        /* Clear error flags and flush out error data that may have been received when no active request was pending */
-        SERCOM0_USART_ErrorClear();
+    rdData = (uint8_t)SERCOM0_REGS->USART_INT.SERCOM_DATA;
 
-        while(u32Index < size)
-        {
-            /* Check if USART has new data */
-            while((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_RXC_Msk) == 0U)
-            {
-                /* Do nothing */
-            }
+    if(errorStatus != 0U)
+    {
+        sercom0USARTObj.errorStatus |= (USART_ERROR)errorStatus;
+        sercom0USARTStats.rxErrors++;
 
-            errorStatus = (USART_ERROR) (SERCOM0_REGS->USART_INT.SERCOM_STATUS & (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk));
+        /* On overflow the lost characters are gone but this one is good */
+        if((errorStatus & (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk)) != 0U)
+        {
+            return;
+        }
+    }
 
-            if(errorStatus != USART_ERROR_NONE)
-            {
-                break;
-            }
+    rdInIndex = sercom0USARTObj.rdInIndex + 1U;
+    if(rdInIndex >= sercom0USARTObj.rdBufferSize)
+    {
+        rdInIndex = 0U;
+    }
 
-            if (((SERCOM0_REGS->USART_INT.SERCOM_CTRLB & SERCOM_USART_INT_CTRLB_CHSIZE_Msk) >> SERCOM_USART_INT_CTRLB_CHSIZE_Pos) != 0x01U)
-            {
-                /* 8-bit mode */
-                pu8Data[u32Index] = (uint8_t)SERCOM0_REGS->USART_INT.SERCOM_DATA;
-            }
-            else
-            {
-                /* 9-bit mode */
-                pu16Data[u32Index] = (uint16_t)SERCOM0_REGS->USART_INT.SERCOM_DATA;
-            }
+    if(rdInIndex == sercom0USARTObj.rdOutIndex)
+    {
+        /* Read ring full, drop the new character */
+        sercom0USARTStats.rxDropped++;
 
-            /* Increment index */
-            u32Index++;
+        if(sercom0USARTObj.rdCallback != NULL)
+        {
+            sercom0USARTObj.rdCallback(SERCOM_USART_EVENT_READ_BUFFER_FULL, sercom0USARTObj.rdContext);
         }
+        return;
+    }
+
+    SERCOM0_USART_ReadBuffer[sercom0USARTObj.rdInIndex] = rdData;
+    sercom0USARTObj.rdInIndex = rdInIndex;
+    sercom0USARTStats.rxBytes++;
 
-        if(size == u32Index)
+    pending = SERCOM0_USART_RingCount(rdInIndex, sercom0USARTObj.rdOutIndex, sercom0USARTObj.rdBufferSize);
+    if(pending > sercom0USARTStats.rxHighWater)
+    {
+        sercom0USARTStats.rxHighWater = (uint32_t)pending;
+    }
+
+    if((sercom0USARTObj.isRdNotificationEnabled == true) && (sercom0USARTObj.rdCallback != NULL))
+    {
+        if((pending == sercom0USARTObj.rdThreshold) ||
+           ((sercom0USARTObj.isRdNotifyPersistently == true) && (pending > sercom0USARTObj.rdThreshold)))
         {
-            readStatus = true;
+            sercom0USARTObj.rdCallback(SERCOM_USART_EVENT_READ_THRESHOLD_REACHED, sercom0USARTObj.rdContext);
         }
     }
-
-    return readStatus;
 }
 
-bool SERCOM0_USART_ReceiverIsReady( void )
+size_t SERCOM0_USART_Read( void *buffer, const size_t size )
 {
-    bool receiverStatus = false;
+    uint8_t* pu8Data     = (uint8_t*)buffer;
+    size_t nBytesRead    = 0U;
+    uint32_t rdInIndex;
+    uint32_t rdOutIndex;
+    size_t nBytes;
 
-    if ((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_RXC_Msk) == SERCOM_USART_INT_INTFLAG_RXC_Msk)
+    if(buffer == NULL)
     {
-        receiverStatus = true;
+        return 0U;
+    }
+
+    while(nBytesRead < size)
+    {
+        rdInIndex = sercom0USARTObj.rdInIndex;
+        rdOutIndex = sercom0USARTObj.rdOutIndex;
+
+        if(rdInIndex == rdOutIndex)
+        {
+            break;
+        }
+
+        /* Contiguous data from rdOutIndex */
+        nBytes = (rdInIndex > rdOutIndex) ? (size_t)(rdInIndex - rdOutIndex) : (size_t)(sercom0USARTObj.rdBufferSize - rdOutIndex);
+        if(nBytes > (size - nBytesRead))
+        {
+            nBytes = size - nBytesRead;
+        }
+
+        (void)memcpy(&pu8Data[nBytesRead], &SERCOM0_USART_ReadBuffer[rdOutIndex], nBytes);
+        nBytesRead += nBytes;
+
+        rdOutIndex += (uint32_t)nBytes;
+        if(rdOutIndex >= sercom0USARTObj.rdBufferSize)
+        {
+            rdOutIndex = 0U;
+        }
+
+        /* Done with the slots before the interrupt may reuse them */
+        __DMB();
+        sercom0USARTObj.rdOutIndex = rdOutIndex;
     }
 
-    return receiverStatus;
+    return nBytesRead;
+}
+
+size_t SERCOM0_USART_ReadCountGet( void )
+{
+    return SERCOM0_USART_RingCount(sercom0USARTObj.rdInIndex, sercom0USARTObj.rdOutIndex, sercom0USARTObj.rdBufferSize);
+}
+
+size_t SERCOM0_USART_ReadFreeBufferCountGet( void )
+{
+    return (SERCOM0_USART_ReadBufferSizeGet() - SERCOM0_USART_ReadCountGet());
+}
+
+size_t SERCOM0_USART_ReadBufferSizeGet( void )
+{
+    return (size_t)(sercom0USARTObj.rdBufferSize - 1U);
+}
+
+void SERCOM0_USART_ReadCallbackRegister( SERCOM_USART_RING_BUFFER_CALLBACK callBack, uintptr_t context )
+{
+    sercom0USARTObj.rdCallback = callBack;
+
+    sercom0USARTObj.rdContext = context;
 }
 
-int SERCOM0_USART_ReadByte( void )
+bool SERCOM0_USART_ReadNotificationEnable( bool isEnabled, bool isPersistent )
 {
-    return (int)SERCOM0_REGS->USART_INT.SERCOM_DATA;
+    bool previousStatus = sercom0USARTObj.isRdNotificationEnabled;
+
+    sercom0USARTObj.isRdNotificationEnabled = isEnabled;
+
+    sercom0USARTObj.isRdNotifyPersistently = isPersistent;
+
+    return previousStatus;
 }
 
+void SERCOM0_USART_ReadThresholdSet( uint32_t nBytesThreshold )
+{
+    if((nBytesThreshold > 0U) && (nBytesThreshold < sercom0USARTObj.rdBufferSize))
+    {
+        sercom0USARTObj.rdThreshold = nBytesThreshold;
+    }
+}
 
+void SERCOM0_USART_StatisticsGet( SERCOM_USART_RING_BUFFER_STATISTICS* stats )
+{
+    if (stats != NULL)
+    {
+        /* Counters are updated from the interrupt, take a consistent copy */
+        NVIC_DisableIRQ(SERCOM0_IRQn);
+        stats->txBytes     = sercom0USARTStats.txBytes;
+        stats->txDropped   = sercom0USARTStats.txDropped;
+        stats->txBlocked   = sercom0USARTStats.txBlocked;
+        stats->txHighWater = sercom0USARTStats.txHighWater;
+        stats->rxBytes     = sercom0USARTStats.rxBytes;
+        stats->rxDropped   = sercom0USARTStats.rxDropped;
+        stats->rxErrors    = sercom0USARTStats.rxErrors;
+        stats->rxHighWater = sercom0USARTStats.rxHighWater;
+        NVIC_EnableIRQ(SERCOM0_IRQn);
+    }
+}
 
+void SERCOM0_USART_StatisticsClear( void )
+{
+    NVIC_DisableIRQ(SERCOM0_IRQn);
+    sercom0USARTStats.txBytes     = 0U;
+    sercom0USARTStats.txDropped   = 0U;
+    sercom0USARTStats.txBlocked   = 0U;
+    sercom0USARTStats.txHighWater = 0U;
+    sercom0USARTStats.rxBytes     = 0U;
+    sercom0USARTStats.rxDropped   = 0U;
+    sercom0USARTStats.rxErrors    = 0U;
+    sercom0USARTStats.rxHighWater = 0U;
+    NVIC_EnableIRQ(SERCOM0_IRQn);
+}
+
+void __attribute__((used)) SERCOM0_USART_InterruptHandler( void )
+{
+    uint8_t intFlags = SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & SERCOM0_REGS->USART_INT.SERCOM_INTENSET;
 
+    if((intFlags & (uint8_t)SERCOM_USART_INT_INTFLAG_RXC_Msk) != 0U)
+    {
+        SERCOM0_USART_ISR_RX_Handler();
+    }
 
+    if((intFlags & (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk) != 0U)
+    {
+        SERCOM0_USART_ISR_TX_Handler();
+    }
+}
@@ -67,10 +67,23 @@
 // *****************************************************************************
 // *****************************************************************************
 
+/* Ring buffer mode: the DRE and RXC interrupts move the data, Write() and Read()
+   only copy to and from the rings and never wait unless blocking writes are on */
+#define SERCOM0_USART_WRITE_BUFFER_SIZE     256U
+
+#define SERCOM0_USART_READ_BUFFER_SIZE      32U
+
 void SERCOM0_USART_Initialize( void );
 
 bool SERCOM0_USART_SerialSetup( USART_SERIAL_SETUP * serialSetup, uint32_t clkFrequency );
 
+/* The BAUD value nearest to baudRate for the clock (0 = the SERCOM0 GCLK) and
+   its error; false when the rate is out of the generator's range */
+bool SERCOM0_USART_BaudCalculate( uint32_t baudRate, uint32_t clkFrequency, USART_BAUD_SETTING * setting );
+
+/* The setting in use against the rate last asked for */
+void SERCOM0_USART_BaudSettingGet( USART_BAUD_SETTING * setting );
+
 void SERCOM0_USART_Enable( void );
 
 void SERCOM0_USART_Disable( void );
@@ -79,30 +92,47 @@ void SERCOM0_USART_TransmitterEnable( void );
 
 void SERCOM0_USART_TransmitterDisable( void );
 
-bool SERCOM0_USART_Write( void *buffer, const size_t size );
+size_t SERCOM0_USART_Write( const void *buffer, const size_t size );
 
-bool SERCOM0_USART_TransmitComplete( void );
+void SERCOM0_USART_WriteBlockingSet( bool blocking );
+
+size_t SERCOM0_USART_WriteCountGet( void );
 
+size_t SERCOM0_USART_WriteFreeBufferCountGet( void );
 
-bool SERCOM0_USART_TransmitterIsReady( void );
+size_t SERCOM0_USART_WriteBufferSizeGet( void );
 
-void SERCOM0_USART_WriteByte( int data );
+bool SERCOM0_USART_TransmitComplete( void );
 
 
 void SERCOM0_USART_ReceiverEnable( void );
 
 void SERCOM0_USART_ReceiverDisable( void );
 
-bool SERCOM0_USART_Read( void *buffer, const size_t size );
+size_t SERCOM0_USART_Read( void *buffer, const size_t size );
 
-bool SERCOM0_USART_ReceiverIsReady( void );
+size_t SERCOM0_USART_ReadCountGet( void );
 
-int SERCOM0_USART_ReadByte( void );
+size_t SERCOM0_USART_ReadFreeBufferCountGet( void );
+
+size_t SERCOM0_USART_ReadBufferSizeGet( void );
+
+/* The callback runs in the RX interrupt once the ring holds the threshold number
+   of bytes (persistent: on every byte from there on) and may Read() them there */
+void SERCOM0_USART_ReadCallbackRegister( SERCOM_USART_RING_BUFFER_CALLBACK callBack, uintptr_t context );
+
+bool SERCOM0_USART_ReadNotificationEnable( bool isEnabled, bool isPersistent );
+
+void SERCOM0_USART_ReadThresholdSet( uint32_t nBytesThreshold );
 
 USART_ERROR SERCOM0_USART_ErrorGet( void );
 
 uint32_t SERCOM0_USART_FrequencyGet( void );
 
+void SERCOM0_USART_StatisticsGet( SERCOM_USART_RING_BUFFER_STATISTICS* stats );
+
+void SERCOM0_USART_StatisticsClear( void );
+
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
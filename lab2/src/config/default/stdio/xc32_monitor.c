@@ -43,31 +43,57 @@
 extern int read(int handle, void *buffer, unsigned int len);
 extern int write(int handle, void * buffer, size_t count);
 
+static char stdoutBuffer[STDIO_STDOUT_BUFFER_SIZE];
+
 
 int read(int handle, void *buffer, unsigned int len)
 {
     int nChars = 0;
-    bool success = false;
     if ((handle == 0)  && (len > 0U))
     {
+        /* Wait for the first character, then take what else is in the read ring */
         do
         {
-            success = SERCOM0_USART_Read(buffer, 1);
-        }while( !success);
-        nChars = 1;
+            nChars = (int)SERCOM0_USART_Read(buffer, len);
+        }while( nChars == 0);
     }
     return nChars;
 }
 
 int write(int handle, void * buffer, size_t count)
 {
-   bool success = false;
+   /* Copy into the transmit ring and return, the DRE interrupt sends it. A full ring
+      only waits with SERCOM0_USART_WriteBlockingSet(true), otherwise the rest is dropped. */
    if (handle == 1)
    {
-       do
-       {
-           success = SERCOM0_USART_Write(buffer, count);
-       }while( !success);
+       (void)SERCOM0_USART_Write(buffer, count);
    }
    return (int)count;
-}
\ No newline at end of file
+}
+
+void STDIO_StdoutModeSet( STDIO_MODE mode )
+{
+    (void)fflush(stdout);
+
+    if (mode == STDIO_MODE_UNBUFFERED)
+    {
+        (void)setvbuf(stdout, NULL, _IONBF, 0);
+    }
+    else
+    {
+        (void)setvbuf(stdout, stdoutBuffer, (mode == STDIO_MODE_LINE) ? _IOLBF : _IOFBF, sizeof(stdoutBuffer));
+    }
+}
+
+void STDIO_Flush( bool wait )
+{
+    (void)fflush(stdout);
+
+    if (wait)
+    {
+        while (SERCOM0_USART_WriteCountGet() != 0U)
+        {
+            /* Do nothing */
+        }
+    }
+}
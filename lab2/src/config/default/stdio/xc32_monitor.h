@@ -0,0 +1,90 @@
+/*******************************************************************************
+ Debug Console Header file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    xc32_monitor.h
+
+  Summary:
+    debug console Header File
+
+  Description:
+    stdout buffering mode and flush for the SERCOM0 console. read() and write()
+    of xc32_monitor.c connect stdin and stdout to the SERCOM0 USART rings:
+    write() copies into the transmit ring and returns, the interrupt sends.
+    With the blocking writes of the USART off, what does not fit in the ring
+    is dropped and counted in the USART statistics.
+
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#ifndef XC32_MONITOR_H
+#define XC32_MONITOR_H
+
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+typedef enum
+{
+    /* Every printf() goes to the transmit ring when it returns */
+    STDIO_MODE_UNBUFFERED = 0,
+
+    /* Collected until '\n', STDIO_STDOUT_BUFFER_SIZE bytes or STDIO_Flush() */
+    STDIO_MODE_LINE,
+
+    /* Collected until STDIO_STDOUT_BUFFER_SIZE bytes or STDIO_Flush() */
+    STDIO_MODE_FULL
+
+} STDIO_MODE;
+
+/* stdout buffer in front of the transmit ring */
+#define STDIO_STDOUT_BUFFER_SIZE        64U
+
+/* Mode set by SYS_Initialize() */
+#define STDIO_STDOUT_MODE               STDIO_MODE_LINE
+
+/* Flushes the current buffer and switches the mode */
+void STDIO_StdoutModeSet( STDIO_MODE mode );
+
+/* Moves buffered stdout to the transmit ring; with wait, also waits until the
+   interrupt has emptied the ring (the last character is still being shifted out) */
+void STDIO_Flush( bool wait );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif /* XC32_MONITOR_H */
@@ -0,0 +1,45 @@
+/*
+ * File:   FORMAT.h
+ * Comments: Number formatting into caller buffers, without the heap, stdio or
+ *           a single division. The Cortex-M0+ has no divide instruction: every
+ *           "% 10" / "/ 10" of the usual digit loop is a call into the runtime
+ *           division routine, tens of cycles per digit. Here a digit costs a
+ *           few shifts and adds (divide by 10 as a reciprocal multiply done in
+ *           shift-add form), and none of sprintf's format parsing or the
+ *           newlib printf code is linked in.
+ *
+ *           Every function writes the text and a terminating '\0' at buf and
+ *           returns the length without the '\0', so calls chain:
+ *
+ *             p += FMT_Int(p, rpm);
+ *             p += FMT_Str(p, " rpm");
+ *
+ *           The longest result is FMT_BUFFER_SIZE bytes with the '\0'.
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FMT_BUFFER_SIZE     24U     // widths are capped at FMT_BUFFER_SIZE - 1
+
+// v / 10, the remainder in *rem
+uint32_t FMT_Div10(uint32_t v, uint32_t* rem);
+
+// Decimal: "123", "-45"
+size_t FMT_UInt(char* buf, uint32_t v);
+size_t FMT_Int(char* buf, int32_t v);
+// Right-aligned in width columns, padded with spaces: "  850"
+size_t FMT_IntW(char* buf, int32_t v, uint8_t width);
+// At least digits digits, leading zeros: "007"
+size_t FMT_UIntZ(char* buf, uint32_t v, uint8_t digits);
+// Fixed point, v in units of 10^-decimals: (1234, 2) -> "12.34", (-5, 2) -> "-0.05"
+size_t FMT_Fixed(char* buf, int32_t v, uint8_t decimals);
+// Exactly digits upper-case hex digits (1..8), no prefix: "0C0"
+size_t FMT_Hex(char* buf, uint32_t v, uint8_t digits);
+// Copy of s, for chaining
+size_t FMT_Str(char* buf, const char* s);
+
+#endif /* FORMAT_H */
@@ -129,6 +129,9 @@ static void STDIO_BufferModeSet(void)
 
     /* Make stdin unbuffered */
     setbuf(stdin, NULL);
+
+    /* Buffer stdout in front of the SERCOM0 transmit ring, see xc32_monitor.h */
+    STDIO_StdoutModeSet(STDIO_STDOUT_MODE);
     /* MISRAC 2023 deviation block end */
 }
 
@@ -61,6 +61,12 @@
 
 #define SERCOM2_I2CM_SPEED_HZ           100000
 
+/* SDA hold time below Fast-mode Plus */
+#define SERCOM2_I2CM_SDAHOLD            SERCOM_I2CM_CTRLA_SDAHOLD_450NS
+
+/* Bus rise time assumed by the SCL timing, pull-ups and wiring dependent */
+#define SERCOM2_I2CM_TRISE_NS           100U
+
 /* SERCOM2 I2C baud value */
 #define SERCOM2_I2CM_BAUD_VALUE         (0xE8U)
 
@@ -98,7 +104,7 @@ void SERCOM2_I2C_Initialize(void)
     SERCOM2_REGS->I2CM.SERCOM_BAUD = SERCOM2_I2CM_BAUD_VALUE;
 
     /* Set Operation Mode (Master), SDA Hold time, run in stand by and i2c master enable */
-    SERCOM2_REGS->I2CM.SERCOM_CTRLA = SERCOM_I2CM_CTRLA_MODE_I2C_MASTER | SERCOM_I2CM_CTRLA_SDAHOLD_75NS | SERCOM_I2CM_CTRLA_ENABLE_Msk ;
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA = SERCOM_I2CM_CTRLA_MODE_I2C_MASTER | SERCOM2_I2CM_SDAHOLD | SERCOM_I2CM_CTRLA_ENABLE_Msk ;
 
     /* Wait for synchronization */
     while((SERCOM2_REGS->I2CM.SERCOM_STATUS & (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk) == (uint16_t)SERCOM_I2CM_STATUS_SYNCBUSY_Msk)
@@ -123,12 +129,20 @@ void SERCOM2_I2C_Initialize(void)
     SERCOM2_REGS->I2CM.SERCOM_INTENSET = (uint8_t)SERCOM_I2CM_INTENSET_Msk;
 }
 
+/* SCL timing per bus mode: minimum low/high times (ns) from the I2C specification;
+   the low phase gets the larger share of every period like the spec minima do */
 static bool SERCOM2_I2C_CalculateBaudValue(uint32_t srcClkFreq, uint32_t i2cClkSpeed, uint32_t* baudVal)
 {
-    uint32_t baudValue = 0U;
-    float fSrcClkFreq = (float)srcClkFreq;
-    float fI2cClkSpeed = (float)i2cClkSpeed;
-    float fBaudValue = 0.0f;
+    uint32_t tLowNs;
+    uint32_t tHighNs;
+    uint32_t lowPermille;
+    uint32_t srcClkKHz = srcClkFreq / 1000U;
+    uint32_t riseCycles;
+    uint32_t total;
+    uint32_t baudLow;
+    uint32_t baudHigh;
+    uint32_t minLow;
+    uint32_t minHigh;
 
     /* Reference clock frequency must be atleast two times the baud rate */
     if (srcClkFreq < (2U * i2cClkSpeed))
@@ -136,33 +150,55 @@ static bool SERCOM2_I2C_CalculateBaudValue(uint32_t srcClkFreq, uint32_t i2cClkS
         return false;
     }
 
-    if (i2cClkSpeed <= 400000U)
+    if (i2cClkSpeed <= SERCOM_I2C_SPEED_STANDARD)
     {
-        /* Standard, FM and FM+ baud calculation */
-        fBaudValue = (fSrcClkFreq / fI2cClkSpeed) - ((fSrcClkFreq * (100.0f / 1000000000.0f)) + 10.0f);
-        baudValue = (uint32_t)fBaudValue;
-
-        /* For I2C clock speed upto 400 KHz, the value of BAUD<7:0> determines both SCL_L and SCL_H with SCL_L = SCL_H */
-        if (baudValue > (0xFFU * 2U))
-        {
-            /* Set baud rate to the minimum possible value */
-            baudValue = 0xFFU;
-        }
-        else if (baudValue <= 1U)
-        {
-            /* Baud value cannot be 0. Set baud rate to maximum possible value */
-            baudValue = 1U;
-        }
-        else
-        {
-            baudValue /= 2U;
-        }
+        tLowNs = 4700U;  tHighNs = 4000U;  lowPermille = 540U;
+    }
+    else if (i2cClkSpeed <= SERCOM_I2C_SPEED_FAST)
+    {
+        tLowNs = 1300U;  tHighNs = 600U;   lowPermille = 684U;
+    }
+    else if (i2cClkSpeed <= SERCOM_I2C_SPEED_FAST_PLUS)
+    {
+        tLowNs = 500U;   tHighNs = 260U;   lowPermille = 658U;
     }
     else
     {
+        /* High speed mode is not supported */
         return false;
     }
-    *baudVal = baudValue;
+
+    /* f(SCL) = f(GCLK) / (10 + BAUD + BAUDLOW + f(GCLK) * t(rise)): SCL low lasts
+       BAUDLOW + 5 cycles, high BAUD + 5 cycles plus the rise time */
+    riseCycles = (srcClkKHz * SERCOM2_I2CM_TRISE_NS) / 1000000U;
+    total = (srcClkFreq + i2cClkSpeed - 1U) / i2cClkSpeed;
+    total = (total > (riseCycles + 10U)) ? (total - riseCycles - 10U) : 0U;
+
+    minLow = (srcClkKHz * tLowNs + 999999U) / 1000000U;
+    minLow = (minLow > 5U) ? (minLow - 5U) : 1U;
+    minHigh = (srcClkKHz * tHighNs + 999999U) / 1000000U;
+    minHigh = (minHigh > (riseCycles + 5U)) ? (minHigh - riseCycles - 5U) : 1U;
+
+    baudLow = (total * lowPermille) / 1000U;
+    if (baudLow < minLow)
+    {
+        baudLow = minLow;
+    }
+    baudHigh = (total > baudLow) ? (total - baudLow) : 0U;
+    if (baudHigh < minHigh)
+    {
+        /* Clock too slow for the requested speed: run at the fastest legal one */
+        baudHigh = minHigh;
+    }
+
+    if ((baudLow > 0xFFU) || (baudHigh > 0xFFU))
+    {
+        /* Set baud rate to the minimum possible value */
+        baudLow = 0xFFU;
+        baudHigh = 0xFFU;
+    }
+
+    *baudVal = SERCOM_I2CM_BAUD_BAUD(baudHigh) | SERCOM_I2CM_BAUD_BAUDLOW(baudLow);
     return true;
 }
 
@@ -199,9 +235,13 @@ bool SERCOM2_I2C_TransferSetup(SERCOM_I2C_TRANSFER_SETUP* setup, uint32_t srcClk
     }
 
 
-    /* Baud rate - Master Baud Rate*/
+    /* Baud rate - Master Baud Rate, BAUDLOW sets the low phase separately */
     SERCOM2_REGS->I2CM.SERCOM_BAUD = (uint16_t)baudValue;
 
+    /* Fm+ leaves only 0.5us of SCL low: use the short SDA hold time there */
+    SERCOM2_REGS->I2CM.SERCOM_CTRLA = (SERCOM2_REGS->I2CM.SERCOM_CTRLA & ~SERCOM_I2CM_CTRLA_SDAHOLD_Msk) |
+        ((i2cClkSpeed > SERCOM_I2C_SPEED_FAST) ? SERCOM_I2CM_CTRLA_SDAHOLD_75NS : SERCOM2_I2CM_SDAHOLD);
+
 
     /* Re-enable the I2C module */
     SERCOM2_REGS->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_ENABLE_Msk;
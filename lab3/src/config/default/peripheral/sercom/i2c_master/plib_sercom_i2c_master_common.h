@@ -249,6 +249,13 @@ typedef struct
 
 } SERCOM_I2C_TRANSFER_SETUP;
 
+/* clkSpeed values of the supported bus modes; any speed up to the mode limit works */
+#define SERCOM_I2C_SPEED_STANDARD       100000U
+
+#define SERCOM_I2C_SPEED_FAST           400000U
+
+#define SERCOM_I2C_SPEED_FAST_PLUS      1000000U
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
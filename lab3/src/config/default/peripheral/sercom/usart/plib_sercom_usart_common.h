@@ -220,6 +220,40 @@ typedef struct
 
 } USART_SERIAL_SETUP;
 
+// *****************************************************************************
+/* USART Baud Setting
+
+  Summary:
+    A BAUD register value, the baud rate it gives and its error.
+
+  Description:
+    The SERCOM of this device generates the baud rate in the 16x oversampling
+    arithmetic mode only, f(BAUD) = f(ref) / 16 * (1 - BAUD / 65536); it has
+    no fractional or 8x / 3x sample rate modes (CTRLA has no SAMPR field). The
+    arithmetic mode steps by f(ref) / 2^20, fine enough for the usual rates up
+    to f(ref) / 16: 3 Mbaud on the 48 MHz DFLL, 500 kbaud on the 8 MHz OSC8M.
+
+    baudValue is the BAUD register value, baudRate the rate it really gives
+    and errorPpm its difference to the requested rate in parts per million,
+    negative when slower.
+
+  Remarks:
+    SerialSetup() refuses a rate further off than USART_BAUD_ERROR_MAX_PPM,
+    the share of the receiver's sampling window one side may take.
+*/
+
+#define USART_BAUD_ERROR_MAX_PPM    20000
+
+typedef struct
+{
+    uint16_t baudValue;
+
+    uint32_t baudRate;
+
+    int32_t errorPpm;
+
+} USART_BAUD_SETTING;
+
 // *****************************************************************************
 /* Callback Function Pointer
 
@@ -371,6 +405,44 @@ typedef struct
 
 } SERCOM_USART_RING_BUFFER_OBJECT;
 
+// *****************************************************************************
+/* SERCOM USART Ring Buffer Statistics
+
+  Summary:
+    Traffic counters kept by the ring buffer mode PLib.
+
+  Description:
+    Bytes taken into the transmit ring and received, bytes the rings had no
+    room for (refused by a non-blocking write, dropped by the receive
+    interrupt), writes that waited for room in blocking mode, characters
+    received with a parity / framing / overrun error and the most bytes ever
+    waiting in each ring, which shows how close the buffer sizes are to their
+    limit. The counters wrap; read them with SERCOMx_USART_StatisticsGet().
+
+  Remarks:
+    None.
+*/
+
+typedef struct
+{
+    uint32_t txBytes;
+
+    uint32_t txDropped;
+
+    uint32_t txBlocked;
+
+    uint32_t txHighWater;
+
+    uint32_t rxBytes;
+
+    uint32_t rxDropped;
+
+    uint32_t rxErrors;
+
+    uint32_t rxHighWater;
+
+} SERCOM_USART_RING_BUFFER_STATISTICS;
+
 // *****************************************************************************
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -26,10 +26,15 @@
 #include <stdlib.h>                     // Defines EXIT_FAILURE
 #include "definitions.h"                // SYS function prototypes
 #include "OLED128x64.c"                 /* includes OLED128x64.h + OLED_FONTs.c internally */
+#include "FORMAT.c"                     /* numbers to text without sprintf or division */
 
 volatile bool       bFlag_200ms = 0 ;
 volatile bool       bIsI2C_DONE = true ;
 uint8_t             ASCII_Buffer[24];
+
+/* SERCOM0 runs on the 48 MHz DFLL: up to 3000000 baud, 1000000 and 2000000 are
+   within 20 ppm. A rate the clock cannot make keeps the 115200 of the plib. */
+#define UART_BAUD_RATE      115200UL
 // *****************************************************************************
 // *****************************************************************************
 // Section: Main Entry Point
@@ -50,8 +55,21 @@ void SYSTICK_EventHandler(uintptr_t context)
 
 int main ( void )
 {
+    size_t  len ;
+    USART_SERIAL_SETUP  uart = { UART_BAUD_RATE, USART_PARITY_NONE, USART_DATA_8_BIT, USART_STOP_1_BIT } ;
+    USART_BAUD_SETTING  baud ;
+
     /* Initialize all modules */
     SYS_Initialize ( NULL );
+    SERCOM0_USART_SerialSetup(&uart, 0) ;
+    SERCOM0_USART_BaudSettingGet(&baud) ;
+    len = FMT_UInt((char*)ASCII_Buffer, baud.baudRate) ;
+    SERCOM0_USART_Write("UART ", 5) ;
+    SERCOM0_USART_Write(ASCII_Buffer, len) ;
+    len = FMT_Int((char*)ASCII_Buffer, baud.errorPpm) ;
+    SERCOM0_USART_Write(" baud, error ", 13) ;
+    SERCOM0_USART_Write(ASCII_Buffer, len) ;
+    SERCOM0_USART_Write(" ppm\n\r", 6) ;
     /* Register Callback */
     SYSTICK_TimerCallbackSet(SYSTICK_EventHandler, (uintptr_t) NULL);
     /* Start the Timer */
@@ -78,8 +96,10 @@ int main ( void )
             ADC_ChannelSelect(ADC_POSINPUT_PIN1,ADC_NEGINPUT_GND);
             ADC_ConversionStart();
             while (!ADC_ConversionStatusGet()) ;            
-            printf ("ADC = %4d\n\r", ADC_ConversionResultGet()) ;
-            sprintf((char*)ASCII_Buffer,"%4d",ADC_ConversionResultGet());
+            len = FMT_IntW((char*)ASCII_Buffer, ADC_ConversionResultGet(), 4) ;
+            SERCOM0_USART_Write("ADC = ", 6) ;
+            SERCOM0_USART_Write(ASCII_Buffer, len) ;
+            SERCOM0_USART_Write("\n\r", 2) ;
             OLED_Put8x16Str(40, 4, ASCII_Buffer) ;   
             bFlag_200ms = 0 ;
         }